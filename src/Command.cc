@@ -35,6 +35,7 @@
 #include "commands/nullcommands.h"
 #include "commands/configtest.h"
 #include "commands/shell.h"
+#include "commands/serve.h"
 #include "commands/help.h"
 #include "commands/subcommand.h"
 #include "commands/locale/localescmd.h"
@@ -107,6 +108,7 @@ namespace
 
       makeCmd<HelpCmd> ( ZypperCommand::HELP_e, std::string(), { "help", "?" } ),
       makeCmd<ShellCmd>( ZypperCommand::SHELL_e, std::string(), { "shell", "sh" } ),
+      makeCmd<ServeCmd>( ZypperCommand::SERVE_e, std::string(), { "serve" } ),
 
       makeCmd<ListReposCmd> ( ZypperCommand::LIST_REPOS_e, _("Repository Management:"), {"repos", "lr", "catalogs","ca"} ),
       makeCmd<AddRepoCmd>   ( ZypperCommand::ADD_REPO_e , std::string() , { "addrepo", "ar" }),
@@ -164,6 +166,7 @@ namespace
       makeCmd<NeedsRebootingCmd> ( ZypperCommand::NEEDS_REBOOTING_e , std::string(), { "needs-rebooting" } ),
       makeCmd<PSCommand> ( ZypperCommand::PS_e , std::string(), { "ps" } ),
       makeCmd<PurgeKernelsCmd> ( ZypperCommand::PURGE_KERNELS_e , std::string(), { "purge-kernels" } ),
+      makeCmd<HistoryCmd> ( ZypperCommand::HISTORY_e , std::string(), { "history" } ),
 
       makeCmd<SubCmd> ( ZypperCommand::SUBCOMMAND_e, _("Subcommands:"), { "subcommand" }),
 
@@ -247,10 +250,12 @@ DEF_ZYPPER_COMMAND( PS );
 DEF_ZYPPER_COMMAND( DOWNLOAD );
 DEF_ZYPPER_COMMAND( SOURCE_DOWNLOAD );
 DEF_ZYPPER_COMMAND( PURGE_KERNELS );
+DEF_ZYPPER_COMMAND( HISTORY );
 
 DEF_ZYPPER_COMMAND( HELP );
 DEF_ZYPPER_COMMAND( SHELL );
 DEF_ZYPPER_COMMAND( SHELL_QUIT );
+DEF_ZYPPER_COMMAND( SERVE );
 DEF_ZYPPER_COMMAND( MOO );
 
 DEF_ZYPPER_COMMAND( RUG_PATCH_INFO );
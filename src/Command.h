@@ -76,10 +76,12 @@ struct ZypperCommand
   static const ZypperCommand DOWNLOAD;
   static const ZypperCommand SOURCE_DOWNLOAD;
   static const ZypperCommand PURGE_KERNELS;
+  static const ZypperCommand HISTORY;
 
   static const ZypperCommand HELP;
   static const ZypperCommand SHELL;
   static const ZypperCommand SHELL_QUIT;
+  static const ZypperCommand SERVE;
   static const ZypperCommand MOO;
 
   static const ZypperCommand CONFIGTEST;
@@ -152,10 +154,12 @@ struct ZypperCommand
     DOWNLOAD_e,
     SOURCE_DOWNLOAD_e,
     PURGE_KERNELS_e,
+    HISTORY_e,
 
     HELP_e,
     SHELL_e,
     SHELL_QUIT_e,
+    SERVE_e,
     MOO_e,
 
     CONFIGTEST_e,
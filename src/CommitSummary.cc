@@ -12,6 +12,7 @@
 #include "utils/misc.h"
 #include "Table.h"
 #include "Zypper.h"
+#include "output/OutJSON.h"
 #include "utils/console.h"
 
 CommitSummary::CommitSummary( const zypp::ZYppCommitResult &result, const ViewOptions options ) :
@@ -86,6 +87,39 @@ void CommitSummary::dumpAsXmlTo(std::ostream &out)
   out << "</commit-summary>" << endl;
 }
 
+void CommitSummary::dumpAsJsonTo( std::ostream & out )
+{
+  collectData();
+
+  OutJSON::Record record( "commit-summary" );
+  record.add( "failed-installs", unsigned(_failedInstalls.size()) )
+        .add( "skipped-installs", unsigned(_skippedInstalls.size()) )
+        .add( "failed-removals", unsigned(_failedRemovals.size()) )
+        .add( "skipped-removals", unsigned(_skippedRemovals.size()) );
+  OutJSON::writeRecord( out, record );
+
+  writeJsonResolvableList( out, "failed-install", _failedInstalls );
+  writeJsonResolvableList( out, "skipped-install", _skippedInstalls );
+  writeJsonResolvableList( out, "failed-removal", _failedRemovals );
+  writeJsonResolvableList( out, "skipped-removal", _skippedRemovals );
+}
+
+void CommitSummary::writeJsonResolvableList( std::ostream & out, const char * result_r, const std::vector<zypp::sat::Solvable> & solvables )
+{
+  for ( const auto & solvable : solvables )
+  {
+    OutJSON::Record record( "commit-solvable" );
+    record.add( "result", result_r )
+          .add( "kind", solvable.kind().asString() )
+          .add( "name", solvable.name() )
+          .add( "edition", solvable.edition().asString() )
+          .add( "arch", solvable.arch().asString() )
+          .addIfNotEmpty( "summary", solvable.summary() )
+          .addIfNotEmpty( "description", solvable.description() );
+    OutJSON::writeRecord( out, record );
+  }
+}
+
 void CommitSummary::showBasicErrorMessage( Zypper &zypp )
 {
   zypp.out().error(_("Installation has completed with error.") );
@@ -49,6 +49,8 @@ public:
 
   void dumpTo( std::ostream & out );
   void dumpAsXmlTo( std::ostream & out );
+  /** One \c "commit-summary" record followed by a \c "commit-solvable" record per failed or skipped item. */
+  void dumpAsJsonTo( std::ostream & out );
 
   static void showBasicErrorMessage ( Zypper &zypp );
 
@@ -60,6 +62,7 @@ protected:
   void writeFailedRemovals(std::ostream &out);
   void writeSkippedRemovals(std::ostream &out);
   void writeXmlResolvableList(std::ostream &out, const std::vector<zypp::sat::Solvable> &solvables);
+  void writeJsonResolvableList(std::ostream &out, const char * result_r, const std::vector<zypp::sat::Solvable> &solvables);
 private:
   ViewOptions _viewop = DEFAULT;
   bool _force_no_color = false;
@@ -19,8 +19,11 @@ extern "C"
 
 #include "utils/messages.h"
 #include "utils/Augeas.h"
+#include "utils/ConfigReader.h"
 #include "utils/flags/flagtypes.h"
+#include "utils/Profile.h"
 #include "output/OutNormal.h"
+#include "output/OutJSON.h"
 #include "output/OutXML.h"
 #include "Config.h"
 #include "global-settings.h"
@@ -73,12 +76,19 @@ namespace
   enum class ConfigOption {
     MAIN_SHOW_ALIAS,
     MAIN_REPO_LIST_COLUMNS,
+    MAIN_REFRESH_JOBS,
+    MAIN_DOWNLOAD_JOBS,
+    MAIN_DOWNLOAD_JOBS_PER_REPO,
+    MAIN_SERVICE_REFRESH_TTL,
+    MAIN_CACHE_QUERY_RESULTS,
 
     SOLVER_INSTALL_RECOMMENDS,
     SOLVER_FORCE_RESOLUTION_COMMANDS,
 
     COMMIT_AUTO_AGREE_WITH_LICENSES,
     COMMIT_PS_CHECK_ACCESS_DELETED,
+    COMMIT_PREFETCH_PACKAGES,
+    COMMIT_PREFETCH_MAX_SPEED,
 
     COLOR_USE_COLORS,
     COLOR_RESULT,
@@ -98,6 +108,7 @@ namespace
     COLOR_PKGLISTHIGHLIGHT_ATTRIBUTE,
 
     SEARCH_RUNSEARCHPACKAGES,
+    SEARCH_USE_INDEX,
 
     OBS_BASE_URL,
     OBS_PLATFORM,
@@ -110,11 +121,18 @@ namespace
     static const std::vector<std::pair<std::string,ConfigOption>> _data = {
       { "main/showAlias",			ConfigOption::MAIN_SHOW_ALIAS			},
       { "main/repoListColumns",			ConfigOption::MAIN_REPO_LIST_COLUMNS		},
+      { "main/refreshJobs",			ConfigOption::MAIN_REFRESH_JOBS			},
+      { "main/downloadJobs",			ConfigOption::MAIN_DOWNLOAD_JOBS		},
+      { "main/downloadJobsPerRepo",		ConfigOption::MAIN_DOWNLOAD_JOBS_PER_REPO	},
+      { "main/serviceRefreshTTL",		ConfigOption::MAIN_SERVICE_REFRESH_TTL		},
+      { "main/cacheQueryResults",		ConfigOption::MAIN_CACHE_QUERY_RESULTS		},
       { "solver/installRecommends",		ConfigOption::SOLVER_INSTALL_RECOMMENDS		},
       { "solver/forceResolutionCommands",	ConfigOption::SOLVER_FORCE_RESOLUTION_COMMANDS	},
 
       { "commit/autoAgreeWithLicenses",		ConfigOption::COMMIT_AUTO_AGREE_WITH_LICENSES	},
       { "commit/psCheckAccessDeleted",		ConfigOption::COMMIT_PS_CHECK_ACCESS_DELETED	},
+      { "commit/prefetchPackages",		ConfigOption::COMMIT_PREFETCH_PACKAGES		},
+      { "commit/prefetchMaxSpeed",		ConfigOption::COMMIT_PREFETCH_MAX_SPEED		},
 
       { "color/useColors",			ConfigOption::COLOR_USE_COLORS			},
       //"color/background"			LEGACY
@@ -135,6 +153,7 @@ namespace
       { "color/pkglistHighlightAttribute",	ConfigOption::COLOR_PKGLISTHIGHLIGHT_ATTRIBUTE	},
 
       { "search/runSearchPackages",		ConfigOption::SEARCH_RUNSEARCHPACKAGES		},
+      { "search/useIndex",			ConfigOption::SEARCH_USE_INDEX			},
 
       { "obs/baseUrl",				ConfigOption::OBS_BASE_URL			},
       { "obs/platform",				ConfigOption::OBS_PLATFORM			},
@@ -188,12 +207,20 @@ namespace
 
 Config::Config()
   : repo_list_columns("anr")
+  , refresh_jobs(1)
+  , download_jobs(1)
+  , download_jobsPerRepo(0)
+  , service_refreshTTL(0)
+  , cacheQueryResults(true)
   , solver_installRecommends(!ZConfig::instance().solver_onlyRequires())
   , psCheckAccessDeleted(true)
+  , commit_prefetchPackages(false)
+  , commit_prefetchMaxSpeed(0)
   , color_useColors	("autodetect")
   , color_pkglistHighlight(true)
   , color_pkglistHighlightAttribute(ansi::Color::nocolor())
   , search_runSearchPackages(indeterminate)		// ask
+  , search_useIndex(false)
   , obs_baseUrl("https://download.opensuse.org/repositories/")
   , obs_platform("")	// guess
   , verbosity( Out::NORMAL )
@@ -357,6 +384,17 @@ std::vector<ZyppFlags::CommandGroup> Config::cliOptions()
               _("Switch to XML output.")
           ).setPriority( Priority::OUTPUT )
         ),
+        std::move( ZyppFlags::CommandOption(
+          "jsonout", '\0', ZyppFlags::NoArgument, ZyppFlags::CallbackVal( [ this ]( const ZyppFlags::CommandOption &, const boost::optional<std::string> & ) {
+                do_colors = false;	// no color in json mode!
+                Zypper::instance().setOutputWriter( new OutJSON( verbosity ) );
+                machine_readable = true;
+                no_abbrev = true;
+              }),
+              // translators: --jsonout
+              _("Switch to JSON output, one object per line.")
+          ).setPriority( Priority::OUTPUT )
+        ),
         { "ignore-unknown", 'i', ZyppFlags::NoArgument, ZyppFlags::BoolType( &ignore_unknown, ZyppFlags::StoreTrue, ignore_unknown ),
               // translators: --ignore-unknown, -i
               _("Ignore unknown packages.")
@@ -372,6 +410,13 @@ std::vector<ZyppFlags::CommandGroup> Config::cliOptions()
             // translators: --terse, -t
             _("Terse output for machine consumption. Implies --no-abbrev and --no-color.")
         },
+        { "profile", 0, ZyppFlags::NoArgument,
+            ZyppFlags::CallbackVal( []( const ZyppFlags::CommandOption &, const boost::optional<std::string> & ) {
+              Profile::enable();
+            }),
+            // translators: --profile
+            _("Print the time and memory used by the phases of the command (target init, refresh, solve, commit, ...) when done.")
+        },
         // -------------------- deprecated and hidden switches------------------------------------------
 
         // rug compatibility alias for the default output level => ignored
@@ -386,7 +431,9 @@ std::vector<ZyppFlags::CommandGroup> Config::cliOptions()
         //conflicting flags
         { "quiet", "verbose", "debug" },
         { "color", "no-color" },
-        { "color", "xmlout" } //color will always be disabled for XML
+        { "color", "xmlout" }, //color will always be disabled for XML
+        { "color", "jsonout" },
+        { "xmlout", "jsonout" }
       }
     } , {
       //start a new section of commands
@@ -565,32 +612,77 @@ void Config::read( const std::string & file )
     debug::Measure m("ReadConfig");
     std::string s;
 
-    Augeas augeas( file );
+    // Augeas is needed just for saving changes
+    ConfigReader cfg( file );
 
     m.elapsed();
 
     // ---------------[ main ]--------------------------------------------------
 
-    s = augeas.getOption(asString( ConfigOption::MAIN_SHOW_ALIAS ));
+    s = cfg.getOption(asString( ConfigOption::MAIN_SHOW_ALIAS ));
     if (!s.empty())
     {
       // using Repository::asUserString() will follow repoLabelIsAlias!
       ZConfig::instance().repoLabelIsAlias( str::strToBool(s, false) );
     }
 
-    s = augeas.getOption(asString( ConfigOption::MAIN_REPO_LIST_COLUMNS ));
+    s = cfg.getOption(asString( ConfigOption::MAIN_REPO_LIST_COLUMNS ));
     if (!s.empty()) // TODO add some validation
       repo_list_columns = s;
 
+    s = cfg.getOption(asString( ConfigOption::MAIN_REFRESH_JOBS ));
+    if (!s.empty())
+    {
+      unsigned jobs = 0;
+      if ( str::strtonum( s, jobs ) && jobs )
+        refresh_jobs = jobs;
+      else
+        WAR << "zypper.conf: main/refreshJobs: invalid value '" << s << "'" << endl;
+    }
+
+    s = cfg.getOption(asString( ConfigOption::MAIN_DOWNLOAD_JOBS ));
+    if (!s.empty())
+    {
+      unsigned jobs = 0;
+      if ( str::strtonum( s, jobs ) && jobs )
+        download_jobs = jobs;
+      else
+        WAR << "zypper.conf: main/downloadJobs: invalid value '" << s << "'" << endl;
+    }
+
+    s = cfg.getOption(asString( ConfigOption::MAIN_DOWNLOAD_JOBS_PER_REPO ));
+    if (!s.empty())
+    {
+      unsigned jobs = 0;
+      if ( str::strtonum( s, jobs ) )
+        download_jobsPerRepo = jobs;
+      else
+        WAR << "zypper.conf: main/downloadJobsPerRepo: invalid value '" << s << "'" << endl;
+    }
+
+    s = cfg.getOption(asString( ConfigOption::MAIN_SERVICE_REFRESH_TTL ));
+    if (!s.empty())
+    {
+      unsigned minutes = 0;
+      if ( str::strtonum( s, minutes ) )
+        service_refreshTTL = minutes;
+      else
+        WAR << "zypper.conf: main/serviceRefreshTTL: invalid value '" << s << "'" << endl;
+    }
+
+    s = cfg.getOption(asString( ConfigOption::MAIN_CACHE_QUERY_RESULTS ));
+    if (!s.empty())
+      cacheQueryResults = str::strToBool( s, cacheQueryResults );
+
     // ---------------[ solver ]------------------------------------------------
 
-    s = augeas.getOption(asString( ConfigOption::SOLVER_INSTALL_RECOMMENDS ));
+    s = cfg.getOption(asString( ConfigOption::SOLVER_INSTALL_RECOMMENDS ));
     if (s.empty())
       solver_installRecommends = !ZConfig::instance().solver_onlyRequires();
     else
       solver_installRecommends = str::strToBool(s, true);
 
-    s = augeas.getOption(asString( ConfigOption::SOLVER_FORCE_RESOLUTION_COMMANDS ));
+    s = cfg.getOption(asString( ConfigOption::SOLVER_FORCE_RESOLUTION_COMMANDS ));
     if (s.empty())
       solver_forceResolutionCommands.insert(ZypperCommand::REMOVE);
     else
@@ -603,17 +695,31 @@ void Config::read( const std::string & file )
 
     // ---------------[ commit ]------------------------------------------------
 
-    s = augeas.getOption( asString(ConfigOption::COMMIT_AUTO_AGREE_WITH_LICENSES) );
+    s = cfg.getOption( asString(ConfigOption::COMMIT_AUTO_AGREE_WITH_LICENSES) );
     if ( ! s.empty() )
       LicenseAgreementPolicyData::_defaultAutoAgreeWithLicenses = str::strToBool( s, LicenseAgreementPolicyData::_defaultAutoAgreeWithLicenses );
 
-    s = augeas.getOption(asString( ConfigOption::COMMIT_PS_CHECK_ACCESS_DELETED ));
+    s = cfg.getOption(asString( ConfigOption::COMMIT_PS_CHECK_ACCESS_DELETED ));
     if ( ! s.empty() )
       psCheckAccessDeleted = str::strToBool( s, psCheckAccessDeleted );
 
+    s = cfg.getOption(asString( ConfigOption::COMMIT_PREFETCH_PACKAGES ));
+    if ( ! s.empty() )
+      commit_prefetchPackages = str::strToBool( s, commit_prefetchPackages );
+
+    s = cfg.getOption(asString( ConfigOption::COMMIT_PREFETCH_MAX_SPEED ));
+    if ( ! s.empty() )
+    {
+      unsigned speed = 0;
+      if ( str::strtonum( s, speed ) )
+        commit_prefetchMaxSpeed = speed;
+      else
+        WAR << "zypper.conf: commit/prefetchMaxSpeed: invalid value '" << s << "'" << endl;
+    }
+
     // ---------------[ colors ]------------------------------------------------
 
-    s = augeas.getOption( asString( ConfigOption::COLOR_USE_COLORS ) );
+    s = cfg.getOption( asString( ConfigOption::COLOR_USE_COLORS ) );
     if (!s.empty())
       color_useColors = s;
 
@@ -635,7 +741,7 @@ void Config::read( const std::string & file )
       { color_pkglistHighlightAttribute, ConfigOption::COLOR_PKGLISTHIGHLIGHT_ATTRIBUTE },
     } )
     {
-      c = ansi::Color::fromString( augeas.getOption( asString( el.second ) ) );
+      c = ansi::Color::fromString( cfg.getOption( asString( el.second ) ) );
       if ( c )
         el.first = c;
       // Fix color attributes: Default is mapped to Unchanged to allow
@@ -650,7 +756,7 @@ void Config::read( const std::string & file )
       }
     }
 
-    s = augeas.getOption( asString( ConfigOption::COLOR_PKGLISTHIGHLIGHT ) );
+    s = cfg.getOption( asString( ConfigOption::COLOR_PKGLISTHIGHLIGHT ) );
     if (!s.empty())
     {
       if ( s == "all" )
@@ -663,19 +769,23 @@ void Config::read( const std::string & file )
         WAR << "zypper.conf: color/pkglistHighlight: unknown value '" << s << "'" << endl;
     }
 
-    s = augeas.getOption("color/background");	// legacy
+    s = cfg.getOption("color/background");	// legacy
     if ( !s.empty() )
       WAR << "zypper.conf: ignore legacy option 'color/background'" << endl;
 
     // ---------------[ search ]------------------------------------------------
 
-    s = augeas.getOption( asString( ConfigOption::SEARCH_RUNSEARCHPACKAGES ) );
+    s = cfg.getOption( asString( ConfigOption::SEARCH_RUNSEARCHPACKAGES ) );
     if ( !s.empty() )
       search_runSearchPackages = str::strToTriBool( s );
 
+    s = cfg.getOption( asString( ConfigOption::SEARCH_USE_INDEX ) );
+    if ( !s.empty() )
+      search_useIndex = str::strToBool( s, search_useIndex );
+
     // ---------------[ obs ]---------------------------------------------------
 
-    s = augeas.getOption(asString( ConfigOption::OBS_BASE_URL ));
+    s = cfg.getOption(asString( ConfigOption::OBS_BASE_URL ));
     if (!s.empty())
     {
       try { obs_baseUrl = Url(s); }
@@ -685,22 +795,22 @@ void Config::read( const std::string & file )
       }
     }
 
-    s = augeas.getOption(asString( ConfigOption::OBS_PLATFORM ));
+    s = cfg.getOption(asString( ConfigOption::OBS_PLATFORM ));
     if (!s.empty())
       obs_platform = s;
 
-    s = augeas.getOption( asString( ConfigOption::SUBCOMMAND_SEACHSUBCOMMANDINPATH ) );
+    s = cfg.getOption( asString( ConfigOption::SUBCOMMAND_SEACHSUBCOMMANDINPATH ) );
     if ( not s.empty() )
       seach_subcommand_in_path = str::strToBool( s, seach_subcommand_in_path );
 
     // finally remember the default config file for saving back values
-    _cfgSaveFile = augeas.getSaveFile();
+    _cfgSaveFile = cfg.getSaveFile();
     m.stop();
   }
   catch (Exception & e)
   {
     std::cerr << e.asUserHistory() << endl;
-    std::cerr << "*** Augeas exception: No config files read, sticking with defaults." << endl;
+    std::cerr << "*** Config file error: No config files read, sticking with defaults." << endl;
   }
 
   setColorForOut( do_colors );
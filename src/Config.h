@@ -38,10 +38,27 @@ struct Config : public ztui::Config
   /** Which columns to show in repo list by default (string of short options).*/
   std::string repo_list_columns;
 
+  /** Max. number of repos to check and download raw metadata for in parallel (1: serial). */
+  unsigned refresh_jobs;
+
+  /** Max. number of packages 'zypper download' fetches in parallel (1: serial). */
+  unsigned download_jobs;
+
+  /** Max. number of parallel downloads from the same repo (0: no limit). */
+  unsigned download_jobsPerRepo;
+
+  /** Minutes an autorefresh service is not refreshed again by other commands (0: always refresh). */
+  unsigned service_refreshTTL;
+
+  /** Replay the results of 'list-updates' and 'patch-check' while their input is unchanged (ResultCache). */
+  bool cacheQueryResults;
+
   bool solver_installRecommends;
   std::set<ZypperCommand> solver_forceResolutionCommands;
 
   bool psCheckAccessDeleted;	///< do post commit 'zypper ps' check?
+  bool commit_prefetchPackages;	///< download the packages while the 'Continue?' prompt waits
+  unsigned commit_prefetchMaxSpeed;	///< KiB/s for the prefetch (0: no limit)
 
   /** zypper.conf: color.useColors */
   std::string color_useColors;
@@ -54,6 +71,8 @@ struct Config : public ztui::Config
   /** Hackisch way so save back a search_runSearchPackages value from search-packages-hinthack. */
   void saveback_search_runSearchPackages( const zypp::TriBool & value_r );
 
+  bool search_useIndex;		// build and use the repos search index (SearchIndex)
+
   /** zypper.conf: obs.baseUrl */
   zypp::Url obs_baseUrl;
   /** zypper.conf: obs.platform */
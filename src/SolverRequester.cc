@@ -9,11 +9,16 @@
 /** \file SolverRequester.cc
  *
  */
+#include <algorithm>
+#include <cstring>
+
 #include <zypp/ZYppFactory.h>
 #include <zypp/base/LogTools.h>
 
 #include <zypp/PoolQuery.h>
+#include <zypp/ResPool.h>
 #include <zypp/PoolItemBest.h>
+#include <zypp/Range.h>
 
 #include <zypp/Capability.h>
 #include <zypp/Resolver.h>
@@ -85,11 +90,62 @@ namespace
     return pkg_spec_to_poolquery( cap, repos );
   }
 
-  std::set<PoolItem> get_installed_providers( const Capability & cap )
+  /** Whether \a cap names packages by glob (and must be looked up by \ref pkg_spec_to_poolquery). */
+  inline bool pkg_spec_is_glob( const Capability & cap )
+  { return ::strpbrk( cap.detail().name().c_str(), "*?[\\" ) != nullptr; }
+
+  /** The items \ref pkg_spec_to_poolquery would find for a \a cap without glob.
+   * Instead of scanning the pool per name, the items are looked up in the
+   * pool's ident index (built once for all arguments) and just edition,
+   * arch and repo are checked.
+   */
+  std::vector<PoolItem> pkg_spec_to_items( const Capability & cap, const std::list<std::string> & repos )
+  {
+    std::vector<PoolItem> ret;
+    sat::Solvable::SplitIdent splid( cap.detail().name() );
+    Edition::MatchRange range( cap.detail().op(), cap.detail().ed() );
+    Arch arch( cap.detail().arch() );
+
+    const ResPool & pool( ResPool::instance() );
+    for_( it, pool.byIdentBegin( splid.ident() ), pool.byIdentEnd( splid.ident() ) )
+    {
+      const PoolItem & pi( *it );
+      if ( pi.kind() != splid.kind() )	// package and srcpackage share the name
+        continue;
+      if ( !repos.empty() && std::find( repos.begin(), repos.end(), pi.repository().alias() ) == repos.end() )
+        continue;
+      if ( range.op != Rel::ANY && !overlaps( Edition::MatchRange( Rel::EQ, pi.edition() ), range ) )
+        continue;
+      if ( arch != Arch_empty && pi.arch() != arch )
+        continue;
+      ret.push_back( pi );
+    }
+    DBG << "ident " << splid.ident() << ": " << ret.size() << " items" << endl;
+    return ret;
+  }
+
+  /** The items named by \a cap (no provides), restricted to \a repos. */
+  std::vector<PoolItem> pkg_spec_to_named_items( const Capability & cap, const std::list<std::string> & repos )
+  {
+    if ( !pkg_spec_is_glob( cap ) )
+      return pkg_spec_to_items( cap, repos );
+
+    PoolQuery q( pkg_spec_to_poolquery( cap, repos ) );
+    return std::vector<PoolItem>( q.poolItemBegin(), q.poolItemEnd() );
+  }
+
+  std::vector<PoolItem> pkg_spec_to_named_items( const Capability & cap, const std::string & repo )
+  {
+    std::list<std::string> repos;
+    if ( !repo.empty() )
+      repos.push_back( repo );
+    return pkg_spec_to_named_items( cap, repos );
+  }
+
+  std::set<PoolItem> get_installed_providers( const sat::WhatProvides & q )
   {
     std::set<PoolItem> providers;
 
-    sat::WhatProvides q( cap );
     for_( it, q.poolItemBegin(), q.poolItemEnd() )
     {
       if ( traits::isPseudoInstalled( (*it).satSolvable().kind() ) )
@@ -222,16 +278,16 @@ void SolverRequester::install( const PackageSpec & pkg )
   // first try by name
   if ( !_opts.force_by_cap )
   {
-    PoolQuery q;
+    std::vector<PoolItem> matches;
     if ( !pkg.repo_alias.empty() )
-      q = pkg_spec_to_poolquery( pkg.parsed_cap, pkg.repo_alias );
+      matches = pkg_spec_to_named_items( pkg.parsed_cap, pkg.repo_alias );
     else
-      q = pkg_spec_to_poolquery( pkg.parsed_cap, _opts.from_repos );
+      matches = pkg_spec_to_named_items( pkg.parsed_cap, _opts.from_repos );
 
     // get the best matching items and tag them for installation.
     // FIXME this ignores vendor lock - we need some way to do --from which
     // would respect vendor lock: e.g. a new Selectable::updateCandidateObj(Options&)
-    PoolItemBest bestMatches( q.begin(), q.end(), PoolItemBest::preferNotLocked );
+    PoolItemBest bestMatches( matches.begin(), matches.end(), PoolItemBest::preferNotLocked );
 
     if ( !bestMatches.empty() )
     {
@@ -313,6 +369,8 @@ void SolverRequester::install( const PackageSpec & pkg )
 
     addFeedback( Feedback::NOT_FOUND_NAME_TRYING_CAPS, pkg );
     // Quick check whether there would have been matches with different case..
+    PoolQuery q( !pkg.repo_alias.empty() ? pkg_spec_to_poolquery( pkg.parsed_cap, pkg.repo_alias )
+                                         : pkg_spec_to_poolquery( pkg.parsed_cap, _opts.from_repos ) );
     getCiMatchHint( q, ciMatchHint );
   }
 
@@ -327,7 +385,7 @@ void SolverRequester::install( const PackageSpec & pkg )
   }
 
   // is the provider already installed?
-  std::set<PoolItem> providers = get_installed_providers( pkg.parsed_cap );
+  std::set<PoolItem> providers = get_installed_providers( q );
   // already installed, try to update()
   for_( it, providers.begin(), providers.end() )
   {
@@ -355,12 +413,12 @@ void SolverRequester::remove( const PackageSpec & pkg )
   // first try by name
   if ( !_opts.force_by_cap )
   {
-    PoolQuery q = pkg_spec_to_poolquery( pkg.parsed_cap, "" );
+    std::vector<PoolItem> matches( pkg_spec_to_named_items( pkg.parsed_cap, "" ) );
 
-    if ( !q.empty() )
+    if ( !matches.empty() )
     {
       bool got_installed = false;
-      for_( it, q.poolItemBegin(), q.poolItemEnd() )
+      for_( it, matches.begin(), matches.end() )
       {
         if ( it->status().isInstalled() )
         {
@@ -389,6 +447,7 @@ void SolverRequester::remove( const PackageSpec & pkg )
 
     addFeedback( Feedback::NOT_FOUND_NAME_TRYING_CAPS, pkg );
     // Quick check whether there would have been matches with different case..
+    PoolQuery q( pkg_spec_to_poolquery( pkg.parsed_cap, "" ) );
     getCiMatchHint( q, ciMatchHint );
   }
 
@@ -403,7 +462,7 @@ void SolverRequester::remove( const PackageSpec & pkg )
   }
 
   // is the provider already installed?
-  std::set<PoolItem> providers = get_installed_providers( pkg.parsed_cap );
+  std::set<PoolItem> providers = get_installed_providers( q );
 
   // not installed, nothing to do
   if ( providers.empty() )
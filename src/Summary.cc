@@ -9,6 +9,9 @@
 #include <iostream>
 #include <sstream>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <zypp/ZYppFactory.h>
 #include <zypp/base/LogTools.h>
@@ -27,6 +30,7 @@
 #include "Zypper.h"
 
 #include "Summary.h"
+#include "output/OutJSON.h"
 #include "utils/console.h"
 
 // Suppress all application related summary messages.
@@ -171,13 +175,42 @@ namespace {
 
 // --------------------------------------------------------------------------
 
-bool Summary::ResPairNameCompare::operator()( const ResPair & p1, const ResPair & p2 ) const
+namespace
 {
-  int ret = ::strcoll( p1.second->name().c_str(), p2.second->name().c_str() );
-  if ( ret == 0 )
-    return p1.second->edition() < p2.second->edition();
-  return ret < 0;
-}
+  /** The collation key (strxfrm) of \a obj_r's name.
+   * Comparing the keys is equivalent to strcoll, but the key is computed
+   * once per name and not per comparison when sorting the summary lists.
+   */
+  const std::string & collationKey( const ResObject::constPtr & obj_r )
+  {
+    static std::unordered_map<sat::detail::IdType, std::string> _keys;	// by ident
+
+    auto it = _keys.find( obj_r->ident().id() );
+    if ( it == _keys.end() )
+    {
+      const std::string & name( obj_r->name() );
+      std::vector<char> buf( ::strxfrm( nullptr, name.c_str(), 0 ) + 1 );
+      ::strxfrm( buf.data(), name.c_str(), buf.size() );
+      it = _keys.emplace( obj_r->ident().id(), std::string( buf.data() ) ).first;
+    }
+    return it->second;
+  }
+
+  /** Compare by name (collation order), then by edition. */
+  inline bool nameEditionLess( const ResObject::constPtr & lhs, const ResObject::constPtr & rhs )
+  {
+    if ( lhs->ident() != rhs->ident() )
+    {
+      int ret = collationKey( lhs ).compare( collationKey( rhs ) );
+      if ( ret != 0 )
+        return ret < 0;
+    }
+    return lhs->edition() < rhs->edition();
+  }
+} // namespace
+
+bool Summary::ResPairNameCompare::operator()( const ResPair & p1, const ResPair & p2 ) const
+{ return nameEditionLess( p1.second, p2.second ); }
 
 // --------------------------------------------------------------------------
 
@@ -196,13 +229,20 @@ Summary::Summary( const ResPool & pool, SummaryHints summaryHints, const ViewOpt
 
 struct ResNameCompare
 {
-  bool operator()( ResObject::constPtr r1, ResObject::constPtr r2 ) const
-  {
-    int ret = ::strcoll( r1->name().c_str(), r2->name().c_str() );
-    if ( ret == 0 )
-      return r1->edition() < r2->edition();
-    return ret < 0;
-  }
+  /** Lookup all objects with the same name (see \ref collationKey). */
+  struct ByName
+  { const std::string & _key; };
+
+  using is_transparent = void;
+
+  bool operator()( const ResObject::constPtr & r1, const ResObject::constPtr & r2 ) const
+  { return nameEditionLess( r1, r2 ); }
+
+  bool operator()( const ResObject::constPtr & r1, const ByName & r2 ) const
+  { return collationKey( r1 ) < r2._key; }
+
+  bool operator()( const ByName & r1, const ResObject::constPtr & r2 ) const
+  { return r1._key < collationKey( r2 ); }
 };
 
 typedef std::map<Resolvable::Kind, std::set<ResObject::constPtr, ResNameCompare> > KindToResObjectSet;
@@ -337,9 +377,10 @@ void Summary::readPool( const ResPool & pool )
         }
       }
 
-      // find in to_be_removed:
+      // find in to_be_removed (just the objects with the same name):
       bool upgrade_downgrade = false;
-      for_( rmit, to_be_removed[res->kind()].begin(), to_be_removed[res->kind()].end() )
+      auto removedByName = to_be_removed[res->kind()].equal_range( ResNameCompare::ByName{ collationKey( res ) } );
+      for_( rmit, removedByName.first, removedByName.second )
       {
         if ( res->name() == (*rmit)->name() )
         {
@@ -436,9 +477,25 @@ void Summary::readPool( const ResPool & pool )
   ResKindSet kinds;
   kinds.insert( ResKind::package );
   kinds.insert( ResKind::product );
+  // Only selectables with an installed object are of interest, so start
+  // at the (usually few) installed solvables instead of the whole pool.
+  std::map<ResKind, std::vector<ui::Selectable::Ptr>> installedSelectables;
+  {
+    std::unordered_set<sat::detail::IdType> seen;
+    for ( const sat::Solvable & slv : sat::Pool::instance().findSystemRepo().solvables() )
+    {
+      ResKind kind( slv.kind() );
+      if ( kinds.count( kind ) && seen.insert( slv.ident().id() ).second )
+      {
+        ui::Selectable::Ptr sel( ui::Selectable::get( slv ) );
+        if ( sel )
+          installedSelectables[kind].push_back( sel );
+      }
+    }
+  }
   for_( kit, kinds.begin(), kinds.end() )
   {
-    for_( it, pool.proxy().byKindBegin(*kit), pool.proxy().byKindEnd(*kit) )
+    for_( it, installedSelectables[*kit].begin(), installedSelectables[*kit].end() )
     {
       if ( !(*it)->hasInstalledObj() )
         continue;
@@ -1941,3 +1998,65 @@ void Summary::dumpAsXmlTo( std::ostream & out )
 
   out << "</install-summary>" << endl;
 }
+
+// --------------------------------------------------------------------------
+
+void Summary::writeJsonResolvableList( std::ostream & out, const char * action_r, const KindToResPairSet & resolvables )
+{
+  for ( const auto & kindres : resolvables )
+  {
+    for ( const ResPair & respair : kindres.second )
+    {
+      ResObject::constPtr res( respair.second );
+      ResObject::constPtr rold( respair.first );
+
+      OutJSON::Record record( "summary-solvable" );
+      record.add( "action", action_r )
+            .add( "kind", res->kind().asString() )
+            .add( "name", res->name() )
+            .add( "edition", res->edition().asString() )
+            .add( "arch", res->arch().asString() )
+            .add( "repository", res->repoInfo().alias() );
+      if ( rold )
+      {
+        record.add( "edition-old", rold->edition().asString() )
+              .add( "arch-old", rold->arch().asString() );
+      }
+      record.addIfNotEmpty( "summary", res->summary() )
+            .addIfNotEmpty( "description", res->description() );
+      OutJSON::writeRecord( out, record );
+    }
+  }
+}
+
+// --------------------------------------------------------------------------
+
+void Summary::dumpAsJsonTo( std::ostream & out )
+{
+  unsigned pkgchanged = _inst_pkg_total;
+  const auto & iter = _toremove.find( ResKind::package );
+  if ( iter != _toremove.end() )
+    pkgchanged += iter->second.size();
+
+  OutJSON::Record record( "install-summary" );
+  record.add( "download-size", (ByteCount::SizeType)_todownload )
+        .add( "space-usage-diff", (ByteCount::SizeType)_inst_size_change )
+        .add( "packages-to-change", pkgchanged )
+        .add( "need-restart", showNeedRestartHint() )
+        .add( "need-reboot", showNeedRebootHInt() );
+  OutJSON::writeRecord( out, record );
+
+  writeJsonResolvableList( out, "upgrade", _toupgrade );
+  writeJsonResolvableList( out, "downgrade", _todowngrade );
+  writeJsonResolvableList( out, "install", _toinstall );
+  writeJsonResolvableList( out, "reinstall", _toreinstall );
+  writeJsonResolvableList( out, "remove", _toremove );
+  writeJsonResolvableList( out, "change-arch", _tochangearch );
+  writeJsonResolvableList( out, "change-vendor", _tochangevendor );
+
+  if ( _viewop & SHOW_UNSUPPORTED )
+  {
+    writeJsonResolvableList( out, "unsupported", _supportUnknown );
+    writeJsonResolvableList( out, "unsupported", _supportUnsupported );
+  }
+}
@@ -132,6 +132,8 @@ public:
 
   void dumpTo( std::ostream & out );
   void dumpAsXmlTo( std::ostream & out );
+  /** One \c "install-summary" record followed by a \c "summary-solvable" record per change. */
+  void dumpAsJsonTo( std::ostream & out );
 
 private:
   void readPool( const zypp::ResPool & pool );
@@ -141,6 +143,7 @@ private:
   { return writeResolvableList( out, resolvables, ansi::Color::nocolor(), maxEntries_r, withKind_r ); }
 
   void writeXmlResolvableList( std::ostream & out, const KindToResPairSet & resolvables );
+  void writeJsonResolvableList( std::ostream & out, const char * action_r, const KindToResPairSet & resolvables );
 
   void collectInstalledRecommends( const zypp::ResObject::constPtr & obj );
 
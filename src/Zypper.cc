@@ -16,7 +16,12 @@
 #include <map>
 #include <iterator>
 
+#include <cstring>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <readline/history.h>
 
 #include <zypp/ZYppFactory.h>
@@ -49,6 +54,7 @@
 #include "utils/getopt.h"
 #include "utils/misc.h"
 #include "utils/prompt.h"
+#include "utils/Profile.h"
 
 #include "repos.h"
 #include "misc.h"
@@ -59,6 +65,7 @@
 
 #include "commands/search/search-packages-hinthack.h"
 #include "commands/help.h"
+#include "commands/serve.h"
 #include "utils/console.h"
 using namespace zypp;
 
@@ -248,6 +255,7 @@ int Zypper::main( int argc, char ** argv )
       setExitCode( ZYPPER_EXIT_ERR_BUG );
   }
 
+  Profile::report( *this );	// --profile
   return exitCode();
 }
 
@@ -419,8 +427,8 @@ void Zypper::commandShell()
 
     try
     {
-      MIL << "Reloading..." << endl;
-      God->target()->reload();   // reload system in case rpm database has changed
+      // reload what changed on disk (e.g. the rpm database) since the last command
+      _poolState.reloadChanged( *this );
       doCommand( args.argc(), args.argv(), 0 );
     }
     catch ( const Exception & e )
@@ -441,6 +449,196 @@ void Zypper::commandShell()
   cleanup();
 }
 
+void Zypper::commandServer( const std::string & socket_r )
+{
+  MIL << "Entering the server on " << socket_r << endl;
+
+  struct sockaddr_un addr;
+  ::memset( &addr, 0, sizeof(addr) );
+  addr.sun_family = AF_UNIX;
+  if ( socket_r.empty() || socket_r.size() >= sizeof(addr.sun_path) )
+  {
+    out().error( str::Format(_("Invalid socket path '%1%'.")) % socket_r );
+    setExitCode( ZYPPER_EXIT_ERR_INVALID_ARGS );
+    return;
+  }
+  ::strcpy( addr.sun_path, socket_r.c_str() );
+
+  // A socket left behind by a previous server is replaced, anything else is not touched.
+  auto unlinkSocket = [&socket_r]() -> bool {
+    struct stat st;
+    if ( ::lstat( socket_r.c_str(), &st ) != 0 )
+      return errno == ENOENT;
+    if ( ! S_ISSOCK( st.st_mode ) )
+      return false;
+    ::unlink( socket_r.c_str() );
+    return true;
+  };
+  if ( ! unlinkSocket() )
+  {
+    out().error( str::Format(_("'%1%' exists and is not a socket.")) % socket_r );
+    setExitCode( ZYPPER_EXIT_ERR_INVALID_ARGS );
+    return;
+  }
+
+  int sock = ::socket( AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0 );
+  mode_t mask = ::umask( 0077 );	// for root only (or the user running the server)
+  bool ok = sock != -1
+            && ::bind( sock, (struct sockaddr *)&addr, sizeof(addr) ) == 0
+            && ::listen( sock, 16 ) == 0;
+  ::umask( mask );
+  if ( ! ok )
+  {
+    out().error( str::Format(_("Can not listen on '%1%': %2%")) % socket_r % str::strerror( errno ) );
+    setExitCode( ZYPPER_EXIT_ERR_ZYPP );
+    if ( sock != -1 )
+      ::close( sock );
+    return;
+  }
+
+  setRunningShell( true );
+  // Nobody to ask, and the caches are not written without holding the zypp lock.
+  _config.non_interactive = true;
+  _config.no_refresh = true;
+
+  init_target( *this );
+  out().info( str::Format(_("Listening on '%1%'.")) % socket_r );
+
+  // Wake up every second to check for SIGINT/SIGTERM.
+  struct timeval timeout { 1, 0 };
+  while ( ! exitRequested() )
+  {
+    struct pollfd pfd = { sock, POLLIN, 0 };
+    int res = ::poll( &pfd, 1, 1000 );
+    if ( res < 0 && errno != EINTR )
+    {
+      ERR << "poll: " << str::strerror( errno ) << endl;
+      break;
+    }
+    if ( res <= 0 )
+      continue;
+
+    int conn = ::accept4( sock, nullptr, nullptr, SOCK_CLOEXEC );
+    if ( conn == -1 )
+      continue;
+    ::setsockopt( conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+
+    // Clients are served one after the other; libzypp is not thread safe.
+    // So a client idle for too long is dropped to let the others in.
+    MIL << "Client connected" << endl;
+    std::string buffer;
+    char chunk[4096];
+    unsigned idle = 0;	// seconds (SO_RCVTIMEO)
+    for ( ssize_t cnt; ( cnt = ::read( conn, chunk, sizeof(chunk) ) ) != 0; )
+    {
+      if ( cnt < 0 )
+      {
+        if ( errno == EINTR && ! exitRequested() )
+          continue;
+        if ( ( errno == EAGAIN || errno == EWOULDBLOCK ) && ! exitRequested() )
+        {
+          if ( ++idle < serve::idleTimeout )
+            continue;
+          MIL << "Client idle for " << idle << "s" << endl;
+        }
+        break;
+      }
+      idle = 0;
+      buffer.append( chunk, cnt );
+
+      std::string::size_type eol;
+      bool gone = false;
+      while ( ! gone && ( eol = buffer.find( '\n' ) ) != std::string::npos )
+      {
+        std::string line { buffer.substr( 0, eol ) };
+        buffer.erase( 0, eol + 1 );
+        if ( str::trim( line ).empty() )
+          continue;
+
+        std::string response { serveRequest( line ) + '\n' };
+        for ( std::string::size_type done = 0; done < response.size(); )
+        {
+          ssize_t sent = ::send( conn, response.data() + done, response.size() - done, MSG_NOSIGNAL );
+          if ( sent < 0 && errno == EINTR )
+            continue;
+          if ( sent <= 0 )
+          {
+            gone = true;
+            break;
+          }
+          done += sent;
+        }
+      }
+      if ( gone )
+        break;
+    }
+    ::close( conn );
+    MIL << "Client disconnected" << endl;
+  }
+
+  ::close( sock );
+  unlinkSocket();
+  MIL << "Leaving the server" << endl;
+  setRunningShell( false );
+}
+
+std::string Zypper::serveRequest( const std::string & line_r )
+{
+  serve::Request request;
+  try
+  {
+    request = serve::parseRequest( line_r );
+    if ( request.args.empty() )
+      ZYPP_THROW( Exception( _("No command given.") ) );
+    if ( ! serve::isReadOnlyCommand( ZypperCommand( request.args[0] ) ) )
+      return serve::response( request, ZYPPER_EXIT_ERR_INVALID_ARGS, "",
+                              str::Format(_("Command '%1%' is not served. Only commands querying the system are.")) % request.args[0] );
+  }
+  catch ( const Exception & e )
+  {
+    ZYPP_CAUGHT( e );
+    return serve::response( request, ZYPPER_EXIT_ERR_SYNTAX, "", e.asUserString() );
+  }
+
+  // Don't read the rpm database or caches while they are changed.
+  if ( pid_t pid = serve::zyppLockHolder() )
+  {
+    return serve::response( request, ZYPPER_EXIT_ZYPP_LOCKED, "",
+                            str::Format(_("System management is locked by the application with pid %1%. Try again later.")) % pid );
+  }
+
+  MIL << "Serving " << request.args << endl;
+  std::ostringstream output;
+  std::ostringstream errors;
+  {
+    std::streambuf * savedOut = cout.rdbuf( output.rdbuf() );
+    std::streambuf * savedErr = cerr.rdbuf( errors.rdbuf() );
+
+    std::vector<char *> argv;
+    for ( std::string & arg : request.args )
+      argv.push_back( &arg[0] );
+    argv.push_back( nullptr );
+
+    try
+    {
+      _poolState.reloadChanged( *this );
+      doCommand( argv.size() - 1, argv.data(), 0 );
+    }
+    catch ( const Exception & e )
+    {
+      out().error( e.msg() );
+    }
+    cout.flush();
+    cerr.flush();
+    cout.rdbuf( savedOut );
+    cerr.rdbuf( savedErr );
+  }
+
+  int exitCode { this->exitCode() };
+  shellCleanup();
+  return serve::response( request, exitCode, output.str(), errors.str() );
+}
+
 void Zypper::shellCleanup()
 {
   MIL << "Cleaning up for the next command." << endl;
@@ -468,14 +666,8 @@ void Zypper::shellCleanup()
   // runtime data
   _rdata.current_repo = RepoInfo();
 
-  // cause the RepoManager to be reinitialized
-  _rm.reset();
-
-  // TODO:
-  // _rdata.repos re-read after repo operations or modify/remove these very repoinfos
-  // _rdata.repo_resolvables re-read only after certain repo operations (all?)
-  // _rdata.target_resolvables re-read only after installation/removal/update
-  // call target commit refresh pool after installation/removal/update (#328855)
+  // The RepoManager, the repos and the target stay loaded for the next
+  // command. PoolState::reloadChanged drops what changed on disk meanwhile.
 }
 
 
@@ -616,6 +808,7 @@ void Zypper::doCommand( int cmdArgc, char **cmdArgv, int firstFlag )
             zypp_readonly_hack::IWantIt ();
 
         else if ( command() == ZypperCommand::LIST_REPOS
+                    || command() == ZypperCommand::SERVE	// must not block other zypp applications
                     || command() == ZypperCommand::LIST_SERVICES
                     || command() == ZypperCommand::HELP
                     || command() == ZypperCommand::VERSION_CMP
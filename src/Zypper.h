@@ -10,6 +10,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
 
 #include <boost/utility/string_ref.hpp>
 
@@ -29,6 +31,7 @@
 #include "Command.h"
 #include "utils/getopt.h"
 #include "utils/Offering.h"
+#include "utils/PoolState.h"
 #include "output/Out.h"
 #include "Guardians.h"
 
@@ -101,6 +104,14 @@ struct RuntimeData
   // into the RepoManager::refreshMetadata(), so that we get a combined percentage
   std::string raw_refresh_progress_label;
 
+  /** Raw metadata already checked (and downloaded if needed) by \ref prefetch_raw_metadata (by alias).
+   * \c REFRESH_NEEDED indicates the refresh has been done.
+   */
+  std::map<std::string,RepoManager::RefreshCheckStatus> prefetched_raw_metadata;
+
+  /** Repos whose solv cache has already been built by \ref prebuild_caches (by alias). */
+  std::set<std::string> prebuilt_caches;
+
   /** Used to override the command line option */
   TriBool force_resolution;
 
@@ -145,6 +156,7 @@ public:
 
   const ZypperCommand & command() const		{ return _command; }
   RuntimeData & runtimeData()			{ return _rdata; }
+  PoolState & poolState()			{ return _poolState; }
 
   void initRepoManager()
   { _rm.reset( new RepoManager( _config.rm_options ) ); }
@@ -212,6 +224,9 @@ public:
 
   void commandShell();
 
+  /** Answer querying commands sent over the UNIX socket \a socket_r ('zypper serve'). */
+  void commandServer( const std::string & socket_r );
+
 public:
   virtual ~Zypper();
 
@@ -223,6 +238,7 @@ private:
 
   int processGlobalOptions();
   void shellCleanup();
+  std::string serveRequest( const std::string & line_r );
   void doCommand(int cmdArgc, char **cmdArgv , int firstFlag = 0 );
 
   void setRunningHelp( bool value = true )		{ _running_help = value; }
@@ -247,6 +263,7 @@ private:
   unsigned  _exit_requested;
 
   RuntimeData _rdata;
+  PoolState _poolState;
 
   RepoManager_Ptr   _rm;
 };
@@ -19,6 +19,7 @@
 #include "Zypper.h"
 #include "utils/prompt.h"
 #include "utils/misc.h"
+#include "utils/Profile.h"
 
 ///////////////////////////////////////////////////////////////////
 namespace ZmartRecipients
@@ -41,9 +42,11 @@ struct DownloadResolvableReportReceiver : public callback::ReceiveReport<repo::D
   void reportbegin() override
   {
     _demandVerboseDownloadProgress = Zypper::instance().runtimeData().scopedVerboseDownloadProgress.demand();
+    Profile::start( "download" );
   }
   void reportend() override
   {
+    Profile::stop( "download" );
     _demandVerboseDownloadProgress.reset();
   }
 
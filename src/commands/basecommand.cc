@@ -7,6 +7,7 @@
 #include "commandhelpformatter.h"
 #include "solve-commit.h"
 #include "global-settings.h"
+#include "output/OutJSON.h"
 
 #include "src/repos.h"
 
@@ -153,6 +154,11 @@ std::vector<BaseCommandConditionPtr> ZypperBaseCommand::conditions() const
   return std::vector<BaseCommandConditionPtr>();
 }
 
+bool ZypperBaseCommand::jsonOutput() const
+{
+  return false;
+}
+
 int ZypperBaseCommand::systemSetup( Zypper &zypper )
 {
   return defaultSystemSetup ( zypper, _systemInitFlags );
@@ -235,6 +241,13 @@ int ZypperBaseCommand::run( Zypper &zypper )
   MIL << "run: " << command().front() << endl;
   try
   {
+    if ( typeJSON( zypper.out() ) && ! jsonOutput() )
+    {
+      // translators: %1% is a zypper command name, e.g. 'repos'
+      zypper.out().error( str::Format(_("JSON output not implemented for the '%1%' command.")) % command().front() );
+      return ZYPPER_EXIT_ERR_INVALID_ARGS;
+    }
+
     for ( const BaseCommandConditionPtr &cond : conditions() ) {
       std::string error;
       int code = cond->check( error );
@@ -226,6 +226,13 @@ protected:
    */
   virtual std::vector<BaseCommandConditionPtr> conditions() const;
 
+  /**
+   * Returns whether the command writes its results as --jsonout records.
+   * Other commands refuse to run with --jsonout rather than writing plain
+   * text into the JSON stream. The default implementation returns false.
+   */
+  virtual bool jsonOutput() const;
+
   /**
    * Reimplement to return the commands own options.
    */
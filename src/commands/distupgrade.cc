@@ -50,6 +50,11 @@ void DistUpgradeCmd::doReset()
   _details = false;
 }
 
+bool DistUpgradeCmd::jsonOutput() const
+{
+  return true;
+}
+
 std::vector<BaseCommandConditionPtr> DistUpgradeCmd::conditions() const
 {
   return {
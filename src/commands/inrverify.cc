@@ -42,6 +42,11 @@ void InrVerifyCmd::doReset()
   _details = false;
 }
 
+bool InrVerifyCmd::jsonOutput() const
+{
+  return true;
+}
+
 int InrVerifyCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   // too many arguments
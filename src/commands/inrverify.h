@@ -47,6 +47,7 @@ public:
 protected:
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  bool jsonOutput() const override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
   std::vector<BaseCommandConditionPtr> conditions() const override;
 };
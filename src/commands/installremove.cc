@@ -75,6 +75,11 @@ void InstallRemoveBase::doReset()
   _selectByCap   = false;
 }
 
+bool InstallRemoveBase::jsonOutput() const
+{
+  return true;
+}
+
 RemoveCmd::RemoveCmd(std::vector<std::string> &&commandAliases_r) :
   InstallRemoveBase (
     std::move( commandAliases_r ),
@@ -48,6 +48,7 @@ protected:
   std::vector<BaseCommandConditionPtr> conditions() const override;
   ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  bool jsonOutput() const override;
 };
 
 class RemoveCmd : public InstallRemoveBase
@@ -38,6 +38,11 @@ void ListPatchesCmd::doReset()
   _all = false;
 }
 
+bool ListPatchesCmd::jsonOutput() const
+{
+  return true;
+}
+
 int ListPatchesCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
     // too many arguments
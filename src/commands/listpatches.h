@@ -28,6 +28,7 @@ private:
 protected:
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  bool jsonOutput() const override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
 };
 
@@ -7,6 +7,7 @@
 #include "listupdates.h"
 #include "commonflags.h"
 #include "utils/messages.h"
+#include "utils/ResultCache.h"
 #include "src/update.h"
 
 ListUpdatesCmd::ListUpdatesCmd( std::vector<std::string> &&commandAliases_r) :
@@ -44,6 +45,11 @@ void ListUpdatesCmd::doReset()
   _bestEffort = false;
 }
 
+bool ListUpdatesCmd::jsonOutput() const
+{
+  return true;
+}
+
 int ListUpdatesCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   // too many arguments
@@ -55,10 +61,23 @@ int ListUpdatesCmd::execute( Zypper &zypper, const std::vector<std::string> &pos
   if ( _kinds.empty() )
     _kinds.insert( ResKind::package );
 
-  int code = defaultSystemSetup( zypper, InitTarget | InitRepos | LoadResolvables | Resolve );
+  int code = defaultSystemSetup( zypper, InitTarget | InitRepos );
+  if ( code != ZYPPER_EXIT_OK )
+    return code;
+
+  // unchanged system: answer without loading the pool
+  std::string args;
+  for ( const ResKind & kind : _kinds )
+    args += kind.asString() + ",";
+  args += str::form( " %d %d", _bestEffort, _all );
+  ResultCache cache( zypper, "list-updates", args );
+  if ( cache.replay() )
+    return zypper.exitCode();
+
+  code = defaultSystemSetup( zypper, LoadResolvables | Resolve );
   if ( code != ZYPPER_EXIT_OK )
     return code;
 
-  list_updates( zypper, _kinds, _bestEffort, _all );
+  cache.record( [&]() { list_updates( zypper, _kinds, _bestEffort, _all ); } );
   return zypper.exitCode();
 }
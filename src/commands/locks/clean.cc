@@ -5,6 +5,7 @@
 #include "main.h"
 #include "Zypper.h"
 #include "commands/conditions.h"
+#include "commands/locks/common.h"
 #include "utils/flags/flagtypes.h"
 #include "utils/messages.h"
 
@@ -56,7 +57,21 @@ int CleanLocksCmd::execute(Zypper &zypper, const std::vector<std::string> &posit
   Locks::instance().read();
   Locks::size_type start = Locks::instance().size();
   if ( !_onlyDuplicates )
-    Locks::instance().removeEmpty();
+  {
+    // evaluate all locks in one pass over the pool instead of querying each one
+    std::vector<PoolQuery> empty;
+    {
+      locks::LockEvaluator evaluator( Locks::instance() );
+      unsigned idx = 0;
+      for ( const PoolQuery & q : Locks::instance() )
+      {
+        if ( evaluator.matches( idx++ ).empty() )
+          empty.push_back( q );
+      }
+    }
+    for ( const PoolQuery & q : empty )
+      Locks::instance().removeLock( q );
+  }
   if ( !_onlyEmpty )
     Locks::instance().removeDuplicates();
 
@@ -7,8 +7,16 @@
 /** \file commands/locks/common.cc
  * Common code used by different commands.
  */
+#include <set>
+#include <unordered_map>
+
+#include <zypp/base/StrMatcher.h>
+#include <zypp/RelCompare.h>
+#include <zypp/sat/Pool.h>
+
 #include "commands/locks/common.h"
 #include "repos.h"
+#include "utils/misc.h"
 
 // OLD STYLE VERSIONED LOCKS:
 //	solvable_name: kernel
@@ -97,5 +105,169 @@ namespace locks
     return q;
   }
 
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    /** The kinds a lock without kind restriction may match by ident. */
+    inline const std::vector<ResKind> & identKinds()
+    {
+      static const std::vector<ResKind> kinds { ResKind::package, ResKind::patch, ResKind::pattern, ResKind::product, ResKind::application };
+      return kinds;	// srcpackage idents are the plain name like package ones
+    }
+
+    /** A lock compiled for \ref LockEvaluator. */
+    struct CompiledLock
+    {
+      /** Whether \a q_r can be compiled; otherwise its PoolQuery must be used. */
+      static bool compilable( const PoolQuery & q_r )
+      {
+        if ( ! q_r.strings().empty() || q_r.statusFilterFlags() != PoolQuery::ALL )
+          return false;
+        for ( const auto & attr : q_r.attributes() )
+        {
+          if ( attr.first != sat::SolvAttr::name )
+            return false;
+        }
+        switch ( q_r.flags().mode() )
+        {
+          case Match::STRING:
+          case Match::STRINGSTART:
+          case Match::STRINGEND:
+          case Match::SUBSTRING:
+          case Match::GLOB:
+          case Match::REGEX:
+            return true;
+          default:
+            return false;
+        }
+      }
+
+      /** Whether \a name_r is matched by string comparison. */
+      static bool isExact( const std::string & name_r, const Match & flags_r )
+      {
+        if ( flags_r.test( Match::NOCASE ) )
+          return false;
+        if ( flags_r.mode() == Match::STRING )
+          return true;
+        return flags_r.mode() == Match::GLOB && name_r.find_first_of( "*?[\\" ) == std::string::npos;
+      }
+
+      CompiledLock( const PoolQuery & q_r )
+      : _kinds { q_r.kinds() }
+      , _repos { q_r.repos() }
+      , _op { q_r.editionRel() }
+      , _edition { q_r.edition() }
+      {}
+
+      /** Kind, repo and edition restrictions. */
+      bool accepts( const sat::Solvable & solv_r ) const
+      {
+        if ( ! _kinds.empty() && ! _kinds.count( solv_r.kind() ) )
+          return false;
+        if ( ! _repos.empty() && ! _repos.count( solv_r.repository().alias() ) )
+          return false;
+        if ( _op != Rel::ANY && ! compareByRel( _op, solv_r.edition(), _edition, Edition::Match() ) )
+          return false;
+        return true;
+      }
+
+      /** Whether one of the non-exact name patterns matches. */
+      bool matchesPattern( const sat::Solvable & solv_r ) const
+      {
+        for ( const StrMatcher & matcher : _matchers )
+        {
+          if ( matcher.doMatch( solvableName( solv_r ) ) )
+            return true;
+        }
+        return false;
+      }
+
+      PoolQuery::Kinds _kinds;
+      PoolQuery::StrContainer _repos;
+      Rel _op;
+      Edition _edition;
+      std::vector<StrMatcher> _matchers;	///< names not looked up by ident
+      bool _any = false;			///< no name given, matches any name
+    };
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  LockEvaluator::LockEvaluator( const Locks & locks_r )
+  {
+    std::vector<CompiledLock> compiled;
+    std::vector<unsigned> compiledIdx;			// index of compiled[i] in locks_r
+    std::unordered_map<sat::detail::IdType,std::vector<unsigned>> byIdent;	// into compiled
+    std::vector<unsigned> byPattern;			// into compiled
+
+    _matches.resize( locks_r.size() );
+    unsigned idx = 0;
+    unsigned queried = 0;
+    for ( const PoolQuery & q : locks_r )
+    {
+      if ( ! CompiledLock::compilable( q ) )
+      {
+        // the slow way
+        for ( const sat::Solvable & solv : q )
+          _matches[idx].push_back( solv );
+        ++queried;
+        ++idx;
+        continue;
+      }
+
+      unsigned cidx = compiled.size();
+      compiled.push_back( CompiledLock( q ) );
+      compiledIdx.push_back( idx );
+      CompiledLock & lock { compiled.back() };
+
+      const PoolQuery::StrContainer & names { q.attribute( sat::SolvAttr::name ) };
+      if ( names.empty() )
+        lock._any = true;
+      for ( const std::string & name : names )
+      {
+        if ( CompiledLock::isExact( name, q.flags() ) )
+        {
+          // PoolQuery matches the name without the kind prefix of the ident
+          std::set<sat::detail::IdType> idents;
+          for ( const ResKind & kind : lock._kinds.empty() ? identKinds() : std::vector<ResKind>( lock._kinds.begin(), lock._kinds.end() ) )
+            idents.insert( ResKind::satIdent( kind, name ).id() );
+          for ( sat::detail::IdType ident : idents )
+            byIdent[ident].push_back( cidx );
+        }
+        else
+          lock._matchers.push_back( StrMatcher( name, q.flags() ) );
+      }
+      if ( lock._any || ! lock._matchers.empty() )
+        byPattern.push_back( cidx );
+      ++idx;
+    }
+
+    if ( ! compiled.empty() )
+    {
+      for ( const sat::Solvable & solv : sat::Pool::instance().solvables() )
+      {
+        auto it = byIdent.find( solv.ident().id() );
+        if ( it != byIdent.end() )
+        {
+          for ( unsigned cidx : it->second )
+          {
+            std::vector<sat::Solvable> & matches { _matches[compiledIdx[cidx]] };
+            if ( compiled[cidx].accepts( solv ) && ( matches.empty() || matches.back() != solv ) )
+              matches.push_back( solv );
+          }
+        }
+        for ( unsigned cidx : byPattern )
+        {
+          std::vector<sat::Solvable> & matches { _matches[compiledIdx[cidx]] };
+          if ( ! matches.empty() && matches.back() == solv )
+            continue;	// already matched by ident
+          const CompiledLock & lock { compiled[cidx] };
+          if ( ( lock._any || lock.matchesPattern( solv ) ) && lock.accepts( solv ) )
+            matches.push_back( solv );
+        }
+      }
+    }
+    MIL << "Evaluated " << locks_r.size() << " locks in one pass (" << queried << " by PoolQuery)" << endl;
+  }
+
 } // namespace locks
 ///////////////////////////////////////////////////////////////////
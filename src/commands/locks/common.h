@@ -10,7 +10,11 @@
 #ifndef ZYPPER_COMMANDS_LOCKS_COMMON_H_INCLUDED
 #define ZYPPER_COMMANDS_LOCKS_COMMON_H_INCLUDED
 
+#include <vector>
+
 #include <zypp/PoolQuery.h>
+#include <zypp/Locks.h>
+#include <zypp/sat/Solvable.h>
 
 #include "Zypper.h"
 
@@ -21,6 +25,34 @@ namespace locks
    */
   zypp::PoolQuery arg2query( Zypper & zypper, const std::string & arg_r, const std::set<zypp::ResKind> & kinds_r, const std::vector<std::string> & repos_r, const std::string & comment_r );
 
+  ///////////////////////////////////////////////////////////////////
+  /// \class LockEvaluator
+  /// \brief The solvables matched by each lock, computed in a single pass over the pool.
+  ///
+  /// Evaluating each lock's PoolQuery on its own means a pool scan per
+  /// lock. Instead the name patterns of all locks are compiled upfront:
+  /// exact (and wildcard-free glob) names are looked up by ident (with the
+  /// kind prefix of each kind the lock applies to), other globs, regexes
+  /// and substrings are tested per solvable against the name without kind
+  /// prefix, as PoolQuery does. Kind, repo and edition restrictions are
+  /// checked for the candidates only.
+  ///
+  /// Locks using attributes other than the name or a status filter are
+  /// still evaluated by their PoolQuery.
+  ///////////////////////////////////////////////////////////////////
+  class LockEvaluator
+  {
+  public:
+    LockEvaluator( const zypp::Locks & locks_r );
+
+    /** The solvables matched by the \a idx_r-th lock (in the order of \ref zypp::Locks). */
+    const std::vector<zypp::sat::Solvable> & matches( unsigned idx_r ) const
+    { return _matches.at( idx_r ); }
+
+  private:
+    std::vector<std::vector<zypp::sat::Solvable>> _matches;
+  };
+
 } // namespace locks
 ///////////////////////////////////////////////////////////////////
 #endif // ZYPPER_COMMANDS_LOCKS_COMMON_H_INCLUDED
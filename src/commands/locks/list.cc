@@ -7,6 +7,7 @@
 #include "list.h"
 
 #include <iostream>
+#include <memory>
 #include <boost/lexical_cast.hpp>
 
 #include <zypp/base/String.h>
@@ -17,6 +18,7 @@
 #include "Table.h"
 #include "Zypper.h"
 #include "main.h"
+#include "commands/locks/common.h"
 
 #include "utils/flags/zyppflags.h"
 #include "utils/flags/flagtypes.h"
@@ -115,11 +117,12 @@ namespace out
         if ( _withMatches )
         {
           // <matches>
-          xmlout::Node matches( *lock, "matches", xmlout::Node::optionalContent, { { "size", q_r.size() } } );
-          if ( _withSolvables && !q_r.empty() )
+          const std::vector<sat::Solvable> & m { _evaluator->matches( _i-1 ) };
+          xmlout::Node matches( *lock, "matches", xmlout::Node::optionalContent, { { "size", m.size() } } );
+          if ( _withSolvables && !m.empty() )
           {
             MatchDetails d;
-            getLockDetails( q_r, d );
+            getLockDetails( m, d );
             xmlWriteContainer( *matches, d, MatchDetailFormater() );
           }
         }
@@ -160,7 +163,7 @@ namespace out
 
       // opt Matches
       if ( _withMatches )
-        tr << q_r.size();
+        tr << _evaluator->matches( _i-1 ).size();
 
       // Type
       std::set<std::string> strings;
@@ -177,11 +180,11 @@ namespace out
       tr << q_r.comment();
 
       // opt Solvables as detail
-      if ( _withSolvables && !q_r.empty() )
+      if ( _withSolvables && !_evaluator->matches( _i-1 ).empty() )
       {
         MatchDetails i;
         MatchDetails a;
-        getLockDetails( q_r, i, a );
+        getLockDetails( _evaluator->matches( _i-1 ), i, a );
 
         PropertyTable p;
         {
@@ -209,9 +212,11 @@ namespace out
       return tr;
     }
 
-    LocksTableFormater( bool withSolvables, bool withMatches )
+    /** \a evaluator_r must be given if matches or solvables are shown. */
+    LocksTableFormater( bool withSolvables, bool withMatches, const locks::LockEvaluator * evaluator_r = nullptr )
     : _withSolvables( withSolvables )
     , _withMatches( _withSolvables || withMatches )
+    , _evaluator( evaluator_r )
     {}
 
   private:
@@ -236,15 +241,16 @@ namespace out
       return ret;
     }
 
-    static void getLockDetails( const PoolQuery & q_r, MatchDetails & i_r, MatchDetails & a_r )
-    { for ( const auto & solv : q_r ) { (solv.isSystem()?i_r:a_r).insert( solv ); } }
+    static void getLockDetails( const std::vector<sat::Solvable> & m_r, MatchDetails & i_r, MatchDetails & a_r )
+    { for ( const auto & solv : m_r ) { (solv.isSystem()?i_r:a_r).insert( solv ); } }
 
-    static void getLockDetails( const PoolQuery & q_r, MatchDetails & d_r )
-    { getLockDetails( q_r, d_r, d_r ); }
+    static void getLockDetails( const std::vector<sat::Solvable> & m_r, MatchDetails & d_r )
+    { getLockDetails( m_r, d_r, d_r ); }
 
   private:
     bool _withSolvables	:1;	//< include match details (implies _withMatches)
     bool _withMatches	:1;	//< include number of matches
+    const locks::LockEvaluator * _evaluator;	//< the locks matches
     mutable unsigned _i = 0;	//< Lock Number
   };
 } // namespace out
@@ -302,11 +308,16 @@ int ListLocksCmd::execute(Zypper &zypper, const std::vector<std::string> &positi
     return ZYPPER_EXIT_ERR_ZYPP;
   }
 
+  // evaluate all locks in one pass over the pool
+  std::unique_ptr<locks::LockEvaluator> evaluator;
+  if ( _matches || _solvables )
+    evaluator.reset( new locks::LockEvaluator( locks ) );
+
   // show result
   Out & out( zypper.out() );
   out.gap();
   out.table( "locks", locks.empty() ? _("There are no package locks defined.") : "",
-             locks, out::LocksTableFormater( _solvables, _matches ) );
+             locks, out::LocksTableFormater( _solvables, _matches, evaluator.get() ) );
   out.gap();
 
   return 0;
@@ -69,6 +69,11 @@ void PatchCmd::doReset()
   _details = false;
 }
 
+bool PatchCmd::jsonOutput() const
+{
+  return true;
+}
+
 int PatchCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   // too many arguments
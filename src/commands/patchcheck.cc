@@ -8,6 +8,7 @@
 #include "commonflags.h"
 #include "utils/flags/flagtypes.h"
 #include "utils/messages.h"
+#include "utils/ResultCache.h"
 #include "src/update.h"
 
 PatchCheckCmd::PatchCheckCmd( std::vector<std::string> &&commandAliases_r ) :
@@ -51,13 +52,16 @@ int PatchCheckCmd::execute( Zypper &zypper, const std::vector<std::string> &posi
   if ( code != ZYPPER_EXIT_OK )
     return code;
 
-  // TODO calc token?
+  // unchanged system: answer without loading the pool
+  ResultCache cache( zypper, "patch-check", _updateStackOnly ? "updatestack-only" : "" );
+  if ( cache.replay() )
+    return zypper.exitCode();
 
   // now load resolvables:
   code = defaultSystemSetup( zypper, LoadResolvables | Resolve );
   if ( code != ZYPPER_EXIT_OK )
     return code;
 
-  patch_check( _updateStackOnly );
+  cache.record( [&]() { patch_check( _updateStackOnly ); } );
   return zypper.exitCode();
 }
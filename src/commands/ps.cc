@@ -15,6 +15,7 @@
 #include "Zypper.h"
 #include "Table.h"
 #include "utils/messages.h"
+#include "utils/DeletedFilesScanner.h"
 #include "utils/flags/flagtypes.h"
 #include "commands/needs-rebooting.h"
 
@@ -61,25 +62,29 @@ void PSCommand::doReset()
   _format.clear();
 }
 
-inline void loadData( CheckAccessDeleted & checker_r )
+/** Scan /proc ourselves unless debug output of CheckAccessDeleted is requested. */
+inline std::vector<CheckAccessDeleted::ProcInfo> loadData( const std::string & debugFile_r = std::string() )
 {
+  CheckAccessDeleted checker( false );	// wait for explicit call to check()
   try
   {
-    checker_r.check();
+    if ( debugFile_r.empty() )
+      return DeletedFilesScanner().scan();
+
+    checker.setDebugOutputFile( debugFile_r );
+    checker.check();
   }
   catch ( const Exception & ex )
   {
     throw( Out::Error( ZYPPER_EXIT_ERR_ZYPP, _("Check failed:"), ex ) );
   }
+  return std::vector<CheckAccessDeleted::ProcInfo>( checker.begin(), checker.end() );
 }
 
 void PSCommand::printServiceNamesOnly()
 {
-  CheckAccessDeleted checker( false );	// wait for explicit call to check()
-  loadData( checker );
-
   std::set<std::string> services;
-  for ( const auto & procInfo : checker )
+  for ( const auto & procInfo : loadData() )
   {
     std::string service( procInfo.service() );
     if ( ! service.empty() )
@@ -125,12 +130,7 @@ int PSCommand::execute( Zypper &zypper, const std::vector<std::string> &position
 
   // Here: Table output
   zypper.out().info(_("Checking for running processes using deleted libraries..."), Out::HIGH );
-  CheckAccessDeleted checker( false );	// wait for explicit call to check()
-
-  if(debugEnabled())
-    checker.setDebugOutputFile(_debugFile);
-
-  loadData( checker );
+  std::vector<CheckAccessDeleted::ProcInfo> procs { loadData( debugEnabled() ? _debugFile : std::string() ) };
 
   Table t;
   bool tableWithFiles = tableWithFilesEnabled();
@@ -158,7 +158,7 @@ int PSCommand::execute( Zypper &zypper, const std::vector<std::string> &position
     t << std::move(th);
   }
 
-  for ( const auto & procInfo : checker )
+  for ( const auto & procInfo : procs )
   {
     std::string service( procInfo.service() );
     if ( ! tableWithNonServiceProcs && service.empty() )
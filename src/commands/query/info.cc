@@ -98,6 +98,11 @@ void InfoCmd::doReset()
   _options = PrintInfoOptions();
 }
 
+bool InfoCmd::jsonOutput() const
+{
+  return true;
+}
+
 int InfoCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   if ( positionalArgs_r.size() < 1 )
@@ -71,6 +71,11 @@ void PackagesCmdBase::doReset()
   _flags = ListPackagesBits::Default;
 }
 
+bool PackagesCmdBase::jsonOutput() const
+{
+  return true;
+}
+
 int PackagesCmdBase::execute( Zypper &zypper, const std::vector<std::string> & )
 {
   ListPackagesFlags  flags = _flags;
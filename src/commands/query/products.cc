@@ -43,9 +43,14 @@ void ProductsCmdBase::doReset()
   _xmlFwdTags.clear();
 }
 
+bool ProductsCmdBase::jsonOutput() const
+{
+  return true;
+}
+
 int ProductsCmdBase::execute( Zypper &zypper, const std::vector<std::string> & )
 {
-  if ( _xmlFwdTags.size() && zypper.out().type() != Out::TYPE_XML )
+  if ( _xmlFwdTags.size() && ! zypper.out().typeXML() )
   {
     zypper.out().warning( str::Format(_("Option %1% has no effect without the %2% global option.")) % "--xmlfwd" % "--xmlout" );
   }
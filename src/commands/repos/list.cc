@@ -19,6 +19,13 @@ void print_repos_to( const std::list<RepoInfo> & repos, std::ostream & out )
     it->dumpAsIniOn( out ) << endl;
 }
 
+/** Repo list as JSON records */
+void print_json_repo_list( const std::list<RepoInfo> & repos )
+{
+  for ( const RepoInfo & repo : repos )
+    OutJSON::writeRecord( cout, repoJSONRecord( repo ) );
+}
+
 /** Repo list as xml */
 void print_xml_repo_list( Zypper & zypper, std::list<RepoInfo> repos )
 {
@@ -97,6 +104,11 @@ void ListReposCmd::doReset()
   _exportFile.clear();
 }
 
+bool ListReposCmd::jsonOutput() const
+{
+  return true;
+}
+
 int ListReposCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   checkIfToRefreshPluginServices( zypper );
@@ -157,6 +169,9 @@ int ListReposCmd::execute( Zypper &zypper, const std::vector<std::string> &posit
       }
     }
   }
+  // print repo list as JSON records
+  else if ( typeJSON( zypper.out() ) )
+    print_json_repo_list( repos );
   // print repo list as xml
   else if ( zypper.out().type() == Out::TYPE_XML )
     print_xml_repo_list( zypper, repos );
@@ -23,6 +23,7 @@ public:
 protected:
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  bool jsonOutput() const override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
   void printRepoList(Zypper &zypper, const std::list<zypp::RepoInfo> &repos);
 
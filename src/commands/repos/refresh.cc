@@ -74,6 +74,11 @@ zypp::ZyppFlags::CommandGroup RefreshRepoCmd::cmdOptions() const
             _("Refresh only specified repositories.")
       }
       ,
+      {"parallel", '\0', ZyppFlags::RequiredArgument,
+            ZyppFlags::IntType( &that->_jobs ),
+            // translators: --parallel <INTEGER>
+            _("Check and download the metadata and build the caches of up to this number of repositories in parallel.")
+      },
       {"services", 's', ZyppFlags::NoArgument,
             ZyppFlags::BoolType( &that->_services, ZyppFlags::StoreTrue, _services ),
             // translators: -s, --services
@@ -87,6 +92,7 @@ void RefreshRepoCmd::doReset()
   _flags = Default;
   _repos.clear();
   _services = false;
+  _jobs = 0;
 }
 
 int RefreshRepoCmd::execute( Zypper &zypper , const std::vector<std::string> &positionalArgs_r )
@@ -94,6 +100,12 @@ int RefreshRepoCmd::execute( Zypper &zypper , const std::vector<std::string> &po
   if ( zypper.config().no_refresh )
     zypper.out().warning( str::Format(_("The '%s' global option has no effect here.")) % "--no-refresh" );
 
+  if ( _jobs < 0 )
+  {
+    zypper.out().error( str::Format(_("Invalid value '%1%' of the %2% option.")) % _jobs % "--parallel" );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
   bool force = _flags.testFlag(Force);
 
   if ( _services )
@@ -139,7 +151,7 @@ int RefreshRepoCmd::execute( Zypper &zypper , const std::vector<std::string> &po
   for ( const std::string &repoFromCLI : positionalArgs_r )
     specifiedRepos.push_back(repoFromCLI);
 
-  return refreshRepositories ( zypper, _flags, specifiedRepos );
+  return refreshRepositories ( zypper, _flags, specifiedRepos, _jobs );
 }
 
 bool RefreshRepoCmd::refreshRepository(Zypper &zypper, const RepoInfo &repo, RefreshFlags flags_r)
@@ -166,7 +178,7 @@ bool RefreshRepoCmd::refreshRepository(Zypper &zypper, const RepoInfo &repo, Ref
   return error;
 }
 
-int RefreshRepoCmd::refreshRepositories( Zypper &zypper, RefreshFlags flags_r, const std::vector<std::string> repos_r )
+int RefreshRepoCmd::refreshRepositories( Zypper &zypper, RefreshFlags flags_r, const std::vector<std::string> repos_r, unsigned jobs_r )
 {
   RepoManager & manager( zypper.repoManager() );
   const std::list<RepoInfo> & repos( manager.knownRepositories() );
@@ -202,6 +214,22 @@ int RefreshRepoCmd::refreshRepositories( Zypper &zypper, RefreshFlags flags_r, c
 
   if ( !specified.empty() || not_found.empty() )
   {
+    // Enabled repos (to be refreshed) may download their metadata and
+    // build their caches in parallel. Results are reported in order by
+    // refreshRepository below.
+    std::list<RepoInfo> toRefresh;
+    for ( const RepoInfo & repo : repos )
+    {
+      if ( repo.enabled()
+           && ( specified.empty() || std::find( specified.begin(), specified.end(), repo ) != specified.end() || plusContent.count( repo ) ) )
+        toRefresh.push_back( repo );
+    }
+    unsigned jobs = jobs_r ? jobs_r : zypper.config().refresh_jobs;
+    if ( !flags_r.testFlag(BuildOnly) )
+      prefetch_raw_metadata( zypper, toRefresh, flags_r.testFlag(Force) || flags_r.testFlag(ForceDownload), jobs );
+    if ( !flags_r.testFlag(DownloadOnly) )
+      prebuild_caches( zypper, toRefresh, flags_r.testFlag(Force) || flags_r.testFlag(ForceBuild), jobs );
+
     for_( rit, repos.begin(), repos.end() )
     {
       const RepoInfo & repo( *rit );
@@ -267,6 +295,8 @@ int RefreshRepoCmd::refreshRepositories( Zypper &zypper, RefreshFlags flags_r, c
   }
   else
     enabled_repo_count = 0;
+  zypper.runtimeData().prefetched_raw_metadata.clear();
+  zypper.runtimeData().prebuilt_caches.clear();
 
   // print the result message
   if ( !not_found.empty() )
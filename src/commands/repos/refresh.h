@@ -27,7 +27,8 @@ public:
 
   RefreshRepoCmd( std::vector<std::string> &&commandAliases_r );
 
-  static int refreshRepositories ( Zypper &zypper, RefreshFlags flags_r = Default, const std::vector<std::string> repos_r = std::vector<std::string>() );
+  /** \a jobs_r: max. number of repos to download in parallel (0: zypper.conf default) */
+  static int refreshRepositories ( Zypper &zypper, RefreshFlags flags_r = Default, const std::vector<std::string> repos_r = std::vector<std::string>(), unsigned jobs_r = 0 );
 
   /** \return false on success, true on error */
   static bool refreshRepository  ( Zypper & zypper, const zypp::RepoInfo & repo, RefreshFlags flags_r = Default );
@@ -44,6 +45,7 @@ private:
   RefreshFlags _flags;
   std::vector<std::string> _repos;
   bool _services = false;
+  int _jobs = 0;
 };
 ZYPP_DECLARE_OPERATORS_FOR_FLAGS(RefreshRepoCmd::RefreshFlags);
 
@@ -5,12 +5,15 @@
 #include "commands/commonflags.h"
 #include "commands/commandhelpformatter.h"
 #include "commands/search/search-packages-hinthack.h"
+#include "utils/SearchIndex.h"
 
 #include <zypp/base/Algorithm.h>
 #include <zypp/sat/Solvable.h>
 #include <zypp/Capability.h>
 #include <zypp/PoolQueryResult.h>
 
+#include <algorithm>
+#include <optional>
 #include <unordered_map>
 
 namespace zypp
@@ -50,6 +53,127 @@ namespace
     }
     return false;
   }
+
+  /** Sort \a solvables_r like the detailed search result table, without
+   * building the rows (--stream). Just the sort keys are kept in memory.
+   */
+  void sortForStream( std::vector<sat::Solvable> & solvables_r, bool byRepo_r )
+  {
+    struct Key
+    {
+      std::string _repo;
+      std::string _name;
+      ui::Selectable::picklist_size_type _picklistPos;
+      sat::Solvable::IdType _id;
+    };
+    std::vector<Key> keys;
+    keys.reserve( solvables_r.size() );
+    for ( const auto & slv : solvables_r )
+    {
+      PoolItem pi { slv };
+      ui::Selectable::Ptr sel { ui::Selectable::get( pi ) };
+      keys.push_back( {
+        byRepo_r ? ( slv.isSystem() ? (std::string("(") + _("System Packages") + ")") : slv.repository().asUserString() ) : std::string(),
+        slv.name(),
+        sel ? sel->picklistPos( pi ) : ui::Selectable::picklistNoPos,
+        slv.id()
+      } );
+    }
+
+    std::vector<unsigned> order( keys.size() );
+    for ( unsigned i = 0; i < order.size(); ++i )
+      order[i] = i;
+    std::sort( order.begin(), order.end(), [&keys]( unsigned lhs, unsigned rhs ) {
+      const Key & l { keys[lhs] };
+      const Key & r { keys[rhs] };
+      if ( int diff = l._repo.compare( r._repo ) )
+        return diff < 0;
+      if ( int diff = str::compareCI( l._name, r._name ) )
+        return diff < 0;
+      if ( l._picklistPos != r._picklistPos )
+        return l._picklistPos < r._picklistPos;
+      return l._id < r._id;
+    } );
+
+    std::vector<sat::Solvable> sorted;
+    sorted.reserve( order.size() );
+    for ( unsigned idx : order )
+      sorted.push_back( solvables_r[idx] );
+    solvables_r.swap( sorted );
+  }
+
+  /** Substring search in names (and descriptions) using the repos SearchIndex.
+   * The system repo and repos without an up to date index are searched by
+   * \a query_r restricted to them.
+   */
+  std::vector<sat::Solvable> indexedSearch( const PoolQuery & query_r,
+                                            const std::vector<std::string> & strings_r,
+                                            const std::vector<std::string> & repoFilter_r,
+                                            const std::vector<std::pair<std::string,Edition>> & exactNameEditions_r,
+                                            const std::set<ResKind> & kinds_r,
+                                            bool text_r, bool caseSensitive_r, bool uninstalledOnly_r )
+  {
+    std::vector<sat::Solvable> ret;
+    PoolQuery fallback( query_r );
+    bool useFallback = false;
+    std::set<std::string> filter( repoFilter_r.begin(), repoFilter_r.end() );
+
+    auto wanted = [&kinds_r]( const sat::Solvable & slv_r ) {
+      return kinds_r.empty() || kinds_r.count( slv_r.kind() );
+    };
+
+    for_( it, sat::Pool::instance().reposBegin(), sat::Pool::instance().reposEnd() )
+    {
+      Repository repo( *it );
+      if ( !filter.empty() && !filter.count( repo.alias() ) )
+        continue;
+      if ( repo.isSystemRepo() && uninstalledOnly_r )
+        continue;
+
+      SearchIndex index( repo );
+      if ( repo.isSystemRepo() || !index )
+      {
+        fallback.addRepo( repo.alias() );
+        useFallback = true;
+        continue;
+      }
+
+      for ( const std::string & str : strings_r )
+      {
+        for ( const sat::Solvable & slv : index.candidates( str, text_r ) )
+        {
+          if ( wanted( slv ) && SearchIndex::matches( slv, str, text_r, caseSensitive_r ) )
+            ret.push_back( slv );
+        }
+      }
+      for ( const auto & el : exactNameEditions_r )
+      {
+        for ( const auto & pi : ResPool::instance().byName( el.first ) )
+        {
+          if ( pi.satSolvable().repository() == repo && wanted( pi.satSolvable() ) && Edition::match( pi.edition(), el.second ) == 0 )
+            ret.push_back( pi.satSolvable() );
+        }
+      }
+    }
+    MIL << "Search index: " << ret.size() << " matches" << ( useFallback ? " + PoolQuery" : "" ) << endl;
+
+    if ( useFallback )
+    {
+      for ( const auto & slv : fallback )
+        ret.push_back( slv );
+    }
+    std::sort( ret.begin(), ret.end() );
+    ret.erase( std::unique( ret.begin(), ret.end() ), ret.end() );
+    return ret;
+  }
+
+  /** Sort \a selectables_r like the search result table (by name, --stream). */
+  void sortForStream( std::vector<ui::Selectable::constPtr> & selectables_r )
+  {
+    std::sort( selectables_r.begin(), selectables_r.end(), []( const ui::Selectable::constPtr & lhs, const ui::Selectable::constPtr & rhs ) {
+      return str::compareCI( lhs->name(), rhs->name() ) < 0;
+    } );
+  }
 }
 
 
@@ -195,6 +319,10 @@ zypp::ZyppFlags::CommandGroup SearchCmd::cmdOptions() const
       {"verbose", 'v', ZyppFlags::NoArgument, ZyppFlags::BoolType( &that._verbose, ZyppFlags::StoreTrue, _caseSensitive ),
         // translators: -v, --verbose
         _("Like --details, with additional information where the search has matched (useful for search in dependencies).")
+      },
+      {"stream", '\0', ZyppFlags::NoArgument, ZyppFlags::BoolType( &that._stream, ZyppFlags::StoreTrue, _stream ),
+        // translators: --stream
+        _("Write each match as soon as it is found, one per line, instead of a table. The result is not sorted unless --sort-by-name or --sort-by-repo is used.")
       }
     },
     {
@@ -219,10 +347,16 @@ void SearchCmd::doReset()
   _caseSensitive = false;
   _details = false;
   _verbose = false;
+  _stream = false;
   _requestedDeps.clear();
   _requestedTypes.clear();
 }
 
+bool SearchCmd::jsonOutput() const
+{
+  return true;
+}
+
 int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   // check args...
@@ -278,13 +412,14 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
 
   // build query...
 
-  // add available repos to query
+  // add available repos to query (below, unless the search index is used)
+  std::vector<std::string> repoFilter;
   if ( InitRepoSettings::instance()._repoFilter.size() )
   {
     auto &rData = zypper.runtimeData();
     for_(repo_it, rData.repos.begin(), rData.repos.end() )
     {
-      query.addRepo( repo_it->alias() );
+      repoFilter.push_back( repo_it->alias() );
       if ( !repo_it->enabled() )
       {
         zypper.out().warning( str::Format(_("Specified repository '%s' is disabled.")) % repo_it->asUserString() );
@@ -297,12 +432,28 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
     _requestedDeps.insert( sat::SolvAttr::name );
 
   bool details = _details || _verbose;
+
+  // Plain substring searches in names (and descriptions) may use the search index.
+  bool useIndex = SearchIndex::enabled()
+                  && !_requestedReverseSearch.is_initialized()
+                  && !_verbose	// needs the PoolQuery match details
+                  && ( _mode == MatchMode::Default || _mode == MatchMode::Substrings )
+                  && _requestedDeps.size() == 1 && _requestedDeps.count( sat::SolvAttr::name )
+                  && !positionalArgs_r.empty();
+  std::vector<std::pair<std::string,Edition>> exactNameEditions;	// "N-V" and "N-V-R" cases
+
   // add argument strings and attributes to query
   for_( it, positionalArgs_r.begin(), positionalArgs_r.end() )
   {
     Capability cap( *it );
     std::string name = cap.detail().name().asString();
 
+    if ( useIndex && ( name != *it || cap.detail().isVersioned()
+                       || name.size() < SearchIndex::minStringSize
+                       || name.find_first_of( "?*" ) != std::string::npos
+                       || ( *name.begin() == '/' && *name.rbegin() == '/' ) ) )
+      useIndex = false;
+
     // bsc#1119873 zypper search: inconsistent results for `-t package kernel-default` vs `package:kernel-default`
     // Capability parser strips 'package:' prefix from name, because ident for package and srcpackage does not contain
     // the prefix but instead is only differentiated by arch.
@@ -362,6 +513,7 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
             std::string r( name.substr(pos+1) );
             Edition e( r );
             query.addDependency( sat::SolvAttr::name, n, Rel::EQ, e, Arch(cap.detail().arch()), Match::STRING );
+            exactNameEditions.push_back( { n, e } );
             if ( poolExpectMatchFor( n, e ) )
               details = true;	// show details if any search string includes an edition
 
@@ -371,6 +523,7 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
               n = name.substr(0,pos2);
               e = Edition( name.substr(pos2+1,pos-pos2-1), r );
               query.addDependency( sat::SolvAttr::name, n, Rel::EQ, e, Arch(cap.detail().arch()), Match::STRING );
+              exactNameEditions.push_back( { n, e } );
               if ( poolExpectMatchFor( n, e ) )
                 details = true;	// show details if any search string includes an edition
             }
@@ -386,7 +539,30 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
     }
   }
 
-  Table t;
+  std::optional<std::vector<sat::Solvable>> indexed;
+  if ( useIndex )
+  {
+    indexed = indexedSearch( query, positionalArgs_r, repoFilter, exactNameEditions, _requestedTypes,
+                             _searchDesc, _caseSensitive,
+                             _notInstalledOpts._mode == SolvableFilterMode::ShowOnlyNotInstalled || zypper.config().disable_system_resolvables );
+  }
+  else
+  {
+    for ( const std::string & alias : repoFilter )
+      query.addRepo( alias );
+  }
+
+  SolvableTable t;
+  // --stream: write the rows as they are found, the table is just a buffer.
+  std::optional<SearchResultStream> stream;
+  if ( _stream )
+    stream.emplace( zypper.out() );
+  const bool sortStream = _stream && _sortOpts._mode != SortResultOptionSet::Default;
+  auto emit = [&]( const std::vector<std::string> & lastRowDetails_r = std::vector<std::string>() ) {
+    if ( stream )
+      stream->flush( t, lastRowDetails_r );
+  };
+
   try
   {
     if ( _requestedReverseSearch.is_initialized() ) {
@@ -418,21 +594,80 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
 
       if ( details ) {
         FillSearchTableSolvable callback( t, inst_notinst );
-        std::for_each( matchedSolvables.begin(), matchedSolvables.end(), [&callback, verb = _verbose, &reqSearchAttrib ]( auto elem ){
-          if ( verb )
-            callback( elem.first, reqSearchAttrib, elem.second );
-          else
-            callback( elem.first, reqSearchAttrib, {} );
-        } );
+        auto fill = [&]( const sat::Solvable & slv, const CapabilitySet & matched ) {
+          if ( _verbose ) {
+            if ( callback( slv, reqSearchAttrib, matched ) && stream && ! sortStream )
+              emit( FillSearchTableSolvable::matchDetails( slv, reqSearchAttrib, matched ) );
+          }
+          else {
+            callback( slv, reqSearchAttrib, {} );
+            emit();
+          }
+        };
+        if ( sortStream ) {
+          std::vector<sat::Solvable> solvables;
+          solvables.reserve( matchedSolvables.size() );
+          for ( const auto & el : matchedSolvables )
+            solvables.push_back( el.first );
+          sortForStream( solvables, _sortOpts._mode == SortResultOptionSet::ByRepo );
+          for ( const auto & slv : solvables )
+            fill( slv, matchedSolvables[slv] );
+        }
+        else {
+          for ( const auto & el : matchedSolvables )
+            fill( el.first, el.second );
+        }
       } else {
 
         PoolQueryResult res;
         std::for_each( matchedSolvables.begin(), matchedSolvables.end(), [ &res ]( const auto &v ){ res+=v.first; } );
 
         FillSearchTableSelectable callback( t, inst_notinst );
-        std::for_each( res.selectableBegin(), res.selectableEnd(), callback);
+        if ( sortStream ) {
+          std::vector<ui::Selectable::constPtr> selectables( res.selectableBegin(), res.selectableEnd() );
+          sortForStream( selectables );
+          for ( const auto & sel : selectables ) {
+            callback( sel );
+            emit();
+          }
+        }
+        else {
+          for_( it, res.selectableBegin(), res.selectableEnd() ) {
+            callback( *it );
+            emit();
+          }
+        }
+      }
+
+    } else if ( indexed ) {
+      // matches found via the search index
+      if ( details )
+      {
+        FillSearchTableSolvable callback( t, inst_notinst );
+        if ( sortStream )
+          sortForStream( *indexed, _sortOpts._mode == SortResultOptionSet::ByRepo );
+        for ( const auto & slv : *indexed )
+        {
+          callback( slv );
+          emit();
+        }
       }
+      else
+      {
+        PoolQueryResult res;
+        for ( const auto & slv : *indexed )
+          res += slv;
 
+        FillSearchTableSelectable callback( t, inst_notinst );
+        std::vector<ui::Selectable::constPtr> selectables( res.selectableBegin(), res.selectableEnd() );
+        if ( sortStream )
+          sortForStream( selectables );
+        for ( const auto & sel : selectables )
+        {
+          callback( sel );
+          emit();
+        }
+      }
     } else {
       if ( details )
       {
@@ -441,23 +676,81 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
         {
           // Option 'verbose' shows where (e.g. in 'requires', 'name') the search has matched.
           // Info is available from PoolQuery::const_iterator.
+          // (--stream: can't be sorted without keeping the rows)
           for_( it, query.begin(), query.end() )
-            callback( it );
+          {
+            if ( callback( it ) && stream && ! sortStream )
+              emit( FillSearchTableSolvable::matchDetails( it ) );
+          }
+        }
+        else if ( sortStream )
+        {
+          std::vector<sat::Solvable> solvables( query.begin(), query.end() );
+          sortForStream( solvables, _sortOpts._mode == SortResultOptionSet::ByRepo );
+          for ( const auto & slv : solvables )
+          {
+            callback( slv );
+            emit();
+          }
         }
         else
         {
           for ( const auto slv : query )
+          {
             callback( slv );
+            emit();
+          }
         }
       }
       else
       {
         FillSearchTableSelectable callback( t, inst_notinst );
-        invokeOnEach( query.selectableBegin(), query.selectableEnd(), callback );
+        if ( sortStream )
+        {
+          std::vector<ui::Selectable::constPtr> selectables( query.selectableBegin(), query.selectableEnd() );
+          sortForStream( selectables );
+          for ( const auto & sel : selectables )
+          {
+            callback( sel );
+            emit();
+          }
+        }
+        else if ( stream )
+        {
+          for_( it, query.selectableBegin(), query.selectableEnd() )
+          {
+            callback( *it );
+            emit();
+          }
+        }
+        else
+          invokeOnEach( query.selectableBegin(), query.selectableEnd(), callback );
       }
     }
 
-    if ( t.empty() )
+    if ( stream && _verbose && sortStream && ! t.empty() )
+    {
+      // --verbose --stream with sorting: the buffered rows are sorted as usual
+      if ( _sortOpts._mode == SortResultOptionSet::ByRepo )
+        t.sort( { SolvableTable::Repository, SolvableTable::Name } );
+      else
+        t.sort( { SolvableTable::Name } );
+      printSearchResult( zypper.out(), t );
+      stream->finish();
+    }
+    else if ( stream )
+    {
+      stream->finish();
+      if ( stream->empty() )
+      {
+        // translators: empty search result message
+        zypper.out().info(_("No matching items found."), Out::QUIET );
+        if ( !zypper.config().ignore_unknown ) {
+          zypper.setExitInfoCode( ZYPPER_EXIT_INF_CAP_NOT_FOUND );
+        }
+      }
+    }
+    else if ( t.empty() )
     {
       // translators: empty search result message
       zypper.out().info(_("No matching items found."), Out::QUIET );
@@ -469,23 +762,24 @@ int SearchCmd::execute( Zypper &zypper, const std::vector<std::string> &position
     {
       cout << endl; //! \todo  out().separator()?
 
+      // sorted on the compact rows, the strings are built row by row just for output
+      unsigned abbrevColumn = unsigned(-1);
       if ( _details )
       {
         if ( _sortOpts._mode == SortResultOptionSet::ByRepo )
-          t.sort( { 5, 1, Table::UserData } );
+          t.sort( { SolvableTable::Repository, SolvableTable::Name } );
         else
-          t.sort( { 1, Table::UserData } ); // sort by name
+          t.sort( { SolvableTable::Name } ); // sort by name
       }
       else
       {
         // sort by name (can't sort by repo)
-        t.sort( 1 );
+        t.sort( { SolvableTable::Name } );
         if ( !zypper.config().no_abbrev )
-          t.allowAbbrev( 2 );
+          abbrevColumn = 2;
       }
 
-      //cout << t; //! \todo out().table()?
-      zypper.out().searchResult( t );
+      printSearchResult( zypper.out(), t, abbrevColumn );
     }
 
     if ( !_requestedReverseSearch.is_initialized() )
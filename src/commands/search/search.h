@@ -38,6 +38,7 @@ private:
   bool _caseSensitive = false;
   bool _details = false;
   bool _verbose = false;
+  bool _stream = false;
   std::set<zypp::sat::SolvAttr> _requestedDeps;
   boost::optional<zypp::sat::SolvAttr> _requestedReverseSearch;
 
@@ -52,6 +53,7 @@ private:
 protected:
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  bool jsonOutput() const override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
 
   // ZypperBaseCommand interface
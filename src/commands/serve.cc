@@ -0,0 +1,366 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#include "serve.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <signal.h>
+#include <unistd.h>
+
+#include <zypp/base/String.h>
+#include <zypp/Pathname.h>
+
+#include "Zypper.h"
+#include "Command.h"
+#include "output/OutJSON.h"
+#include "utils/messages.h"
+#include "utils/flags/flagtypes.h"
+
+using namespace zypp;
+
+namespace
+{
+  const char * defaultSocket = "/run/zypper-serve.sock";
+}
+
+ServeCmd::ServeCmd( std::vector<std::string> &&commandAliases_r ) :
+  ZypperBaseCommand (
+    std::move( commandAliases_r ),
+    // translators: command synopsis; do not translate lowercase words
+    _("serve [OPTIONS]"),
+    // translators: command summary: serve
+    _("Serve querying commands on a local socket."),
+    // translators: command description
+    _("Load the system and repository data once and answer querying commands (search, info, list-updates, ...) sent by clients over a local socket. Each request is a line containing a JSON object like '{\"id\": 1, \"args\": [\"search\", \"vim\"]}', each response a line containing a JSON object with the exit code and the output of the command."),
+    DisableAll
+  )
+{ }
+
+zypp::ZyppFlags::CommandGroup ServeCmd::cmdOptions() const
+{
+  auto that = const_cast<ServeCmd *>(this);
+  return {{
+    { "socket", '\0', ZyppFlags::RequiredArgument, ZyppFlags::StringType( &that->_socket, boost::optional<const char *>(), "PATH" ),
+      // translators: --socket <PATH>
+      str::Format(_("The UNIX socket to listen on. Default: %1%")) % defaultSocket
+    }
+  }};
+}
+
+void ServeCmd::doReset()
+{
+  _socket = defaultSocket;
+}
+
+int ServeCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
+{
+  if ( !positionalArgs_r.empty() )
+  {
+    report_too_many_arguments( help() );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
+  if ( zypper.runningShell() )
+  {
+    zypper.out().error(_("The server can not be started from within the shell.") );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
+  zypper.commandServer( _socket );
+  return zypper.exitCode();
+}
+
+namespace serve
+{
+  namespace
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// Just enough JSON to parse the request objects.
+    class RequestParser
+    {
+    public:
+      RequestParser( const std::string & line_r )
+      : _str { line_r }
+      {}
+
+      Request parse()
+      {
+        Request ret;
+        expect( '{' );
+        if ( ! consume( '}' ) )
+        {
+          do {
+            std::string key { parseString() };
+            expect( ':' );
+            if ( key == "id" )
+              ret.id = parseId();
+            else if ( key == "args" )
+              ret.args = parseStringArray();
+            else
+              skipValue();	// unknown keys are ignored
+          } while ( consume( ',' ) );
+          expect( '}' );
+        }
+        skipWs();
+        if ( _pos != _str.size() )
+          fail( "trailing characters" );
+        return ret;
+      }
+
+    private:
+      [[noreturn]] void fail( const std::string & what_r ) const
+      { ZYPP_THROW( Exception( str::Format(_("Invalid request at offset %1%: %2%")) % _pos % what_r ) ); }
+
+      void skipWs()
+      {
+        while ( _pos < _str.size() && ::strchr( " \t\r\n", _str[_pos] ) )
+          ++_pos;
+      }
+
+      char peek()
+      {
+        skipWs();
+        return _pos < _str.size() ? _str[_pos] : '\0';
+      }
+
+      bool consume( char ch_r )
+      {
+        if ( peek() != ch_r )
+          return false;
+        ++_pos;
+        return true;
+      }
+
+      void expect( char ch_r )
+      {
+        if ( ! consume( ch_r ) )
+          fail( std::string( "expected '" ) + ch_r + "'" );
+      }
+
+      /** Append the code point \a cp_r UTF-8 encoded. */
+      static void appendUtf8( std::string & str_r, unsigned cp_r )
+      {
+        if ( cp_r < 0x80 )
+          str_r += char(cp_r);
+        else if ( cp_r < 0x800 )
+        {
+          str_r += char( 0xC0 | ( cp_r >> 6 ) );
+          str_r += char( 0x80 | ( cp_r & 0x3F ) );
+        }
+        else if ( cp_r < 0x10000 )
+        {
+          str_r += char( 0xE0 | ( cp_r >> 12 ) );
+          str_r += char( 0x80 | ( ( cp_r >> 6 ) & 0x3F ) );
+          str_r += char( 0x80 | ( cp_r & 0x3F ) );
+        }
+        else
+        {
+          str_r += char( 0xF0 | ( cp_r >> 18 ) );
+          str_r += char( 0x80 | ( ( cp_r >> 12 ) & 0x3F ) );
+          str_r += char( 0x80 | ( ( cp_r >> 6 ) & 0x3F ) );
+          str_r += char( 0x80 | ( cp_r & 0x3F ) );
+        }
+      }
+
+      unsigned parseHex4()
+      {
+        if ( _pos + 4 > _str.size() )
+          fail( "incomplete \\u escape" );
+        unsigned ret = 0;
+        for ( unsigned i = 0; i < 4; ++i )
+        {
+          char ch = _str[_pos++];
+          ret <<= 4;
+          if ( ch >= '0' && ch <= '9' )
+            ret |= ch - '0';
+          else if ( ch >= 'a' && ch <= 'f' )
+            ret |= ch - 'a' + 10;
+          else if ( ch >= 'A' && ch <= 'F' )
+            ret |= ch - 'A' + 10;
+          else
+            fail( "invalid \\u escape" );
+        }
+        return ret;
+      }
+
+      std::string parseString()
+      {
+        expect( '"' );
+        std::string ret;
+        while ( true )
+        {
+          if ( _pos >= _str.size() )
+            fail( "unterminated string" );
+          char ch = _str[_pos++];
+          if ( ch == '"' )
+            break;
+          if ( ch != '\\' )
+          {
+            ret += ch;
+            continue;
+          }
+          if ( _pos >= _str.size() )
+            fail( "unterminated string" );
+          switch ( ch = _str[_pos++] )
+          {
+            case '"':
+            case '\\':
+            case '/': ret += ch;   break;
+            case 'b': ret += '\b'; break;
+            case 'f': ret += '\f'; break;
+            case 'n': ret += '\n'; break;
+            case 'r': ret += '\r'; break;
+            case 't': ret += '\t'; break;
+            case 'u':
+            {
+              unsigned cp = parseHex4();
+              if ( cp >= 0xD800 && cp < 0xDC00 && _str.compare( _pos, 2, "\\u" ) == 0 )
+              {
+                _pos += 2;
+                unsigned low = parseHex4();
+                if ( low < 0xDC00 || low > 0xDFFF )
+                  fail( "invalid surrogate pair" );
+                cp = 0x10000 + ( ( cp - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+              }
+              appendUtf8( ret, cp );
+              break;
+            }
+            default:
+              fail( "invalid escape" );
+          }
+        }
+        return ret;
+      }
+
+      /** A number or a string; returned as JSON text. */
+      std::string parseId()
+      {
+        if ( peek() == '"' )
+          return jsonString( parseString() );
+        std::string::size_type start = _pos;
+        while ( _pos < _str.size() && ::strchr( "0123456789+-.eE", _str[_pos] ) )
+          ++_pos;
+        if ( start == _pos )
+          fail( "id must be a number or a string" );
+        return _str.substr( start, _pos - start );
+      }
+
+      std::vector<std::string> parseStringArray()
+      {
+        std::vector<std::string> ret;
+        expect( '[' );
+        if ( ! consume( ']' ) )
+        {
+          do {
+            ret.push_back( parseString() );
+          } while ( consume( ',' ) );
+          expect( ']' );
+        }
+        return ret;
+      }
+
+      void skipValue()
+      {
+        switch ( peek() )
+        {
+          case '"':
+            parseString();
+            break;
+          case '[':
+            ++_pos;
+            if ( ! consume( ']' ) )
+            {
+              do { skipValue(); } while ( consume( ',' ) );
+              expect( ']' );
+            }
+            break;
+          case '{':
+            ++_pos;
+            if ( ! consume( '}' ) )
+            {
+              do { parseString(); expect( ':' ); skipValue(); } while ( consume( ',' ) );
+              expect( '}' );
+            }
+            break;
+          default:
+          {
+            std::string::size_type start = _pos;
+            while ( _pos < _str.size() && ( ::isalnum( (unsigned char)_str[_pos] ) || ::strchr( "+-.", _str[_pos] ) ) )
+              ++_pos;
+            if ( start == _pos )
+              fail( "invalid value" );
+          }
+        }
+      }
+
+    private:
+      const std::string & _str;
+      std::string::size_type _pos = 0;
+    };
+  } // namespace
+
+  Request parseRequest( const std::string & line_r )
+  { return RequestParser( line_r ).parse(); }
+
+  std::string jsonString( const std::string & str_r )
+  { return OutJSON::quote( str_r ); }
+
+  std::string response( const Request & request_r, int exitCode_r, const std::string & output_r, const std::string & errors_r )
+  {
+    return str::Str() << "{\"id\": " << request_r.id
+                      << ", \"exit\": " << exitCode_r
+                      << ", \"output\": " << jsonString( output_r )
+                      << ", \"errors\": " << jsonString( errors_r ) << "}";
+  }
+
+  bool isReadOnlyCommand( const ZypperCommand & command_r )
+  {
+    switch ( command_r.toEnum() )
+    {
+      case ZypperCommand::LIST_REPOS_e:
+      case ZypperCommand::LIST_SERVICES_e:
+      case ZypperCommand::LIST_UPDATES_e:
+      case ZypperCommand::LIST_PATCHES_e:
+      case ZypperCommand::PATCH_CHECK_e:
+      case ZypperCommand::SEARCH_e:
+      case ZypperCommand::INFO_e:
+      case ZypperCommand::RUG_PATCH_INFO_e:
+      case ZypperCommand::RUG_PATTERN_INFO_e:
+      case ZypperCommand::RUG_PRODUCT_INFO_e:
+      case ZypperCommand::PACKAGES_e:
+      case ZypperCommand::PATCHES_e:
+      case ZypperCommand::PATTERNS_e:
+      case ZypperCommand::PRODUCTS_e:
+      case ZypperCommand::WHAT_PROVIDES_e:
+      case ZypperCommand::LIST_LOCKS_e:
+      case ZypperCommand::LOCALES_e:
+      case ZypperCommand::TARGET_OS_e:
+      case ZypperCommand::VERSION_CMP_e:
+      case ZypperCommand::NEEDS_REBOOTING_e:
+      case ZypperCommand::HELP_e:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  pid_t zyppLockHolder()
+  {
+    const char * root = ::getenv( "ZYPP_LOCKFILE_ROOT" );
+    Pathname base { root ? root : "/" };
+    for ( const char * file : { "run/zypp.pid", "var/run/zypp.pid" } )
+    {
+      std::ifstream in( ( base / file ).c_str() );
+      pid_t pid = 0;
+      if ( in >> pid && pid > 0 && pid != ::getpid() && ( ::kill( pid, 0 ) == 0 || errno == EPERM ) )
+        return pid;
+    }
+    return 0;
+  }
+} // namespace serve
@@ -0,0 +1,76 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_COMMANDS_SERVE_INCLUDED
+#define ZYPPER_COMMANDS_SERVE_INCLUDED
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "commands/basecommand.h"
+#include "utils/flags/zyppflags.h"
+
+class ZypperCommand;
+
+class ServeCmd : public ZypperBaseCommand
+{
+public:
+  ServeCmd ( std::vector<std::string> &&commandAliases_r );
+
+  // ZypperBaseCommand interface
+protected:
+  zypp::ZyppFlags::CommandGroup cmdOptions() const override;
+  void doReset() override;
+  int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
+
+private:
+  std::string _socket;
+};
+
+///////////////////////////////////////////////////////////////////
+/// The 'zypper serve' protocol: One request per line, one response
+/// line per request, both JSON objects.
+/// \code
+///   {"id": 1, "args": ["search", "-s", "vim"]}
+///   {"id": 1, "exit": 0, "output": "...", "errors": ""}
+/// \endcode
+/// The optional \c id (a number or string) is passed back unchanged.
+/// Clients are served one at a time; a connection without a request for
+/// \ref serve::idleTimeout seconds is closed.
+/// \c output and \c errors are what the command wrote to stdout and
+/// stderr; XML if the server was started with the global \c --xmlout.
+///////////////////////////////////////////////////////////////////
+namespace serve
+{
+  /** Seconds a client may stay connected without sending a request. */
+  constexpr unsigned idleTimeout = 10;
+
+  struct Request
+  {
+    std::string id { "null" };		///< the id as JSON text
+    std::vector<std::string> args;	///< the command and its arguments
+  };
+
+  /** Parse a request line.
+   * \throws zypp::Exception if \a line_r is not a valid request.
+   */
+  Request parseRequest( const std::string & line_r );
+
+  /** The response line to \a request_r (without the trailing newline). */
+  std::string response( const Request & request_r, int exitCode_r, const std::string & output_r, const std::string & errors_r );
+
+  /** \a str_r as a quoted JSON string. */
+  std::string jsonString( const std::string & str_r );
+
+  /** Whether \a command_r just queries (and may be served). */
+  bool isReadOnlyCommand( const ZypperCommand & command_r );
+
+  /** The PID of the process holding the zypp lock (0 if unlocked). */
+  pid_t zyppLockHolder();
+} // namespace serve
+
+#endif
@@ -7,6 +7,8 @@
 
 #include "common.h"
 #include "repos.h"
+#include "utils/Profile.h"
+#include "utils/ServiceRefreshCache.h"
 
 #include <zypp/media/MediaException.h>
 
@@ -121,6 +123,7 @@ bool refresh_service(Zypper & zypper, const ServiceInfo & service, RepoManager::
 {
   MIL << "going to refresh service '" << service.alias() << "'" << endl;
   init_target( zypper );	// need targetDistribution for service refresh
+  Profile::Phase phase { "service refresh" };
   RepoManager & manager( zypper.repoManager() );
 
   bool error = true;
@@ -129,6 +132,14 @@ bool refresh_service(Zypper & zypper, const ServiceInfo & service, RepoManager::
     zypper.out().info( str::form(_("Refreshing service '%s'."), service.asUserString().c_str() ) );
     manager.refreshService( service, flags_r );
     error = false;
+
+    // remember it, so the next commands may skip it (zypper.conf: main.serviceRefreshTTL)
+    if ( zypper.config().service_refreshTTL )
+    {
+      ServiceRefreshCache cache( ServiceRefreshCache::defaultFile( zypper.config().rm_options.knownServicesPath ) );
+      cache.refreshed( manager.getService( service.alias() ) );
+      cache.save();
+    }
   }
   catch ( const repo::ServicePluginInformalException & e )
   {
@@ -158,6 +169,12 @@ void remove_service( Zypper & zypper, const ServiceInfo & service )
 
   zypper.out().info( str::Format(_("Removing service '%s':")) % service.asUserString() );
   manager.removeService( service );
+  if ( zypper.config().service_refreshTTL )
+  {
+    ServiceRefreshCache cache( ServiceRefreshCache::defaultFile( zypper.config().rm_options.knownServicesPath ) );
+    cache.forget( service.alias() );
+    cache.save();
+  }
   MIL << "Service '" << service.alias() << "' has been removed." << endl;
   zypper.out().info( str::Format(_("Service '%s' has been removed.")) % service.asUserString() );
 }
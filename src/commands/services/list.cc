@@ -228,6 +228,34 @@ void ListServicesCmd::printXMLServiceList( Zypper &zypper )
   cout << "</service-list>" << endl;
 }
 
+void ListServicesCmd::printJSONServiceList( Zypper &zypper )
+{
+  ServiceList services = get_all_services( zypper );
+
+  for_( it, services.begin(), services.end() )
+  {
+    ServiceInfo_Ptr s_ptr = dynamic_pointer_cast<ServiceInfo>(*it);
+    if ( ! s_ptr )
+    {
+      OutJSON::writeRecord( cout, repoJSONRecord( *dynamic_pointer_cast<RepoInfo>(*it) ) );
+      continue;
+    }
+
+    // the service's repos nested like in the XML <service> element
+    RepoCollector collector;
+    RepoManager & rm( zypper.repoManager() );
+    rm.getRepositoriesInService( (*it)->alias(),
+                                 make_function_output_iterator( bind( &RepoCollector::collect, &collector, _1 ) ) );
+    std::vector<OutJSON::Record> repos;
+    for_( repoit, collector.repos.begin(), collector.repos.end() )
+      repos.push_back( repoJSONRecord( *repoit ) );
+
+    OutJSON::Record record { serviceJSONRecord( *s_ptr ) };
+    record.add( "repos", repos );
+    OutJSON::writeRecord( cout, record );
+  }
+}
+
 ZyppFlags::CommandGroup ListServicesCmd::cmdOptions() const
 {
   return ZyppFlags::CommandGroup();
@@ -237,6 +265,11 @@ void ListServicesCmd::doReset()
 {
 }
 
+bool ListServicesCmd::jsonOutput() const
+{
+  return true;
+}
+
 int ListServicesCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   if ( _listOptions._flags.testFlag( RSCommonListOptions::ShowWithRepos) )
@@ -247,6 +280,11 @@ int ListServicesCmd::execute( Zypper &zypper, const std::vector<std::string> &po
     return ZYPPER_EXIT_OK;
   }
 
+  if ( typeJSON( zypper.out() ) ) {
+    printJSONServiceList( zypper );
+    return ZYPPER_EXIT_OK;
+  }
+
   printServiceList( zypper );
   return ZYPPER_EXIT_OK;
 }
@@ -21,11 +21,13 @@ public:
 private:
   void printServiceList    ( Zypper &zypper );
   void printXMLServiceList ( Zypper &zypper );
+  void printJSONServiceList( Zypper &zypper );
 
   // ZypperBaseCommand interface
 protected:
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  bool jsonOutput() const override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
 
 private:
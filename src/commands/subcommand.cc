@@ -8,13 +8,17 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <csignal>
 #include <cerrno>
 #include <cstring>
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <algorithm>
+#include <ctime>
 #include <set>
 #include <zypp/base/LogTools.h>
 #include <zypp/ExternalProgram.h>
@@ -22,7 +26,9 @@
 #include "Zypper.h"
 #include "Table.h"
 #include "subcommand.h"
+#include "utils/AtomicFile.h"
 #include "utils/messages.h"
+#include "utils/misc.h"
 #include "commands/commandhelpformatter.h"
 
 #include <boost/utility/string_ref.hpp>
@@ -133,9 +139,170 @@ namespace	// subcommand detetction
     return(  pi.isFile() && pi.userMayRX() );
   }
 
+  ///////////////////////////////////////////////////////////////////
+  /// \class SubcommandDirCache
+  /// \brief The 'zypper-*' entries per directory, cached in $XDG_CACHE_HOME.
+  ///
+  /// Scanning the execdir and all $PATH directories on every 'zypper help'
+  /// and every unknown command is slow on large (e.g. NFS mounted) PATHs.
+  /// The cache remembers the 'zypper-*' entries found in a directory together
+  /// with the directories device, inode and mtime. As long as they are
+  /// unchanged, a lookup costs just a stat of the directory. Adding, removing
+  /// or renaming an entry changes the mtime and triggers a rescan.
+  ///
+  /// The entries are not checked for being executable, so the callers still
+  /// check them with \ref canExecute (a stat per subcommand, not per file in
+  /// the directory). A 'chmod +x' is thus noticed as well.
+  ///////////////////////////////////////////////////////////////////
+  class SubcommandDirCache
+  {
+  public:
+    static SubcommandDirCache & instance()
+    {
+      static SubcommandDirCache _instance;
+      return _instance;
+    }
+
+    /** The sorted 'zypper-*' entries in \a dir_r (empty if \a dir_r can't be read). */
+    const std::vector<std::string> & entries( const Pathname & dir_r )
+    {
+      static const std::vector<std::string> noEntries;
+
+      struct stat st;
+      if ( ::stat( dir_r.c_str(), &st ) != 0 || ! S_ISDIR(st.st_mode) )
+        return noEntries;
+
+      Stamp stamp { st.st_dev, st.st_ino, st.st_mtim.tv_sec, st.st_mtim.tv_nsec };
+      Dir & dir { _dirs[dir_r.asString()] };
+      if ( dir._stamp == stamp && ! dir._racy )
+        return dir._entries;
+
+      // the stamp is taken before the scan: an entry added meanwhile will change it again
+      std::vector<std::string> entries;
+      int res = filesystem::dirForEach( dir_r, [&entries]( const Pathname &, const char * name_r )->bool {
+        if ( str::startsWith( name_r, "zypper-" ) )
+          entries.push_back( name_r );
+        return true;
+      } );
+      if ( res != 0 )
+      {
+        _dirs.erase( dir_r.asString() );
+        return noEntries;
+      }
+      std::sort( entries.begin(), entries.end() );
+      DBG << "Scanned " << dir_r << ": " << entries.size() << " zypper-* entries" << endl;
+
+      dir._stamp = stamp;
+      dir._entries.swap( entries );
+      // A change within the mtimes granularity would go unnoticed. Remember
+      // a directory changed just now only for this run.
+      dir._racy = ( stamp._sec >= ::time( nullptr ) - 1 );
+      _dirty = true;
+      return dir._entries;
+    }
+
+    /** Whether \a dir_r contains an entry \a name_r. */
+    bool contains( const Pathname & dir_r, const std::string & name_r )
+    {
+      const std::vector<std::string> & dirEntries { entries( dir_r ) };
+      return std::binary_search( dirEntries.begin(), dirEntries.end(), name_r );
+    }
+
+    /** Write the cache file if new directories were scanned. */
+    void save()
+    {
+      if ( ! _dirty || _file.empty() )
+        return;
+      _dirty = false;
+
+      writeFileAtomic( _file, [this]( std::ostream & out ) {
+        out << magic << '\n';
+        for ( const auto & p : _dirs )
+        {
+          const Dir & dir { p.second };
+          if ( dir._racy )
+            continue;
+          out << "dir " << dir._stamp._dev << ' ' << dir._stamp._ino << ' ' << dir._stamp._sec << ' ' << dir._stamp._nsec << ' ' << p.first << '\n';
+          for ( const std::string & entry : dir._entries )
+            out << '\t' << entry << '\n';
+        }
+      } );
+    }
+
+  private:
+    SubcommandDirCache()
+    {
+      Pathname cacheHome { env::XDG_CACHE_HOME() };
+      if ( cacheHome.empty() )
+        return;
+      _file = cacheHome / "zypper/subcommands";
+      load();
+    }
+
+    void load()
+    {
+      std::ifstream in( _file.c_str() );
+      std::string line;
+      if ( ! std::getline( in, line ) || line != magic )
+        return;	// missing or outdated format
+
+      Dir * dir = nullptr;
+      while ( std::getline( in, line ) )
+      {
+        if ( str::startsWith( line, "\t" ) )
+        {
+          if ( dir )
+            dir->_entries.push_back( line.substr( 1 ) );
+          continue;
+        }
+
+        dir = nullptr;
+        Stamp stamp;
+        std::istringstream str( line );
+        std::string tag;
+        if ( str >> tag >> stamp._dev >> stamp._ino >> stamp._sec >> stamp._nsec && tag == "dir" && str.get() == ' ' )
+        {
+          std::string path;
+          std::getline( str, path );
+          if ( ! path.empty() )
+          {
+            dir = &_dirs[path];
+            dir->_stamp = stamp;
+          }
+        }
+      }
+      DBG << "Loaded " << _file << ": " << _dirs.size() << " directories" << endl;
+    }
+
+  private:
+    static constexpr const char * magic = "# zypper subcommands cache 1";
+
+    struct Stamp
+    {
+      dev_t     _dev  = 0;
+      ino_t     _ino  = 0;
+      time_t    _sec  = 0;
+      long      _nsec = 0;
+
+      bool operator==( const Stamp & rhs ) const
+      { return _dev == rhs._dev && _ino == rhs._ino && _sec == rhs._sec && _nsec == rhs._nsec; }
+    };
+
+    struct Dir
+    {
+      Stamp _stamp;
+      std::vector<std::string> _entries;	///< sorted
+      bool _racy = false;			///< changed while scanned; not saved
+    };
+
+    Pathname _file;
+    std::map<std::string,Dir> _dirs;
+    bool _dirty = false;
+  };
+
   inline bool testAndRememberSubcommand( const Pathname & path_r, const std::string & name_r, const std::string & cmd_r  )
   {
-    if ( canExecute( path_r/name_r ) )
+    if ( SubcommandDirCache::instance().contains( path_r, name_r ) && canExecute( path_r/name_r ) )
     {
       SubcommandOptions::Detected & ref( lastSubcommandDetected() );
       ref = SubcommandOptions::Detected();	// reset
@@ -165,14 +332,12 @@ namespace	// subcommand detetction
     if ( !fnc_r )
       return;
 
-    filesystem::dirForEach( dir_r,
-                            [&fnc_r]( const Pathname & dir_r, std::string name_r )->bool
-                            {
-                              SubcommandOptions::Detected cmd { detectSubcommand( dir_r, std::move(name_r) ) };
-                              if ( ! cmd._cmd.empty() )
-                                fnc_r( std::move(cmd) );
-                              return true;
-                            } );
+    for ( const std::string & name : SubcommandDirCache::instance().entries( dir_r ) )
+    {
+      SubcommandOptions::Detected cmd { detectSubcommand( dir_r, name ) };
+      if ( ! cmd._cmd.empty() )
+        fnc_r( std::move(cmd) );
+    }
   }
 
   /* Just the command names for the short help. */
@@ -190,6 +355,8 @@ namespace	// subcommand detetction
 
     for ( const auto & dir : pathDirs_r )
       collectSubcommandsIn( dir );
+
+    SubcommandDirCache::instance().save();
   }
 
   /* The command details for the long help. */
@@ -210,6 +377,8 @@ namespace	// subcommand detetction
 
     for ( const auto & dir : pathDirs_r )
       collectSubcommandsIn( dir, pathCommands_r, &execdirCommands_r );
+
+    SubcommandDirCache::instance().save();
   }
 
 } // namespace
@@ -551,17 +720,17 @@ bool SubCmd::isSubcommand(const std::string &strval_r )
     return false;	// illegal name (e.g. pathsep in name)
 
   // Execdir first..
-  if ( testAndRememberSubcommand( SubcommandOptions::_execdir, execname, strval_r ) )
-    return true;
+  bool found = testAndRememberSubcommand( SubcommandOptions::_execdir, execname, strval_r );
 
-  if ( Zypper::instance().config().seach_subcommand_in_path ) {
+  if ( ! found && Zypper::instance().config().seach_subcommand_in_path ) {
     // Search in $PATH...
     for ( const auto & dir : pathDirsIf( true ) ) {
-      if ( testAndRememberSubcommand( dir, execname, strval_r ) )
-        return true;
+      if ( ( found = testAndRememberSubcommand( dir, execname, strval_r ) ) )
+        break;
     }
   }
-  return false;
+  SubcommandDirCache::instance().save();
+  return found;
 }
 
 CommandSummaries SubCmd::getSubcommandSummaries()
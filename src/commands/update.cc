@@ -57,6 +57,11 @@ void UpdateCmd::doReset()
   _kinds.clear();
 }
 
+bool UpdateCmd::jsonOutput() const
+{
+  return true;
+}
+
 int UpdateCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
 {
   //remember if any kind arguments were given on the CLI
@@ -38,6 +38,7 @@ protected:
   std::vector<BaseCommandConditionPtr> conditions() const override;
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  bool jsonOutput() const override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
 };
 
@@ -18,11 +18,13 @@
 
 #include "utils/flags/flagtypes.h"
 #include "utils/messages.h"
+#include "utils/ParallelJobs.h"
 #include "Zypper.h"
 #include "PackageArgs.h"
 #include "Table.h"
 #include "download.h"
 #include "global-settings.h"
+#include "output/OutJSON.h"
 
 using namespace zypp;
 
@@ -83,6 +85,67 @@ namespace
     }
   }
 
+  inline void logJsonResult( const PoolItem & pi_r, const Pathname & localfile_r )
+  {
+    // {"type":"download-result","kind":"package","name":"glibc",...,"localfile":"/tmp/..."}
+    // "localfile" is empty on error
+    OutJSON::Record record( "download-result" );
+    record.addSolvable( pi_r.satSolvable() ).add( "localfile", localfile_r.asString() );
+    OutJSON::writeRecord( cout, record );
+  }
+
+  /** Download the not yet cached packages in \a items_r into the package
+   * cache using up to \a jobs_r worker processes (at most \a jobsPerRepo_r
+   * per repo; 0: no limit). Only an aggregated progress is shown. The
+   * caller reports the results as usual; packages the workers failed to
+   * download are still not cached and are downloaded the usual way.
+   */
+  void prefetchPackages( Zypper & zypper_r, const std::vector<PoolItem> & items_r, unsigned jobs_r, unsigned jobsPerRepo_r )
+  {
+    if ( jobs_r <= 1 )
+      return;
+
+    std::vector<PoolItem> todo;
+    for ( const auto & pi : items_r )
+    {
+      if ( ! isCached( pi ) )
+        todo.push_back( pi );
+    }
+    if ( todo.size() <= 1 )
+      return;
+
+    MIL << "Prefetching " << todo.size() << " packages (" << jobs_r << " jobs, " << jobsPerRepo_r << " per repo)" << endl;
+
+    ParallelJobs workers( jobs_r );
+    workers.setMaxJobsPerGroup( jobsPerRepo_r );
+    for ( const auto & pi : todo )
+    {
+      workers.add( [&zypper_r,pi]() -> int
+      {
+        // Workers must not prompt. Anything requiring user interaction lets
+        // the job fail and the package is downloaded the usual way afterwards.
+        zypper_r.configNoConst().non_interactive = true;
+        callback::TempConnect<media::MediaChangeReport> tempDisconnect;
+
+        target::CommitPackageCache packageCache;
+        ManagedFile localfile( packageCache.get( pi ) );
+        localfile.resetDispose();
+        return isCached( pi ) ? 0 : 1;
+      }, pi.repoInfo().alias() );
+    }
+
+    Out::ProgressBar report( zypper_r.out(), "download-packages",
+                             // translators: progress bar label; %1% is the number of packages
+                             str::Format(_("Downloading %1% packages in parallel")) % todo.size() );
+    report->range( todo.size() );
+    workers.run( [&]( unsigned idx_r, int result_r )
+    {
+      if ( result_r != 0 )
+        MIL << "Prefetching " << todo[idx_r] << " failed. Will retry." << endl;
+      report->incr();
+    } );
+  }
+
   /** Whether user may create \a dir_r or has rw-access to it. */
   inline bool userMayUseDir( const Pathname & dir_r )
   {
@@ -169,12 +232,32 @@ ZyppFlags::CommandGroup DownloadCmd::cmdOptions() const
         // translators: --from <ALIAS|#|URI>
         _("Select packages from the specified repository.")
       },
+      { "parallel", '\0', ZyppFlags::RequiredArgument,
+        ZyppFlags::IntType( &that->_jobs ),
+        // translators: --parallel <INTEGER>
+        _("Download up to this number of packages in parallel.")
+      },
+      { "parallel-per-repo", '\0', ZyppFlags::RequiredArgument,
+        ZyppFlags::Value( ZyppFlags::noDefaultValue,
+          [that]( const ZyppFlags::CommandOption & opt_r, const boost::optional<std::string> & in_r ) {
+            that->_jobsPerRepo = ZyppFlags::argValueConvert<int>( opt_r, in_r );
+          }, ARG_INTEGER ),
+        // translators: --parallel-per-repo <INTEGER>
+        _("Download up to this number of packages in parallel from the same repository (0: no limit).")
+      },
   }};
 }
 
 void DownloadCmd::doReset()
 {
   _allMatches = false;
+  _jobs = 0;
+  _jobsPerRepo.reset();
+}
+
+bool DownloadCmd::jsonOutput() const
+{
+  return true;
 }
 
 std::vector<BaseCommandConditionPtr> DownloadCmd::conditions() const
@@ -195,6 +278,17 @@ int DownloadCmd::earlyPositionalArgsCheck( Zypper &zypper, const std::vector<std
 
 int DownloadCmd::execute( Zypper &zypper , const std::vector<std::string> &positionalArgs_r )
 {
+    if ( _jobs < 0 )
+    {
+      zypper.out().error( str::Format(_("Invalid value '%1%' of the %2% option.")) % _jobs % "--parallel" );
+      return ZYPPER_EXIT_ERR_INVALID_ARGS;
+    }
+    if ( _jobsPerRepo && *_jobsPerRepo < 0 )
+    {
+      zypper.out().error( str::Format(_("Invalid value '%1%' of the %2% option.")) % *_jobsPerRepo % "--parallel-per-repo" );
+      return ZYPPER_EXIT_ERR_INVALID_ARGS;
+    }
+
     typedef ui::SelectableTraits::AvailableItemSet AvailableItemSet;
     typedef std::map<IdString,AvailableItemSet> Collection;
     Collection collect;
@@ -272,6 +366,26 @@ int DownloadCmd::execute( Zypper &zypper , const std::vector<std::string> &posit
     {
       zypper.out().info( str::Str() << _("Not downloading anything...") << " (--dry-run)" );
     }
+    else
+    {
+      // Let workers download the packages in parallel. They are then
+      // reported as cached by the loop below.
+      std::vector<PoolItem> todo;
+      for ( const auto & ent : collect )
+      {
+        for ( const auto & pi : ent.second )
+        {
+          todo.push_back( pi );
+          if ( !_allMatches )
+            break;	// first==best version only.
+        }
+      }
+      prefetchPackages( zypper, todo,
+                        _jobs ? _jobs : zypper.config().download_jobs,
+                        _jobsPerRepo ? *_jobsPerRepo : zypper.config().download_jobsPerRepo );
+      if ( zypper.exitRequested() )
+        return ZYPPER_EXIT_ON_SIGNAL;
+    }
 
     // Prepare the package cache. Pass all items requiring download.
     target::CommitPackageCache packageCache;
@@ -319,6 +433,8 @@ int DownloadCmd::execute( Zypper &zypper , const std::vector<std::string> &posit
             localfile.resetDispose();
             if ( zypper.out().typeXML() )
               logXmlResult( pi, localfile );
+            else if ( typeJSON( zypper.out() ) )
+              logJsonResult( pi, localfile );
 
             if ( zypper.exitRequested() )
               return ZYPPER_EXIT_ON_SIGNAL;
@@ -336,6 +452,8 @@ int DownloadCmd::execute( Zypper &zypper , const std::vector<std::string> &posit
           Out::ProgressBar report( zypper.out(), localfile.asString(), current, total );
           if ( zypper.out().typeXML() )
             logXmlResult( pi, localfile );
+          else if ( typeJSON( zypper.out() ) )
+            logJsonResult( pi, localfile );
         }
 
         if ( !_allMatches )
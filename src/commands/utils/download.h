@@ -45,12 +45,15 @@ private:
   DryRunOptionSet _dryRun { *this };
   InitReposOptionSet _initRepos { *this };
   bool _allMatches = false;
+  int _jobs = 0;		///< 0: use zypper.conf
+  boost::optional<int> _jobsPerRepo;	///< unset: use zypper.conf
 
 
   // ZypperBaseCommand interface
 protected:
   zypp::ZyppFlags::CommandGroup cmdOptions() const override;
   void doReset() override;
+  bool jsonOutput() const override;
   int earlyPositionalArgsCheck( Zypper &zypper, const std::vector<std::string> &positionalArgs_r ) override;
   int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
   std::vector<BaseCommandConditionPtr> conditions() const override;
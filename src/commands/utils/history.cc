@@ -0,0 +1,190 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include "history.h"
+#include "utils/flags/flagtypes.h"
+#include "utils/HistoryLog.h"
+#include "utils/misc.h"
+#include "output/OutJSON.h"
+#include "Zypper.h"
+
+#include <algorithm>
+
+#include <zypp/base/Xml.h>
+#include <zypp/ZConfig.h>
+
+using namespace zypp;
+
+namespace
+{
+  /** Parse a --since/--until argument; a bare day means its start or (\a endOfDay_r) its end. */
+  bool parseDate( const std::string & arg_r, bool endOfDay_r, Date & date_r )
+  {
+    for ( const char * format : { "%Y-%m-%d %H:%M:%S", "%Y-%m-%d %H:%M" } )
+    {
+      try {
+        date_r = Date( arg_r, format );
+        return true;
+      }
+      catch ( const DateFormatException & ) {}
+    }
+    try {
+      date_r = Date( arg_r, "%Y-%m-%d" );
+      if ( endOfDay_r )
+        date_r = Date( Date::ValueType(date_r) + Date::day - 1 );
+      return true;
+    }
+    catch ( const DateFormatException & ) {}
+    return false;
+  }
+
+  /** Whether the action names a package in field 2 (install, remove, patch). */
+  inline bool hasSolvableName( std::string_view action_r )
+  {
+    return action_r == HistoryActionID::INSTALL.asString()
+        || action_r == HistoryActionID::REMOVE.asString()
+        || action_r == HistoryActionID::PATCH_STATE_CHANGE.asString();
+  }
+} // namespace
+
+HistoryCmd::HistoryCmd( std::vector<std::string> &&commandAliases_r ) :
+  ZypperBaseCommand(
+    std::move( commandAliases_r ),
+    // translators: command synopsis; do not translate lowercase words
+    _("history [OPTIONS] [NAME] ..."),
+    // translators: command summary: history
+    _("Show the package history."),
+    {
+      // translators: command description
+      _("Show the entries of the history log, optionally just those within a time range, of some action types or concerning the named packages and patches."),
+      // translators: command description
+      _("Dates are given in local time as 'YYYY-MM-DD', 'YYYY-MM-DD hh:mm' or 'YYYY-MM-DD hh:mm:ss'."),
+    },
+    DisableAll
+  )
+{ }
+
+zypp::ZyppFlags::CommandGroup HistoryCmd::cmdOptions() const
+{
+  auto that = const_cast<HistoryCmd *>(this);
+  return {{
+    { "since", '\0', ZyppFlags::RequiredArgument, ZyppFlags::StringType( &that->_since, boost::optional<const char *>(), "DATE" ),
+      // translators: --since <DATE>
+      _("Show only entries written at or after the given date.")
+    },
+    { "until", '\0', ZyppFlags::RequiredArgument, ZyppFlags::StringType( &that->_until, boost::optional<const char *>(), "DATE" ),
+      // translators: --until <DATE>
+      _("Show only entries written at or before the given date.")
+    },
+    { "action", 'a', ZyppFlags::RequiredArgument | ZyppFlags::Repeatable, ZyppFlags::StringVectorType( &that->_actions, "ACTION" ),
+      // translators: -a, --action <ACTION>
+      _("Show only entries of this action type (e.g. install, remove, patch, command, radd, rremove). Can be used multiple times.")
+    }
+  }};
+}
+
+void HistoryCmd::doReset()
+{
+  _since.clear();
+  _until.clear();
+  _actions.clear();
+}
+
+bool HistoryCmd::jsonOutput() const
+{
+  return true;
+}
+
+int HistoryCmd::execute( Zypper &zypper, const std::vector<std::string> &positionalArgs_r )
+{
+  HistoryLog::Filter filter;
+  for ( const std::string & action : _actions )
+  {
+    // accept the padded IDs as well; lines are compared unpadded
+    HistoryActionID id { str::trim( action ) };
+    filter._actions.push_back( id == HistoryActionID::NONE ? str::trim( action ) : id.asString() );
+  }
+  if ( ! _since.empty() && ! parseDate( _since, false, filter._since ) )
+  {
+    // translators: %s is the argument given by the user
+    zypper.out().error( str::form(_("Invalid date '%s'."), _since.c_str() ) );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+  if ( ! _until.empty() && ! parseDate( _until, true, filter._until ) )
+  {
+    zypper.out().error( str::form(_("Invalid date '%s'."), _until.c_str() ) );
+    return ZYPPER_EXIT_ERR_INVALID_ARGS;
+  }
+
+  const Pathname & historyFile { Pathname::assertprefix( zypper.config().root_dir, ZConfig::instance().historyLogFile() ) };
+  HistoryLog log { historyFile };
+  if ( ! log )
+  {
+    // translators: %s is a file name
+    zypper.out().error( str::form(_("Can't read the history log %s."), historyFile.c_str() ) );
+    return ZYPPER_EXIT_ERR_ZYPP;
+  }
+
+  Out & out { zypper.out() };
+  bool json = typeJSON( out );
+  bool xml = ( out.type() == Out::TYPE_XML );
+  if ( xml )
+    cout << "<history>" << endl;
+
+  // Lines are written as they are found; there may be many.
+  unsigned found = 0;
+  log.forEach( filter, [&]( const HistoryLog::Line & line_r ) -> bool {
+    std::string_view action { line_r.action() };
+    if ( ! positionalArgs_r.empty() )
+    {
+      if ( ! hasSolvableName( action ) )
+        return true;
+      std::string_view name { line_r.field( 2 ) };
+      if ( std::find( positionalArgs_r.begin(), positionalArgs_r.end(), name ) == positionalArgs_r.end() )
+        return true;
+    }
+
+    HistoryLogData::FieldVector fields { line_r.fields() };
+    if ( fields.size() < 2 )
+      return true;	// malformed
+    ++found;
+
+    if ( json )
+    {
+      OutJSON::Record record( "history" );
+      record.add( "date", fields[0] ).add( "action", std::string( action ) );
+      record.add( "fields", HistoryLogData::FieldVector( fields.begin() + 2, fields.end() ) );
+      OutJSON::writeRecord( cout, record );
+    }
+    else if ( xml )
+    {
+      xmlout::Node entry { cout, "entry", xmlout::Node::optionalContent, {
+        { "date", fields[0] },
+        { "action", std::string( action ) },
+      } };
+      for ( auto it = fields.begin() + 2; it != fields.end(); ++it )
+        zypp::dumpAsXmlOn( *entry, *it, "field" );
+    }
+    else
+    {
+      cout << fields[0] << " | " << fields[1] << " |";
+      for ( auto it = fields.begin() + 2; it != fields.end(); ++it )
+        cout << ' ' << *it;
+      cout << '\n';
+    }
+    return true;
+  } );
+
+  if ( xml )
+    cout << "</history>" << endl;
+  else
+    cout << std::flush;
+
+  if ( ! found )
+    out.info( _("No matching history entries found.") );
+  return ZYPPER_EXIT_OK;
+}
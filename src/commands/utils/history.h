@@ -0,0 +1,30 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_COMMANDS_UTILS_HISTORY_INCLUDED
+#define ZYPPER_COMMANDS_UTILS_HISTORY_INCLUDED
+
+#include "commands/basecommand.h"
+#include "utils/flags/zyppflags.h"
+
+class HistoryCmd : public ZypperBaseCommand
+{
+public:
+  HistoryCmd( std::vector<std::string> &&commandAliases_r );
+  // ZypperBaseCommand interface
+protected:
+  zypp::ZyppFlags::CommandGroup cmdOptions() const override;
+  void doReset() override;
+  bool jsonOutput() const override;
+  int execute(Zypper &zypper, const std::vector<std::string> &positionalArgs_r) override;
+
+private:
+  std::string _since;
+  std::string _until;
+  std::vector<std::string> _actions;
+};
+
+#endif
@@ -6,6 +6,12 @@
 \*---------------------------------------------------------------------------*/
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <zypp/base/Algorithm.h>
 #include <zypp/ZYpp.h>
@@ -15,6 +21,7 @@
 #include <zypp/Product.h>
 #include <zypp/PoolQuery.h>
 #include <zypp/base/LogTools.h>
+#include <zypp/TmpPath.h>
 
 #include "Zypper.h"
 #include "main.h"
@@ -22,6 +29,8 @@
 #include "utils/misc.h"
 #include "utils/text.h"
 #include "utils/richtext.h"
+#include "utils/ParallelJobs.h"
+#include "output/OutJSON.h"
 #include "search.h"
 #include "update.h"
 #include "global-settings.h"
@@ -210,20 +219,233 @@ namespace {
     return baseQ;
   }
 
-  void logOtherKindMatches( const PoolQuery & q_r, const std::string & name_r )
+  using Selectables = std::vector<ui::Selectable::Ptr>;
+
+  std::string otherKindMatchesMessage( const Selectables & sels_r, const std::string & name_r )
   {
+    str::Str ret;
     std::map<ResKind,DefaultIntegral<unsigned,0U>> count;
-    for_( it, q_r.selectableBegin(), q_r.selectableEnd() )
-    { ++count[(*it)->kind()]; }
+    for ( const auto & sel : sels_r )
+    { ++count[sel->kind()]; }
     for ( const auto & pair : count )
     {
-      cout << str::Format(PL_("There would be %1% match for '%2%'."
-                             ,"There would be %1% matches for '%2%'."
-                             ,pair.second))
-                         % pair.second
-                         % (pair.first.asString()+":"+name_r)
-           << endl;
+      ret << str::Format(PL_("There would be %1% match for '%2%'."
+                            ,"There would be %1% matches for '%2%'."
+                            ,pair.second))
+                        % pair.second
+                        % (pair.first.asString()+":"+name_r)
+          << endl;
+    }
+    return ret;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class InfoLookup
+  /// \brief Find the selectables named by the arguments.
+  ///
+  /// Exact names (the common case when asking for many packages) are
+  /// looked up in an index of all selectables by name, built by a single
+  /// pass over the pool. Like the PoolQuery the index is case-insensitive.
+  /// Globs and substrings still use a PoolQuery.
+  ///////////////////////////////////////////////////////////////////
+  class InfoLookup
+  {
+  public:
+    InfoLookup( Zypper & zypper_r, const PrintInfoOptions & options_r )
+    : _zypper( zypper_r )
+    , _options( options_r )
+    {}
+
+    /** The selectables named \a name_r of one of \a kinds_r (any if empty). */
+    Selectables lookup( const std::string & name_r, const std::set<ResKind> & kinds_r )
+    {
+      Selectables ret;
+      if ( _options._matchSubstrings || name_r.find_first_of( "*?[\\" ) != std::string::npos )
+      {
+        PoolQuery q( printInfo_BasicQuery( _zypper, _options ) );
+        q.addAttribute( sat::SolvAttr::name, name_r );
+        for ( const auto & kind : kinds_r )
+          q.addKind( kind );
+        ret.assign( q.selectableBegin(), q.selectableEnd() );
+        return ret;
+      }
+
+      const Index & index { byName() };
+      auto it = index.find( str::toLower( name_r ) );
+      if ( it != index.end() )
+      {
+        for ( const auto & sel : it->second )
+        {
+          if ( kinds_r.empty() || kinds_r.count( sel->kind() ) )
+            ret.push_back( sel );
+        }
+      }
+      return ret;
+    }
+
+  private:
+    using Index = std::unordered_map<std::string,Selectables>;	///< by lowercase name
+
+    const Index & byName()
+    {
+      if ( _index )
+        return *_index;
+
+      // like the query: with --repo just selectables available in these repos
+      std::set<std::string> repos;
+      if ( InitRepoSettings::instance()._repoFilter.size() )
+      {
+        for ( const RepoInfo & repo : _zypper.runtimeData().repos  )
+          repos.insert( repo.alias() );
+      }
+
+      _index.reset( new Index );
+      ResPoolProxy selPool( God->pool().proxy() );
+      for ( const ui::Selectable::Ptr & sel : selPool )
+      {
+        if ( ! repos.empty() )
+        {
+          bool inRepos = false;
+          for ( const PoolItem & pi : sel->available() )
+          {
+            if ( repos.count( pi.repository().alias() ) )
+            {
+              inRepos = true;
+              break;
+            }
+          }
+          if ( ! inRepos )
+            continue;
+        }
+        (*_index)[str::toLower( sel->name() )].push_back( sel );
+      }
+      DBG << "Indexed " << _index->size() << " names" << endl;
+      return *_index;
+    }
+
+  private:
+    Zypper & _zypper;
+    const PrintInfoOptions & _options;
+    std::unique_ptr<Index> _index;
+  };
+
+  /** What's printed for an argument: A message or the info about a selectable. */
+  struct InfoEntry
+  {
+    std::string _message;
+    ui::Selectable::Ptr _sel;
+  };
+
+  void printSelectableInfo( Zypper & zypper, const ui::Selectable & sel, const PrintInfoOptions &options_r );
+
+  /** --jsonout: The text of the info as \c "info" record. */
+  void printSelectableInfoJSON( Zypper & zypper, const ui::Selectable & sel, const PrintInfoOptions &options_r )
+  {
+    std::ostringstream text;
+    {
+      std::streambuf * saved = cout.rdbuf( text.rdbuf() );
+      try
+      {
+        printSelectableInfo( zypper, sel, options_r );
+      }
+      catch ( ... )
+      {
+        cout.rdbuf( saved );
+        throw;
+      }
+      cout.rdbuf( saved );
     }
+    OutJSON::Record record( "info" );
+    record.add( "kind", sel.kind().asString() ).add( "name", sel.name() ).add( "text", str::trim( text.str() ) );
+    OutJSON::writeRecord( cout, record );
+  }
+
+  void printSelectableInfo( Zypper & zypper, const ui::Selectable & sel, const PrintInfoOptions &options_r )
+  {
+    if ( zypper.out().typeNORMAL() )
+    {
+      // TranslatorExplanation E.g. "Information for package zypper:"
+      std::string info = str::Format(_("Information for %s %s:"))
+                               % kind_to_string_localized( sel.kind(), 1 )
+                               % sel.name();
+
+      cout << endl << info << endl;
+      cout << std::string( mbs_width(info), '-' ) << endl;
+    }
+
+    if      ( sel.kind() == ResKind::package )	{ printPkgInfo( zypper, sel, options_r ); }
+    else if ( sel.kind() == ResKind::patch )		{ printPatchInfo( zypper, sel, options_r ); }
+    else if ( sel.kind() == ResKind::pattern )	{ printPatternInfo( zypper, sel, options_r ); }
+    else if ( sel.kind() == ResKind::product )	{ printProductInfo( zypper, sel, options_r ); }
+    else if ( sel.kind() == ResKind::srcpackage)	{ printSrcPackageInfo( zypper, sel, options_r ); }
+    else 						{ printDefaultInfo( zypper, sel, options_r ); }
+  }
+
+  void printEntries( Zypper & zypper, std::vector<InfoEntry>::const_iterator begin_r, std::vector<InfoEntry>::const_iterator end_r, const PrintInfoOptions &options_r )
+  {
+    for ( ; begin_r != end_r; ++begin_r )
+    {
+      if ( begin_r->_sel )
+      {
+        if ( typeJSON( zypper.out() ) )
+          printSelectableInfoJSON( zypper, *begin_r->_sel, options_r );
+        else
+          printSelectableInfo( zypper, *begin_r->_sel, options_r );
+      }
+      else if ( typeJSON( zypper.out() ) )
+        OutJSON::writeRecord( cout, OutJSON::Record( "message" ).add( "level", "info" ).add( "text", str::trim( begin_r->_message ) ) );
+      else
+        cout << begin_r->_message;
+    }
+  }
+
+  /** Number of selectables from which on their info is built in parallel. */
+  constexpr unsigned parallelInfoThreshold = 64;
+
+  /** Build the info in forked workers (libzypp is not thread safe), each
+   * writing a contiguous range of entries to a file. The files are then
+   * printed in order, so the output is the same as if built serially.
+   */
+  void printEntriesParallel( Zypper & zypper, const std::vector<InfoEntry> & entries_r, unsigned jobs_r, const PrintInfoOptions &options_r )
+  {
+    filesystem::TmpDir tmp;
+    unsigned chunks = std::min<unsigned>( jobs_r, entries_r.size() );
+    auto chunkBegin = [&]( unsigned idx_r ) { return entries_r.begin() + ( entries_r.size() * idx_r / chunks ); };
+    auto chunkFile = [&]( unsigned idx_r ) { return tmp.path() / str::numstring( idx_r ); };
+
+    // children must not inherit and print pending output
+    cout.flush();
+    ::fflush( stdout );
+
+    ParallelJobs workers( jobs_r );
+    for ( unsigned idx = 0; idx < chunks; ++idx )
+    {
+      workers.add( [&,idx]() {
+        int fd = ::open( chunkFile( idx ).c_str(), O_CREAT|O_WRONLY|O_TRUNC|O_CLOEXEC, 0600 );
+        if ( fd == -1 || ::dup2( fd, STDOUT_FILENO ) == -1 )
+          return 1;
+        ::close( fd );
+        printEntries( zypper, chunkBegin( idx ), chunkBegin( idx+1 ), options_r );
+        cout.flush();
+        return ::fflush( stdout ) == 0 ? 0 : 1;
+      } );
+    }
+    std::vector<int> results { workers.run() };
+
+    for ( unsigned idx = 0; idx < chunks; ++idx )
+    {
+      if ( results[idx] == 0 )
+      {
+        std::ifstream chunk( chunkFile( idx ).c_str() );
+        cout << chunk.rdbuf();
+      }
+      else
+      {
+        WAR << "Info worker " << idx << " failed. Building its part serially." << endl;
+        printEntries( zypper, chunkBegin( idx ), chunkBegin( idx+1 ), options_r );
+      }
+    }
+    cout.flush();
   }
 } // namespace
 ///////////////////////////////////////////////////////////////////
@@ -233,31 +455,34 @@ void printInfo( Zypper & zypper, const std::vector<std::string> &names_r, const
   zypper.out().gap();
   bool noMatches = true;
 
+  // First resolve all arguments...
+  InfoLookup lookup( zypper, options_r );
+  std::vector<InfoEntry> entries;
+  unsigned selectables = 0;
+
   for ( const std::string & rawarg : names_r )
   {
     // Use the right kind!
     KNSplit kn( rawarg );
 
-    PoolQuery q( printInfo_BasicQuery( zypper, options_r ) );
-    q.addAttribute( sat::SolvAttr::name, kn._name );
-
+    std::set<ResKind> kinds;
     bool fallBackToAny = false;
     if ( kn._kind )
     {
-      q.addKind( kn._kind );			// explicit kind in arg
+      kinds.insert( kn._kind );			// explicit kind in arg
     }
     else if ( !options_r._kinds.empty() )
     {
-      for ( const auto & kind : options_r._kinds )	// wanted kinds via -t
-        q.addKind( kind );
+      kinds = options_r._kinds;			// wanted kinds via -t
     }
     else
     {
-      q.addKind( ResKind::package );
+      kinds.insert( ResKind::package );
       fallBackToAny = true;			// Prefer packages, but fall back to any
     }
 
-    if ( q.empty() )
+    Selectables matches { lookup.lookup( kn._name, kinds ) };
+    if ( matches.empty() )
     {
       ResKind oneKind( kn._kind );
       if ( !oneKind )
@@ -268,49 +493,40 @@ void printInfo( Zypper & zypper, const std::vector<std::string> &names_r, const
           oneKind = ResKind::package;
       }
       // TranslatorExplanation E.g. "package 'zypper' not found."
-      cout << "\n" << str::Format(_("%s '%s' not found.")) % kind_to_string_localized( oneKind, 1 ) % rawarg << endl;
+      std::string message { str::Str() << "\n" << str::Format(_("%s '%s' not found.")) % kind_to_string_localized( oneKind, 1 ) % rawarg << endl };
 
       // hint to matches of different kind (preferPackages looked for any)
-      PoolQuery h( printInfo_BasicQuery( zypper, options_r ) );
-      h.addAttribute( sat::SolvAttr::name, kn._name );
+      Selectables h { lookup.lookup( kn._name, std::set<ResKind>() ) };
 
       if ( h.empty() ) {
+        entries.push_back( { std::move(message), ui::Selectable::Ptr() } );
         continue;
       }
       else if ( !fallBackToAny ) {
-        logOtherKindMatches( h, kn._name );
+        entries.push_back( { message + otherKindMatchesMessage( h, kn._name ), ui::Selectable::Ptr() } );
         continue;
       }
       else {
-        q = h;
+        entries.push_back( { std::move(message), ui::Selectable::Ptr() } );
+        matches = std::move(h);
       }
     }
 
-    for_( it, q.selectableBegin(), q.selectableEnd() )
+    for ( const auto & sel : matches )
     {
       if ( noMatches ) noMatches = false;
-      const ui::Selectable & sel( *(*it) );
-
-      if ( zypper.out().type() != Out::TYPE_XML )
-      {
-        // TranslatorExplanation E.g. "Information for package zypper:"
-        std::string info = str::Format(_("Information for %s %s:"))
-                                 % kind_to_string_localized( sel.kind(), 1 )
-                                 % sel.name();
-
-        cout << endl << info << endl;
-        cout << std::string( mbs_width(info), '-' ) << endl;
-      }
-
-      if      ( sel.kind() == ResKind::package )	{ printPkgInfo( zypper, sel, options_r ); }
-      else if ( sel.kind() == ResKind::patch )		{ printPatchInfo( zypper, sel, options_r ); }
-      else if ( sel.kind() == ResKind::pattern )	{ printPatternInfo( zypper, sel, options_r ); }
-      else if ( sel.kind() == ResKind::product )	{ printProductInfo( zypper, sel, options_r ); }
-      else if ( sel.kind() == ResKind::srcpackage)	{ printSrcPackageInfo( zypper, sel, options_r ); }
-      else 						{ printDefaultInfo( zypper, sel, options_r ); }
+      entries.push_back( { std::string(), sel } );
+      ++selectables;
     }
   }
 
+  // ...then print them in order.
+  unsigned jobs = ParallelJobs::onlineCPUs();
+  if ( selectables >= parallelInfoThreshold && jobs > 1 )
+    printEntriesParallel( zypper, entries, jobs, options_r );
+  else
+    printEntries( zypper, entries.begin(), entries.end(), options_r );
+
   if ( noMatches ) {
     zypper.out().info(_("No matching items found."), Out::QUIET );
     if ( !zypper.config().ignore_unknown ) {
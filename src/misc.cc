@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include <zypp/Arch.h>
 #include <zypp/ZYppFactory.h>
@@ -22,10 +23,12 @@
 #include <zypp/PoolQuery.h>
 #include <zypp/PoolItemBest.h>
 #include <zypp/ResObject.h>
+#include <zypp/sat/Transaction.h>
 
 #include "Zypper.h"
 #include "main.h"
 #include "utils/misc.h"
+#include "utils/LicenseCache.h"
 #include "utils/pager.h"
 #include "utils/prompt.h"
 #include "utils/getopt.h"
@@ -104,48 +107,74 @@ bool confirm_licenses( Zypper & zypper )
   bool auto_agree_all = LicenseAgreementPolicy::instance()._autoAgreeWithLicenses;
   bool auto_agree_product = auto_agree_all || LicenseAgreementPolicy::instance()._autoAgreeWithProductLicenses;
 
-  for ( const PoolItem & pi : God->pool() )
+  // The items to install: the transaction holds those having a real solvable,
+  // patches and patterns are just pseudo installed.
+  std::vector<PoolItem> toInstall;
+  for ( const sat::Transaction::Step & step : God->resolver()->getTransaction() )
+  {
+    if ( step.stepType() == sat::Transaction::TRANSACTION_INSTALL || step.stepType() == sat::Transaction::TRANSACTION_MULTIINSTALL )
+      toInstall.push_back( PoolItem( step.satSolvable() ) );
+  }
+  for ( const ResKind & kind : { ResKind::patch, ResKind::pattern } )
+  {
+    for_( it, God->pool().byKindBegin( kind ), God->pool().byKindEnd( kind ) )
+      if ( it->status().isToBeInstalled() )
+        toInstall.push_back( *it );
+  }
+  DBG << toInstall.size() << " items to install" << endl;
+
+  LicenseCache cache( LicenseCache::defaultFile( zypper.config().rm_options.repoCachePath ) );
+  std::vector<std::pair<std::string,std::string>> toRemember;	// ident and license text agreed to
+
+  for ( const PoolItem & pi : toInstall )
   {
     std::string piLicenseToConfirm { pi.licenseToConfirm() };
+    if ( piLicenseToConfirm.empty() )
+      continue;
 
-    if ( pi.status().isToBeInstalled() && !piLicenseToConfirm.empty() )
-    {
-      ui::Selectable::Ptr selectable = God->pool().proxy().lookup( pi.kind(), pi.name() );
+    std::string ident { pi.ident().asString() };
+    ui::Selectable::Ptr selectable = God->pool().proxy().lookup( pi.kind(), pi.name() );
 
-      // this is an upgrade, check whether the license changed
-      // for now we only do dumb string comparison (bnc #394396)
-      if ( selectable->hasInstalledObj() )
+    // this is an upgrade, check whether the license changed
+    if ( selectable->hasInstalledObj() )
+    {
+      bool differ = false;
+      if ( cache.accepted( ident, piLicenseToConfirm ) )
+        DBG << "license for " << pi.name() << " was already agreed to" << endl;
+      else
       {
-        bool differ = false;
+        // no cache entry yet: dumb string comparison (bnc #394396)
         for_( inst, selectable->installedBegin(), selectable->installedEnd() )
           if ( inst->resolvable()->licenseToConfirm() != piLicenseToConfirm )
           { differ = true; break; }
-
-        if ( !differ )
-        {
-          DBG << "old and new license does not differ for " << pi.name() << endl;
-          continue;
-        }
-        DBG << "new license for " << pi.name() << " is different, needs confirmation " << endl;
       }
 
-      bool auto_agree = auto_agree_all || ( auto_agree_product && pi.isKind<Product>() );
-      if ( auto_agree )
+      if ( !differ )
       {
-        zypper.out().info(
-          // translators: the first %s is name of the resolvable,
-          // the second is its kind (e.g. 'zypper package')
-          str::Format(_("Automatically agreeing with %s %s license."))
-          % get_display_name( pi )
-          % kind_to_string_localized(pi.kind(),1) );
-
-        MIL << "Automatically agreeing with " << pi.name() << " " <<  pi.kind() << " license." << endl;
+        DBG << "old and new license does not differ for " << pi.name() << endl;
+        toRemember.push_back( { std::move(ident), std::move(piLicenseToConfirm) } );
         continue;
       }
+      DBG << "new license for " << pi.name() << " is different, needs confirmation " << endl;
+    }
 
-      // collect it...
-      licenseCollector[std::move(piLicenseToConfirm)].insert( pi );
+    bool auto_agree = auto_agree_all || ( auto_agree_product && pi.isKind<Product>() );
+    if ( auto_agree )
+    {
+      zypper.out().info(
+        // translators: the first %s is name of the resolvable,
+        // the second is its kind (e.g. 'zypper package')
+        str::Format(_("Automatically agreeing with %s %s license."))
+        % get_display_name( pi )
+        % kind_to_string_localized(pi.kind(),1) );
+
+      MIL << "Automatically agreeing with " << pi.name() << " " <<  pi.kind() << " license." << endl;
+      toRemember.push_back( { std::move(ident), std::move(piLicenseToConfirm) } );
+      continue;
     }
+
+    // collect it...
+    licenseCollector[std::move(piLicenseToConfirm)].insert( pi );
   }
 
   // now display them...
@@ -216,7 +245,14 @@ bool confirm_licenses( Zypper & zypper )
         return false;
       }
     }
+    for ( const PoolItem & pi : el.second )
+      toRemember.push_back( { pi.ident().asString(), el.first } );
   }
+
+  // all agreed to: remember the texts for the next update
+  for ( const auto & p : toRemember )
+    cache.accept( p.first, p.second );
+  cache.save();
   return true;
 }
 
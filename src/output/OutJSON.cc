@@ -0,0 +1,277 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <zypp/base/String.h>
+#include <zypp/Repository.h>
+
+#include "OutJSON.h"
+#include "OutXML.h"
+#include "utils/misc.h"
+#include "Table.h"
+
+using std::cout;
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+// class OutJSON::Record
+///////////////////////////////////////////////////////////////////
+
+OutJSON::Record::Record( const std::string & type_r )
+: _body( "{" )
+{
+  if ( ! type_r.empty() )
+    add( "type", type_r );
+}
+
+OutJSON::Record & OutJSON::Record::add( const std::string & key_r, const std::string & value_r )
+{ return addRaw( key_r, quote( value_r ) ); }
+
+OutJSON::Record & OutJSON::Record::add( const std::string & key_r, const std::vector<std::string> & values_r )
+{
+  std::string json( "[" );
+  for ( const std::string & value : values_r )
+  {
+    if ( json.size() > 1 )
+      json += ',';
+    json += quote( value );
+  }
+  json += ']';
+  return addRaw( key_r, json );
+}
+
+OutJSON::Record & OutJSON::Record::add( const std::string & key_r, const std::vector<Record> & records_r )
+{
+  std::string json( "[" );
+  for ( const Record & record : records_r )
+  {
+    if ( json.size() > 1 )
+      json += ',';
+    json += record.asString();
+  }
+  json += ']';
+  return addRaw( key_r, json );
+}
+
+OutJSON::Record & OutJSON::Record::addRaw( const std::string & key_r, const std::string & json_r )
+{
+  if ( _body.size() > 1 )
+    _body += ',';
+  _body += quote( key_r );
+  _body += ':';
+  _body += json_r;
+  return *this;
+}
+
+OutJSON::Record & OutJSON::Record::addSolvable( const sat::Solvable & solv_r )
+{
+  add( "kind", solv_r.kind().asString() );
+  add( "name", solv_r.name() );
+  add( "edition", solv_r.edition().asString() );
+  add( "arch", solv_r.arch().asString() );
+  add( "repository", solv_r.repository().alias() );
+  return *this;
+}
+
+///////////////////////////////////////////////////////////////////
+// class OutJSON
+///////////////////////////////////////////////////////////////////
+
+OutJSON::OutJSON( Verbosity verbosity_r )
+: Out( TypeBit(0), verbosity_r )	// neither TYPE_NORMAL nor TYPE_XML
+{}
+
+OutJSON::~OutJSON()
+{
+  cout << std::flush;
+}
+
+std::string OutJSON::quote( const std::string & str_r )
+{
+  std::string ret;
+  ret.reserve( str_r.size() + 2 );
+  ret += '"';
+  for ( char ch : str_r )
+  {
+    switch ( ch )
+    {
+      case '"':  ret += "\\\""; break;
+      case '\\': ret += "\\\\"; break;
+      case '\n': ret += "\\n";  break;
+      case '\r': ret += "\\r";  break;
+      case '\t': ret += "\\t";  break;
+      default:
+        if ( (unsigned char)ch < 0x20 )
+          ret += str::form( "\\u%04x", (unsigned)ch );
+        else
+          ret += ch;
+    }
+  }
+  ret += '"';
+  return ret;
+}
+
+void OutJSON::writeRecord( std::ostream & str_r, const Record & record_r )
+{
+  // no endl: the stream is flushed before prompts and when done
+  str_r << record_r.asString() << '\n';
+}
+
+bool OutJSON::mine( Type type )
+{
+  // Just messages for all output types. Those for TYPE_NORMAL only are
+  // hints for the terminal, those for TYPE_XML only contain XML.
+  return ( type & Out::TYPE_NORMAL ) && ( type & Out::TYPE_XML );
+}
+
+bool OutJSON::infoWarningFilter( Verbosity verbosity_r, Type mask )
+{
+  if ( !mine(mask) )
+    return true;
+  if ( verbosity() < verbosity_r )
+    return true;
+  return false;
+}
+
+void OutJSON::writeMessage( const char * level_r, const std::string & text_r, const std::string & hint_r )
+{
+  Record record( "message" );
+  record.add( "level", level_r ).add( "text", text_r ).addIfNotEmpty( "hint", hint_r );
+  writeRecord( cout, record );
+}
+
+void OutJSON::info( const std::string & msg, Verbosity verbosity_r, Type mask )
+{
+  if ( infoWarningFilter( verbosity_r, mask ) )
+    return;
+
+  writeMessage( "info", msg );
+}
+
+void OutJSON::warning( const std::string & msg, Verbosity verbosity_r, Type mask )
+{
+  if ( infoWarningFilter( verbosity_r, mask ) )
+    return;
+
+  writeMessage( "warning", msg );
+}
+
+void OutJSON::error( const std::string & problem_desc, const std::string & hint )
+{
+  writeMessage( "error", problem_desc, hint );
+}
+
+void OutJSON::error( const zypp::Exception & e, const std::string & problem_desc, const std::string & hint )
+{
+  std::ostringstream s;
+
+  // problem
+  s << problem_desc << endl;
+  // cause
+  s << zyppExceptionReport( e );
+
+  writeMessage( "error", s.str(), hint );
+}
+
+void OutJSON::progressStart( const std::string & id, const std::string & label, bool has_range )
+{
+  if ( progressFilter() )
+    return;
+
+  Record record( "progress" );
+  record.add( "id", id ).add( "name", label );
+  if ( has_range )
+    record.add( "value", 0 );
+  writeRecord( cout, record );
+}
+
+void OutJSON::progress( const std::string & id, const std::string & label, int value )
+{
+  if ( progressFilter() )
+    return;
+
+  Record record( "progress" );
+  record.add( "id", id ).add( "name", label );
+  // missing value means 'is-alive' notification
+  if ( value >= 0 )
+    record.add( "value", value );
+  writeRecord( cout, record );
+}
+
+void OutJSON::progressEnd( const std::string & id, const std::string & label, const std::string & /*donetag*/, bool error )
+{
+  if ( progressFilter() )
+    return;
+
+  writeRecord( cout, Record( "progress-end" ).add( "id", id ).add( "name", label ).add( "success", !error ) );
+}
+
+void OutJSON::dwnldProgressStart( const Url & uri )
+{
+  writeRecord( cout, Record( "download" ).add( "url", uri.asString() ).add( "percent", -1 ).add( "rate", -1 ) );
+}
+
+void OutJSON::dwnldProgress( const Url & uri, int value, long rate )
+{
+  writeRecord( cout, Record( "download" ).add( "url", uri.asString() ).add( "percent", value ).add( "rate", rate ) );
+}
+
+void OutJSON::dwnldProgressEnd( const Url & uri, long rate, TriBool error )
+{
+  writeRecord( cout, Record( "download-end" ).add( "url", uri.asString() ).add( "rate", rate ).add( "success", bool(!error) ) );
+}
+
+void OutJSON::searchResultRow( std::ostream & str, const std::vector<std::string> & attributes_r, const TableRow & row_r )
+{
+  Record record( "solvable" );
+  const TableRow::container & cols( row_r.columns() );
+  for ( unsigned cidx = 0; cidx < cols.size(); ++cidx )
+  {
+    const std::string & key { cidx < attributes_r.size() ? attributes_r[cidx] : "?" };
+    if ( cidx == 0 )
+      record.add( key, OutXML::searchResultStatus( cols[cidx] ) );
+    else
+      record.add( key, cols[cidx] );
+  }
+  writeRecord( str, record );
+}
+
+void OutJSON::searchResult( const Table & table_r )
+{
+  const Table::container & rows( table_r.rows() );
+  if ( ! rows.empty() )
+  {
+    std::vector<std::string> attributes( OutXML::searchResultAttributes( table_r.header() ) );
+    for ( const TableRow & row : rows )
+      searchResultRow( cout, attributes, row );
+  }
+}
+
+void OutJSON::prompt( PromptId id, const std::string & prompt, const PromptOptions & poptions, const std::string & startdesc )
+{
+  Record record( "prompt" );
+  record.add( "id", unsigned(id) ).addIfNotEmpty( "description", startdesc ).add( "text", prompt );
+
+  std::vector<Record> options;
+  unsigned i = 0;
+  for ( PromptOptions::StrVector::const_iterator it = poptions.options().begin(); it != poptions.options().end(); ++it, ++i )
+  {
+    if ( poptions.isDisabled( i ) )
+      continue;
+    Record option;
+    option.add( "value", *it ).add( "desc", poptions.optionHelp( i ) );
+    if ( poptions.defaultOpt() == i )
+      option.add( "default", true );
+    options.push_back( std::move(option) );
+  }
+  record.add( "options", options );
+
+  // the reader must see it before we wait for the answer
+  writeRecord( cout, record );
+  cout << std::flush;
+}
+
+void OutJSON::promptHelp( const PromptOptions & poptions )
+{
+  // nothing to do here
+}
@@ -0,0 +1,130 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef OUTJSON_H_
+#define OUTJSON_H_
+
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <zypp/base/String.h>
+#include <zypp/sat/Solvable.h>
+
+#include "Out.h"
+#include "Table.h"
+
+///////////////////////////////////////////////////////////////////
+/// \class OutJSON
+/// \brief JSON lines output (--jsonout).
+///
+/// Each message, progress report, search result row, etc. is written as
+/// one self-contained JSON object per line, identified by its \c "type"
+/// member. Unlike \ref OutXML the stream is not flushed after each line,
+/// just before a prompt and when done.
+///
+/// The output type is neither \c TYPE_NORMAL nor \c TYPE_XML, so code
+/// testing for \c TYPE_XML writes plain text otherwise. Commands must
+/// test \ref typeJSON (or \c typeNORMAL) and write records instead. Only
+/// commands returning \c true from \ref ZypperBaseCommand::jsonOutput
+/// run with --jsonout.
+///////////////////////////////////////////////////////////////////
+class OutJSON : public Out
+{
+public:
+  ///////////////////////////////////////////////////////////////////
+  /// \class Record
+  /// \brief A JSON object collected member by member.
+  ///////////////////////////////////////////////////////////////////
+  class Record
+  {
+  public:
+    /** Ctor starting with a \c "type" member unless \a type_r is empty. */
+    explicit Record( const std::string & type_r = std::string() );
+
+    Record & add( const std::string & key_r, const std::string & value_r );
+    Record & add( const std::string & key_r, const char * value_r )
+    { return add( key_r, std::string( value_r ? value_r : "" ) ); }
+    Record & add( const std::string & key_r, bool value_r )
+    { return addRaw( key_r, value_r ? "true" : "false" ); }
+    template <class Tp, typename = std::enable_if_t<std::is_integral<Tp>::value && ! std::is_same<Tp,bool>::value>>
+    Record & add( const std::string & key_r, Tp value_r )
+    { return addRaw( key_r, zypp::str::numstring( value_r ) ); }
+    /** A nested record. */
+    Record & add( const std::string & key_r, const Record & record_r )
+    { return addRaw( key_r, record_r.asString() ); }
+    /** An array of strings. */
+    Record & add( const std::string & key_r, const std::vector<std::string> & values_r );
+    /** An array of nested records. */
+    Record & add( const std::string & key_r, const std::vector<Record> & records_r );
+
+    /** Add \a value_r unless it's empty. */
+    Record & addIfNotEmpty( const std::string & key_r, const std::string & value_r )
+    { return value_r.empty() ? *this : add( key_r, value_r ); }
+
+    /** Add \a json_r which must already be a valid JSON value. */
+    Record & addRaw( const std::string & key_r, const std::string & json_r );
+
+    /** Add the kind, name, edition, arch and repository (alias) of \a solv_r. */
+    Record & addSolvable( const zypp::sat::Solvable & solv_r );
+
+    /** The JSON object. */
+    std::string asString() const
+    { return _body + '}'; }
+
+  private:
+    std::string _body;
+  };
+
+public:
+  OutJSON( Verbosity verbosity );
+  ~OutJSON() override;
+
+  /** \a str_r as quoted JSON string. */
+  static std::string quote( const std::string & str_r );
+
+  /** Write \a record_r as one line to \a str_r. */
+  static void writeRecord( std::ostream & str_r, const Record & record_r );
+
+public:
+  void info( const std::string & msg, Verbosity verbosity, Type mask ) override;
+  void warning( const std::string & msg, Verbosity verbosity, Type mask ) override;
+  void error( const std::string & problem_desc, const std::string & hint ) override;
+  void error( const zypp::Exception & e, const std::string & problem_desc, const std::string & hint ) override;
+
+  // progress
+  void progressStart( const std::string & id, const std::string & label, bool is_tick ) override;
+  void progress( const std::string & id, const std::string & label, int value ) override;
+  void progressEnd( const std::string & id, const std::string & label, const std::string & donetag, bool error ) override;
+
+  // progress with download rate
+  void dwnldProgressStart( const zypp::Url & uri ) override;
+  void dwnldProgress( const zypp::Url & uri, int value, long rate ) override;
+  void dwnldProgressEnd( const zypp::Url & uri, long rate, zypp::TriBool error ) override;
+
+  void searchResult( const Table & table_r ) override;
+
+  /** Write a search result table row as \c "solvable" record (attributes as for \ref OutXML). */
+  static void searchResultRow( std::ostream & str, const std::vector<std::string> & attributes_r, const TableRow & row_r );
+
+  void prompt( PromptId id, const std::string & prompt, const PromptOptions & poptions, const std::string & startdesc ) override;
+
+  void promptHelp( const PromptOptions & poptions ) override;
+
+protected:
+  bool mine( Type type ) override;
+
+private:
+  bool infoWarningFilter( Verbosity verbosity, Type mask );
+  void writeMessage( const char * level_r, const std::string & text_r, const std::string & hint_r = std::string() );
+};
+
+/** Whether \a out_r writes JSON lines (\ref OutJSON). */
+inline bool typeJSON( const Out & out_r )
+{ return dynamic_cast<const OutJSON *>( &out_r ) != nullptr; }
+
+#endif /*OUTJSON_H_*/
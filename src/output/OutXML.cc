@@ -148,6 +148,56 @@ void OutXML::dwnldProgressEnd( const Url & uri, long rate, TriBool error )
     << "/>" << endl;
 }
 
+std::vector<std::string> OutXML::searchResultAttributes( const TableHeader & header_r )
+{
+  //
+  // *** CAUTION: It's a mess, but must match the header list defined
+  //              in SolvableTable::header (utils/SolvableTable.cc)
+  // We derive the XML tag from the header, applying some translation
+  // hence and there.
+  std::vector<std::string> ret;
+  for_( it, header_r.columnsNoTr().begin(), header_r.columnsNoTr().end() )
+  {
+    if ( *it == "S" )
+      ret.push_back( "status" );
+    else if ( *it == "Type" )
+      ret.push_back( "kind" );
+    else if ( *it == "Version" )
+      ret.push_back( "edition" );
+    else
+      ret.push_back( str::toLower( *it ) );
+  }
+  return ret;
+}
+
+const char * OutXML::searchResultStatus( const std::string & status_r )
+{
+  if ( status_r[0] == 'i' || status_r[0] == 'I' )	// test 1st char as locked is "iL"/"IL"
+    return "installed";
+  else if ( status_r[0] == 'v' )	// test 1st char as locked is "vL"
+    return "other-version";
+  return "not-installed";
+}
+
+void OutXML::searchResultRow( std::ostream & str, const std::vector<std::string> & attributes_r, const TableRow & row_r )
+{
+  str << "<solvable";
+  const TableRow::container & cols( row_r.columns() );
+  unsigned cidx = 0;
+  for_( cit, cols.begin(), cols.end() )
+  {
+    str << ' ' << (cidx < attributes_r.size() ? attributes_r[cidx] : "?" ) << "=\"";
+    if ( cidx == 0 )
+      str << searchResultStatus( *cit ) << '"';
+    else
+    {
+      str << xml::escape(*cit) << '"';
+    }
+    ++cidx;
+  }
+  str << "/>" << endl;
+}
+
 void OutXML::searchResult(const Table &table_r )
 {
   cout << "<search-result version=\"0.0\">" << endl;
@@ -156,52 +206,9 @@ void OutXML::searchResult(const Table &table_r )
   const Table::container & rows( table_r.rows() );
   if ( ! rows.empty() )
   {
-    //
-    // *** CAUTION: It's a mess, but must match the header list defined
-    //              in FillSearchTableSolvable ctor (search.cc)
-    // We derive the XML tag from the header, applying some translation
-    // hence and there.
-    std::vector<std::string> header;
-    {
-      const TableHeader & theader( table_r.header() );
-      for_( it, theader.columnsNoTr().begin(), theader.columnsNoTr().end() )
-      {
-        if ( *it == "S" )
-          header.push_back( "status" );
-        else if ( *it == "Type" )
-          header.push_back( "kind" );
-        else if ( *it == "Version" )
-          header.push_back( "edition" );
-        else
-          header.push_back( str::toLower( *it ) );
-      }
-    }
-
+    std::vector<std::string> attributes( searchResultAttributes( table_r.header() ) );
     for_( it, rows.begin(), rows.end() )
-    {
-      cout << "<solvable";
-      const TableRow::container & cols( it->columns() );
-      unsigned cidx = 0;
-      for_( cit, cols.begin(), cols.end() )
-      {
-        cout << ' ' << (cidx < header.size() ? header[cidx] : "?" ) << "=\"";
-        if ( cidx == 0 )
-        {
-          if ( (*cit)[0] == 'i' || (*cit)[0] == 'I' )	// test 1st char as locked is "iL"/"IL"
-            cout << "installed\"";
-          else if ( (*cit)[0] == 'v' )	// test 1st char as locked is "vL"
-            cout << "other-version\"";
-          else
-            cout << "not-installed\"";
-        }
-        else
-        {
-          cout << xml::escape(*cit) << '"';
-        }
-        ++cidx;
-      }
-      cout << "/>" << endl;
-    }
+      searchResultRow( cout, attributes, *it );
   }
     //Out::searchResult( table_r );
 
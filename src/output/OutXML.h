@@ -28,6 +28,13 @@ public:
 
   void searchResult( const Table & table_r ) override;
 
+  /** The \c <solvable> attribute names for the columns of a search result table. */
+  static std::vector<std::string> searchResultAttributes( const TableHeader & header_r );
+  /** The \c status attribute for a search result tables status column. */
+  static const char * searchResultStatus( const std::string & status_r );
+  /** Write a search result table row as \c <solvable> element. */
+  static void searchResultRow( std::ostream & str, const std::vector<std::string> & attributes_r, const TableRow & row_r );
+
   void prompt( PromptId id, const std::string & prompt, const PromptOptions & poptions, const std::string & startdesc ) override;
 
   void promptHelp( const PromptOptions & poptions ) override;
@@ -5,11 +5,15 @@
                              |__/|_|  |_|
 \*---------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <optional>
 #include <iterator>
 #include <list>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <zypp/ZYpp.h>
 #include <zypp/base/Logger.h>
@@ -30,6 +34,10 @@
 #include "utils/messages.h"
 #include "utils/misc.h"
 #include "utils/prompt.h"
+#include "utils/ParallelJobs.h"
+#include "utils/Profile.h"
+#include "utils/SearchIndex.h"
+#include "utils/ServiceRefreshCache.h"
 #include "repos.h"
 #include "global-settings.h"
 
@@ -133,6 +141,41 @@ const char * repoAutorefreshStr( const repo::RepoInfoBase & repo_r )
 
 // ----------------------------------------------------------------------------
 
+OutJSON::Record repoJSONRecord( const RepoInfo & repo_r )
+{
+  std::vector<std::string> urls;
+  for ( const Url & url : repo_r.baseUrls() )
+    urls.push_back( url.asString() );
+
+  OutJSON::Record record( "repo" );
+  record.add( "alias", repo_r.alias() )
+        .add( "name", repo_r.name() )
+        .add( "type", repo_r.type().asString() )
+        .add( "priority", repo_r.priority() )
+        .add( "enabled", repo_r.enabled() )
+        .add( "autorefresh", repo_r.autorefresh() )
+        .add( "gpgcheck", repo_r.gpgCheck() )
+        .add( "keeppackages", repo_r.keepPackages() )
+        .addIfNotEmpty( "service", repo_r.service() )
+        .add( "url", urls )
+        .addIfNotEmpty( "mirrorlist", repo_r.mirrorListUrl().asString() );
+  return record;
+}
+
+OutJSON::Record serviceJSONRecord( const ServiceInfo & service_r )
+{
+  OutJSON::Record record( "service" );
+  record.add( "alias", service_r.alias() )
+        .add( "name", service_r.name() )
+        .add( "type", service_r.type().asString() )
+        .add( "enabled", service_r.enabled() )
+        .add( "autorefresh", service_r.autorefresh() )
+        .add( "url", service_r.url().asString() );
+  return record;
+}
+
+// ----------------------------------------------------------------------------
+
 unsigned parse_priority( const std::string &prio_r, std::string &error_r )
 {
   //! \todo use some preset priorities (high, medium, low, ...)
@@ -240,8 +283,138 @@ void repoPrioSummary( Zypper & zypper )
 
 // ----------------------------------------------------------------------------
 
+// bsc#1123967: MediaChangeReport is temporarily disconnected while refreshing
+#define DISABLE_ScopedDisableMediaChangeReport_GUARD
+
+namespace
+{
+  /** Check the repos baseurls (the first one which is accessible) whether a refresh is needed.
+   * \throws if no baseurl is accessible
+   */
+  RepoManager::RefreshCheckStatus checkIfToRefreshMetadata( Zypper & zypper, const RepoInfo & repo )
+  {
+    RepoManager & manager = zypper.repoManager();
+#ifndef DISABLE_ScopedDisableMediaChangeReport_GUARD
+    Disabled because of fix for bsc#1123967
+    // Suppress (interactive) media::MediaChangeReport if we in have multiple basurls (>1)
+    media::ScopedDisableMediaChangeReport guard( repo.baseUrlsSize() > 1 );
+#endif
+
+    for ( RepoInfo::urls_const_iterator it = repo.baseUrlsBegin(); it != repo.baseUrlsEnd(); )
+    {
+      try
+      {
+        return manager.checkIfToRefreshMetadata( repo, *it,
+                zypper.command() == ZypperCommand::REFRESH ||
+                zypper.command() == ZypperCommand::REFRESH_SERVICES ?
+                  RepoManager::RefreshIfNeededIgnoreDelay :
+                  RepoManager::RefreshIfNeeded );
+        // don't check all the urls, just the first successful.
+      }
+      catch ( const Exception & e )
+      {
+        ZYPP_CAUGHT( e );
+        Url badurl( *it );
+        if ( ++it == repo.baseUrlsEnd() )
+          ZYPP_RETHROW( e );
+        ERR << badurl << " doesn't look good. Trying another url (" << *it << ")." << endl;
+      }
+    }
+    return RepoManager::REPO_UP_TO_DATE;	// no baseurls: nothing to check
+  }
+
+  /** Tell the user why a repo is not refreshed (refresh commands only). */
+  void reportNoRefreshNeeded( Zypper & zypper, const RepoInfo & repo, RepoManager::RefreshCheckStatus stat )
+  {
+    if ( zypper.command() != ZypperCommand::REFRESH && zypper.command() != ZypperCommand::REFRESH_SERVICES )
+      return;
+
+    switch ( stat )
+    {
+      case RepoManager::REPO_UP_TO_DATE:
+      {
+        TermLine outstr( TermLine::SF_SPLIT | TermLine::SF_EXPAND );
+        outstr.lhs << str::Format(_("Repository '%s' is up to date.")) % repo.asUserString();
+        //outstr.rhs << repoGpgCheckStatus( repo );
+        zypper.out().infoLine( outstr );
+      }
+      break;
+      case RepoManager::REPO_CHECK_DELAYED:
+        zypper.out().info( str::Format(_("The up-to-date check of '%s' has been delayed.")) % repo.asUserString(),
+                           Out::HIGH );
+      break;
+      default:
+        WAR << "new item in enum, which is not covered" << endl;
+    }
+  }
+} // namespace
+
+void prefetch_raw_metadata( Zypper & zypper, const std::list<RepoInfo> & repos, bool force_download, unsigned jobs )
+{
+  if ( jobs <= 1 || geteuid() != 0 )
+    return;
+  Profile::Phase phase { "repo refresh" };
+
+  // Only remote repos benefit. Anything else (and anything the workers
+  // fail to do) is refreshed the usual way.
+  std::vector<RepoInfo> candidates;
+  for ( const RepoInfo & repo : repos )
+  {
+    if ( repo.baseUrlsEmpty() || ! repo.url().schemeIsDownloading() )
+      continue;
+    candidates.push_back( repo );
+  }
+  if ( candidates.size() <= 1 )
+    return;
+
+  MIL << "Prefetching raw metadata of " << candidates.size() << " repos (" << jobs << " jobs)" << endl;
+  zypper.out().info( str::Format(_("Checking %1% repositories for updated metadata in parallel...")) % candidates.size(),
+                     Out::HIGH );
+
+  ParallelJobs workers( jobs );
+  for ( const RepoInfo & repo : candidates )
+  {
+    workers.add( [&zypper,repo,force_download]() -> int
+    {
+      // Workers must not prompt. Anything requiring user interaction lets
+      // the job fail and the repo is refreshed the usual way afterwards.
+      Config & config( zypper.configNoConst() );
+      config.non_interactive = true;
+      config.gpg_auto_import_keys = false;
+      config.no_gpg_checks = false;
+      callback::TempConnect<zypp::media::MediaChangeReport> tempDisconnect;
+
+      RepoManager::RefreshCheckStatus stat = RepoManager::REFRESH_NEEDED;
+      if ( ! force_download )
+        stat = checkIfToRefreshMetadata( zypper, repo );
+      if ( stat == RepoManager::REFRESH_NEEDED )
+        zypper.repoManager().refreshMetadata( repo, RepoManager::RefreshForced );
+      return stat;
+    } );
+  }
+
+  std::vector<int> results( workers.run() );
+  RuntimeData & gData( zypper.runtimeData() );
+  for ( unsigned i = 0; i < candidates.size(); ++i )
+  {
+    const RepoInfo & repo( candidates[i] );
+    switch ( results[i] )
+    {
+      case RepoManager::REFRESH_NEEDED:
+      case RepoManager::REPO_UP_TO_DATE:
+      case RepoManager::REPO_CHECK_DELAYED:
+        gData.prefetched_raw_metadata[repo.alias()] = RepoManager::RefreshCheckStatus( results[i] );
+        break;
+      default:
+        MIL << "Prefetching " << repo.alias() << " failed. Will retry." << endl;
+        break;
+    }
+  }
+}
+
 bool refresh_raw_metadata( Zypper & zypper, const RepoInfo & repo, bool force_download )
 {
+  Profile::Phase phase { "repo refresh" };
   RuntimeData & gData( zypper.runtimeData() );
   gData.current_repo = repo;
   bool do_refresh = false;
@@ -254,9 +427,16 @@ bool refresh_raw_metadata( Zypper & zypper, const RepoInfo & repo, bool force_do
 
   RepoManager & manager = zypper.repoManager();
 
+  // Metadata may have already been checked and downloaded by a worker (see prefetch_raw_metadata)
+  std::optional<RepoManager::RefreshCheckStatus> prefetched;
+  if ( auto it = gData.prefetched_raw_metadata.find( repo.alias() ); it != gData.prefetched_raw_metadata.end() )
+  {
+    prefetched = it->second;
+    gData.prefetched_raw_metadata.erase( it );
+  }
+
   // bsc#1123967
   // Temporarily disconnect, if errors happen we just skip the repository
-#define DISABLE_ScopedDisableMediaChangeReport_GUARD
   callback::TempConnect<zypp::media::MediaChangeReport> tempDisconnect;
 
   try
@@ -267,57 +447,18 @@ bool refresh_raw_metadata( Zypper & zypper, const RepoInfo & repo, bool force_do
       // print a message
       zypper.out().info( str::Format(_("Checking whether to refresh metadata for %s")) % repo.asUserString(),
                          Out::HIGH );
-      if ( !repo.baseUrlsEmpty() )
+      if ( prefetched )
       {
-#ifndef DISABLE_ScopedDisableMediaChangeReport_GUARD
-        Disabled because of fix for bsc#1123967
-        // Suppress (interactive) media::MediaChangeReport if we in have multiple basurls (>1)
-        media::ScopedDisableMediaChangeReport guard( repo.baseUrlsSize() > 1 );
-#endif
-
-        for ( RepoInfo::urls_const_iterator it = repo.baseUrlsBegin(); it != repo.baseUrlsEnd(); )
-        {
-          try
-          {
-            RepoManager::RefreshCheckStatus stat = manager.checkIfToRefreshMetadata( repo, *it,
-                  zypper.command() == ZypperCommand::REFRESH ||
-                  zypper.command() == ZypperCommand::REFRESH_SERVICES ?
-                    RepoManager::RefreshIfNeededIgnoreDelay :
-                    RepoManager::RefreshIfNeeded );
-
-            do_refresh = ( stat == RepoManager::REFRESH_NEEDED );
-            if ( !do_refresh
-              && ( zypper.command() == ZypperCommand::REFRESH || zypper.command() == ZypperCommand::REFRESH_SERVICES ) )
-            {
-              switch ( stat )
-              {
-              case RepoManager::REPO_UP_TO_DATE:
-              {
-                TermLine outstr( TermLine::SF_SPLIT | TermLine::SF_EXPAND );
-                outstr.lhs << str::Format(_("Repository '%s' is up to date.")) % repo.asUserString();
-                //outstr.rhs << repoGpgCheckStatus( repo );
-                zypper.out().infoLine( outstr );
-              }
-              break;
-              case RepoManager::REPO_CHECK_DELAYED:
-                zypper.out().info( str::Format(_("The up-to-date check of '%s' has been delayed.")) % repo.asUserString(),
-                                   Out::HIGH );
-              break;
-              default:
-                WAR << "new item in enum, which is not covered" << endl;
-              }
-            }
-            break; // don't check all the urls, just the first successful.
-          }
-          catch ( const Exception & e )
-          {
-            ZYPP_CAUGHT( e );
-            Url badurl( *it );
-            if ( ++it == repo.baseUrlsEnd() )
-              ZYPP_RETHROW( e );
-            ERR << badurl << " doesn't look good. Trying another url (" << *it << ")." << endl;
-          }
-        }
+        do_refresh = ( *prefetched == RepoManager::REFRESH_NEEDED );
+        if ( !do_refresh )
+          reportNoRefreshNeeded( zypper, repo, *prefetched );
+      }
+      else if ( !repo.baseUrlsEmpty() )
+      {
+        RepoManager::RefreshCheckStatus stat = checkIfToRefreshMetadata( zypper, repo );
+        do_refresh = ( stat == RepoManager::REFRESH_NEEDED );
+        if ( !do_refresh )
+          reportNoRefreshNeeded( zypper, repo, stat );
       }
     }
     else
@@ -334,7 +475,8 @@ bool refresh_raw_metadata( Zypper & zypper, const RepoInfo & repo, bool force_do
       // RepoManager::RefreshForced because we already know from checkIfToRefreshMetadata above
       // that refresh is needed (or forced anyway). Forcing here prevents refreshMetadata from
       // doing it's own checkIfToRefreshMetadata. Otherwise we'd download the stats twice.
-      manager.refreshMetadata( repo, RepoManager::RefreshForced );
+      if ( !prefetched )
+        manager.refreshMetadata( repo, RepoManager::RefreshForced );
 
       //plabel += repoGpgCheckStatus( repo );
       zypper.out().progressEnd( "raw-refresh", plabel );
@@ -451,11 +593,77 @@ bool refresh_raw_metadata( Zypper & zypper, const RepoInfo & repo, bool force_do
 
 // ---------------------------------------------------------------------------
 
+namespace
+{
+  /** The size of the raw metadata below \a dir_r (estimates the cache build time). */
+  off_t rawMetadataSize( const Pathname & dir_r )
+  {
+    off_t ret = 0;
+    filesystem::dirForEach( dir_r, [&ret]( const Pathname & dir, const char * name_r ) -> bool {
+      PathInfo pi( dir / name_r, PathInfo::LSTAT );
+      if ( pi.isDir() )
+        ret += rawMetadataSize( pi.path() );
+      else if ( pi.isFile() )
+        ret += pi.size();
+      return true;
+    } );
+    return ret;
+  }
+} // namespace
+
+void prebuild_caches( Zypper & zypper, const std::list<RepoInfo> & repos, bool force_build, unsigned jobs )
+{
+  jobs = std::min( jobs, ParallelJobs::onlineCPUs() );
+  if ( jobs <= 1 || repos.size() <= 1 || geteuid() != 0 )
+    return;
+  Profile::Phase phase { "cache build" };
+
+  // Largest first, so the slowest conversion does not start last.
+  std::vector<std::pair<off_t,RepoInfo>> candidates;
+  for ( const RepoInfo & repo : repos )
+    candidates.push_back( { rawMetadataSize( repo.metadataPath() ), repo } );
+  std::stable_sort( candidates.begin(), candidates.end(), []( const auto & lhs, const auto & rhs ) {
+    return lhs.first > rhs.first;
+  } );
+
+  MIL << "Prebuilding the caches of " << candidates.size() << " repos (" << jobs << " jobs)" << endl;
+  zypper.out().info( str::Format(_("Building the caches of %1% repositories in parallel...")) % candidates.size(),
+                     Out::HIGH );
+
+  ParallelJobs workers( jobs );
+  for ( const auto & candidate : candidates )
+  {
+    DBG << candidate.second.alias() << ": " << candidate.first << " bytes of raw metadata" << endl;
+    workers.add( [&zypper,repo=candidate.second,force_build]() -> int
+    {
+      zypper.repoManager().buildCache( repo, force_build ? RepoManager::BuildForced : RepoManager::BuildIfNeeded );
+      return 0;
+    } );
+  }
+
+  std::vector<int> results( workers.run() );
+  RuntimeData & gData( zypper.runtimeData() );
+  for ( unsigned i = 0; i < candidates.size(); ++i )
+  {
+    const RepoInfo & repo( candidates[i].second );
+    if ( results[i] == 0 )
+      gData.prebuilt_caches.insert( repo.alias() );
+    else
+      MIL << "Prebuilding " << repo.alias() << " failed. Will retry." << endl;
+  }
+}
+
 bool build_cache( Zypper & zypper, const RepoInfo & repo, bool force_build )
 {
+  Profile::Phase phase { "cache build" };
   if ( force_build )
     zypper.out().info(_("Forcing building of repository cache") );
 
+  // A worker has already built it (see prebuild_caches). Just check the
+  // cookie; the raw metadata may have changed since then.
+  if ( zypper.runtimeData().prebuilt_caches.erase( repo.alias() ) )
+    force_build = false;
+
   try
   {
     RepoManager & manager = zypper.repoManager();
@@ -472,6 +680,9 @@ bool build_cache( Zypper & zypper, const RepoInfo & repo, bool force_build )
       && ( zypper.command() == ZypperCommand::REFRESH || zypper.command() == ZypperCommand::REFRESH_SERVICES) )
     {
       manager.loadFromCache( repo );
+      zypper.poolState().setRepoLoaded( zypper, repo );
+      if ( SearchIndex::enabled() && geteuid() == 0 )
+        SearchIndex::update( sat::Pool::instance().reposFind( repo.alias() ) );
     }
   }
   catch ( const parser::ParseException & e )
@@ -764,11 +975,20 @@ void do_init_repos( Zypper & zypper )
   {
     MIL << "Refreshing autorefresh services." << endl;
 
+    // Services refreshed recently are skipped (zypper.conf: main.serviceRefreshTTL)
+    Date::Duration ttl { Date::Duration(zypper.config().service_refreshTTL) * Date::minute };
+    ServiceRefreshCache cache( ttl ? ServiceRefreshCache::defaultFile( zypper.config().rm_options.knownServicesPath ) : Pathname() );
+
     const std::list<ServiceInfo> & services( zypper.repoManager().knownServices() );
     for_( s, services.begin(), services.end() )
     {
       if ( s->enabled() && s->autorefresh() )
       {
+        if ( cache.isFresh( *s, ttl ) )
+        {
+          DBG << "Service '" << s->alias() << "' was refreshed recently, skipping." << endl;
+          continue;
+        }
         //@TODO MICHAEL is this correct?
         refresh_service( zypper, *s );
       }
@@ -870,6 +1090,18 @@ void do_init_repos( Zypper & zypper )
       ++it;
   }
 
+  if ( geteuid() == 0 && !zypper.config().no_refresh )
+  {
+    std::list<RepoInfo> autorefresh;
+    for ( const RepoInfo & repo : gData.repos )
+    {
+      if ( repo.enabled() && repo.autorefresh() )
+        autorefresh.push_back( repo );
+    }
+    prefetch_raw_metadata( zypper, autorefresh, false, zypper.config().refresh_jobs );
+    prebuild_caches( zypper, autorefresh, false, zypper.config().refresh_jobs );
+  }
+
   unsigned skip_count = 0;
   for ( std::list<RepoInfo>::iterator it = gData.repos.begin(); it !=  gData.repos.end(); ++it )
   {
@@ -1016,6 +1248,9 @@ void do_init_repos( Zypper & zypper )
     }
   }
 
+  gData.prefetched_raw_metadata.clear();
+  gData.prebuilt_caches.clear();
+
   if ( noUserRefresh ) {
     zypper.out().info( str::Str() << *mdstats );
   }
@@ -1049,15 +1284,14 @@ void do_init_repos( Zypper & zypper )
  */
 void init_repos( Zypper & zypper )
 {
-  static bool done = false;
-  //! \todo this has to be done so that it works in zypper shell
-  if ( done )
+  // in the shell: until the repo configuration changes
+  if ( zypper.poolState().reposInitialized() )
     return;
 
   if ( !zypper.config().disable_system_sources )
     do_init_repos( zypper );
 
-  done = true;
+  zypper.poolState().setReposInitialized( zypper );
 }
 
 // ----------------------------------------------------------------------------
@@ -1069,6 +1303,7 @@ void init_target( Zypper & zypper )
   {
     MIL << "Initializing target" << endl;
     zypper.out().info(_("Initializing Target"), Out::HIGH );
+    Profile::Phase phase { "target init" };
 
     try
     {
@@ -1832,26 +2067,56 @@ void checkIfToRefreshPluginServices(Zypper & zypper, RepoManager::RefreshService
 
 void load_resolvables( Zypper & zypper )
 {
-  static bool done = false;
-  // don't call this function more than once for a single ZYpp instance
-  // (e.g. in shell)
-  if ( done )
+  // In the shell the resolvables stay loaded until PoolState::reloadChanged
+  // notices a change on disk.
+  bool loadTarget = !zypper.config().disable_system_resolvables && !zypper.poolState().targetLoaded();
+  if ( zypper.poolState().reposLoaded() && !loadTarget )
     return;
 
   MIL << "Going to load resolvables" << endl;
 
+  // Let a worker update the rpmdb solv cache (rpmdb2solv) while the repos
+  // are loaded. Target::load then just loads the solv file. This does not
+  // work for non-root users, as their solv cache is a private tmpdir.
+  std::unique_ptr<BackgroundJob> targetCacheJob;
+  if ( loadTarget && geteuid() == 0 && God->getTarget() )
+  {
+    targetCacheJob.reset( new BackgroundJob( []() -> int {
+      God->target()->buildCache();
+      return 0;
+    } ) );
+  }
+
   load_repo_resolvables( zypper );
-  if ( !zypper.config().disable_system_resolvables )
+  if ( targetCacheJob && targetCacheJob->wait() != 0 )
+    MIL << "Building the rpmdb cache in the background failed. Will retry." << endl;
+  if ( loadTarget )
     load_target_resolvables( zypper );
 
-  done = true;
   MIL << "Done loading resolvables" << endl;
 }
 
 // ---------------------------------------------------------------------------
 
+namespace
+{
+  /** Initiate a nonblocking read of \a file_r into the page cache. */
+  void adviseWillNeed( const Pathname & file_r )
+  {
+    int fd = ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC );
+    if ( fd == -1 )
+      return;	// not cached (yet)
+    ::posix_fadvise( fd, 0, 0, POSIX_FADV_WILLNEED );
+    ::close( fd );
+  }
+} // namespace
+
 void load_repo_resolvables( Zypper & zypper )
 {
+  if ( zypper.poolState().reposLoaded() )
+    return;
+
+  Profile::Phase phase { "solv load" };
   RepoManager & manager = zypper.repoManager();
   RuntimeData & gData = zypper.runtimeData();
 
@@ -1859,6 +2124,14 @@ void load_repo_resolvables( Zypper & zypper )
   if ( gData.repos.empty() )
     zypper.out().warning(_("No repositories defined. Operating only with the installed resolvables. Nothing can be installed.") );
 
+  // Ask the kernel to start reading all solv files now, rather than one
+  // after the other as the repos are loaded.
+  for ( const RepoInfo & repo : gData.repos )
+  {
+    if ( repo.enabled() )
+      adviseWillNeed( zypper.config().rm_options.repoSolvCachePath / repo.escaped_alias() / "solv" );
+  }
+
   bool hintExpired = false;
   for_( it, gData.repos.begin(), gData.repos.end() )
   {
@@ -1904,6 +2177,7 @@ void load_repo_resolvables( Zypper & zypper )
       }
 
       manager.loadFromCache( repo );
+      zypper.poolState().setRepoLoaded( zypper, repo );
 
       // check that the metadata is not outdated
       // feature #301904
@@ -1912,6 +2186,11 @@ void load_repo_resolvables( Zypper & zypper )
       // index is sometimes slow, so we avoid this overhead by directly accessing
       // the sat::Pool.
       Repository robj = sat::Pool::instance().reposFind( repo.alias() );
+
+      // (re)build an outdated search index (e.g. after autorefresh)
+      if ( SearchIndex::enabled() && geteuid() == 0 )
+        SearchIndex::update( robj );
+
       if ( robj != Repository::noRepository && robj.maybeOutdated() )
       {
         zypper.out().warning( str::Format(_("Repository '%1%' metadata expired since %2%."))
@@ -1930,6 +2209,8 @@ void load_repo_resolvables( Zypper & zypper )
       zypper.out().info( str::Format(_("Resolvables from '%s' not loaded because of error.")) % repo.asUserString() );
     }
   }
+  zypper.poolState().setReposLoaded();
+
   if ( hintExpired ) {
     Zypper::instance().out().warningPar( 4, _("Repository metadata expired: "
     "Check if 'autorefresh' is turned on (zypper lr), otherwise manually refresh the repository (zypper ref). "
@@ -1943,12 +2224,17 @@ void load_repo_resolvables( Zypper & zypper )
 
 void load_target_resolvables(Zypper & zypper)
 {
+  if ( zypper.poolState().targetLoaded() )
+    return;
+
   MIL << "Going to read RPM database" << endl;
+  Profile::Phase phase { "rpmdb load" };
   zypper.out().info( _("Reading installed packages...") );
 
   try
   {
     God->target()->load();
+    zypper.poolState().setTargetLoaded( zypper );
   }
   catch ( const Exception & e )
   {
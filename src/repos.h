@@ -18,6 +18,7 @@
 #include <zypp/ServiceInfo.h>
 
 #include "Zypper.h"
+#include "output/OutJSON.h"
 #include "commands/reposerviceoptionsets.h"
 
 #define  TMP_RPM_REPO_ALIAS  "_tmpRPMcache_"
@@ -211,6 +212,12 @@ ColorString repoPriorityNumberAnnotated( unsigned prio_r, int width_r = 0 );
 
 const char * repoAutorefreshStr( const repo::RepoInfoBase & repo_r );
 
+/** The \c "repo" record of \a repo_r (--jsonout); the members follow the XML \c <repo> element. */
+OutJSON::Record repoJSONRecord( const RepoInfo & repo_r );
+
+/** The \c "service" record of \a service_r (--jsonout); the members follow the XML \c <service> element. */
+OutJSON::Record serviceJSONRecord( const ServiceInfo & service_r );
+
 /** \return true if aliases are equal, and all lhs urls can be found in rhs */
 bool repo_cmp_alias_urls( const RepoInfo & lhs, const RepoInfo & rhs );
 
@@ -218,6 +225,29 @@ void repoPrioSummary( Zypper & zypper );
 
 bool refresh_raw_metadata( Zypper & zypper, const RepoInfo & repo, bool force_download );
 
+/**
+ * Check and download the raw metadata of remote \a repos concurrently in
+ * up to \a jobs worker processes (zypper.conf: main.refreshJobs).
+ *
+ * The results are remembered in \ref RuntimeData::prefetched_raw_metadata
+ * and picked up by the following \ref refresh_raw_metadata calls, which
+ * report them as usual. Repos the workers could not handle (e.g. because
+ * user interaction is needed) are left to \ref refresh_raw_metadata.
+ */
+void prefetch_raw_metadata( Zypper & zypper, const std::list<RepoInfo> & repos, bool force_download, unsigned jobs );
+
+/**
+ * Build the solv caches of \a repos concurrently in up to \a jobs worker
+ * processes (at most one per online CPU).
+ *
+ * Converting the raw metadata is CPU bound, so the repos with the most raw
+ * metadata are started first. The repos built are remembered in
+ * \ref RuntimeData::prebuilt_caches and the following \ref build_cache
+ * calls just check and report them in the usual order. Repos the workers
+ * failed to build are left to \ref build_cache.
+ */
+void prebuild_caches( Zypper & zypper, const std::list<RepoInfo> & repos, bool force_build, unsigned jobs );
+
 bool build_cache( Zypper & zypper, const RepoInfo & repo, bool force_build );
 
 /**
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <algorithm>
 
 #include <zypp/ZYpp.h> // for ResPool::instance()
 
@@ -17,6 +18,8 @@
 #include "main.h"
 #include "utils/misc.h"
 #include "global-settings.h"
+#include "output/OutJSON.h"
+#include "output/OutXML.h"
 
 #include "search.h"
 
@@ -26,7 +29,7 @@ extern ZYpp::Ptr God;
 // class FillSearchTableSolvable
 ///////////////////////////////////////////////////////////////////
 
-FillSearchTableSolvable::FillSearchTableSolvable( Table & table_r, TriBool instNotinst_r )
+FillSearchTableSolvable::FillSearchTableSolvable( SolvableTable & table_r, TriBool instNotinst_r )
 : _table( &table_r )
 , _instNotinst( instNotinst_r )
 {
@@ -41,19 +44,8 @@ FillSearchTableSolvable::FillSearchTableSolvable( Table & table_r, TriBool instN
   // *** CAUTION: It's a mess, but adding/changing colums here requires
   //              adapting OutXML::searchResult !
   //
-  *_table << ( TableHeader()
-          // translators: S for 'installed Status'
-          << N_("S")
-          // translators: name (general header)
-          << table::Column( N_("Name"), table::CStyle::SortCi )
-          // translators: type (general header)
-          << N_("Type")
-          // translators: package version (header)
-          << table::Column( N_("Version"), table::CStyle::Edition )
-          // translators: package architecture (header)
-          << N_("Arch")
-          // translators: package's repository (header)
-          << N_("Repository") );
+  _table->setColumns( { SolvableTable::Status, SolvableTable::Name, SolvableTable::Kind, SolvableTable::Edition, SolvableTable::Arch, SolvableTable::Repository },
+                      std::string("(") + _("System Packages") + ")" );
 }
 
 bool FillSearchTableSolvable::operator()( const PoolItem & pi_r ) const
@@ -88,20 +80,7 @@ bool FillSearchTableSolvable::operator()( const PoolItem & pi_r ) const
       return false;
   }
 
-  TableRow row;
-  row
-    << statusIndicator
-    << pi_r->name()
-    << kind_to_string_localized( pi_r->kind(), 1 )
-    << pi_r->edition().asString()
-    << pi_r->arch().asString()
-    << ( pi_r->isSystem()
-       ? (std::string("(") + _("System Packages") + ")")
-       : pi_r->repository().asUserString() );
-
-  row.userData( SolvableCSI(pi_r.satSolvable(), picklistPos) );
-
-  *_table << std::move(row);
+  _table->add( pi_r.satSolvable(), statusIndicator, picklistPos );
 
   return true;	// actually added a row
 }
@@ -115,14 +94,21 @@ bool FillSearchTableSolvable::operator()( const PoolQuery::const_iterator & it_r
     return false;	// no row was added due to filter
 
   // add the details about matches to last row
-  TableRow & lastRow( _table->rows().back() );
+  for ( std::string & detail : matchDetails( it_r ) )
+    _table->addDetail( std::move(detail) );
+  return true;
+}
+
+std::vector<std::string> FillSearchTableSolvable::matchDetails( const PoolQuery::const_iterator & it_r )
+{
+  std::vector<std::string> ret;
 
   // don't show details for patterns with user visible flag not set (bnc #538152)
   if ( it_r->kind() == ResKind::pattern )
   {
     Pattern::constPtr ptrn = asKind<Pattern>(*it_r);
     if ( ptrn && !ptrn->userVisible() )
-      return true;
+      return ret;
   }
 
   if ( !it_r.matchesEmpty() )
@@ -134,21 +120,21 @@ bool FillSearchTableSolvable::operator()( const PoolQuery::const_iterator & it_r
            match->inSolvAttr() == sat::SolvAttr::description )
       {
         // multiline matchstring
-        lastRow.addDetail( attrib + ":" );
-        lastRow.addDetail( match->asString() );
+        ret.push_back( attrib + ":" );
+        ret.push_back( match->asString() );
       }
       else
       {
         // print attribute and match in one line, e.g. requires: libzypp >= 11.6.2
-        lastRow.addDetail( attrib + ": " + match->asString() );
+        ret.push_back( attrib + ": " + match->asString() );
       }
     }
   }
-  return true;
+  return ret;
 }
 
 
-std::string FillSearchTableSolvable::attribStr(  const sat::SolvAttr &attr  ) const
+std::string FillSearchTableSolvable::attribStr(  const sat::SolvAttr &attr  )
 {
   std::string attrib( attr.asString() );
   if ( str::startsWith( attrib, "solvable:" ) )	// strip 'solvable:' from attribute
@@ -163,28 +149,35 @@ bool FillSearchTableSolvable::operator()(const sat::Solvable &solv_r, const sat:
     return false;	// no row was added due to filter
 
   // add the details about matches to last row
-  TableRow & lastRow( _table->rows().back() );
+  for ( std::string & detail : matchDetails( solv_r, searchedAttr, matchedAttribs ) )
+    _table->addDetail( std::move(detail) );
+  return true;
+}
+
+std::vector<std::string> FillSearchTableSolvable::matchDetails( const sat::Solvable &solv_r, const sat::SolvAttr &searchedAttr, const CapabilitySet &matchedAttribs )
+{
+  std::vector<std::string> ret;
 
   // don't show details for patterns with user visible flag not set (bnc #538152)
   if ( solv_r.kind() == ResKind::pattern )
   {
     Pattern::constPtr ptrn = asKind<Pattern>(solv_r);
     if ( ptrn && !ptrn->userVisible() )
-      return true;
+      return ret;
   }
 
   auto attrStr = attribStr( searchedAttr );
 
   for ( const auto &cap : matchedAttribs ) {
-    lastRow.addDetail( attrStr +": " + cap.asString() );
+    ret.push_back( attrStr +": " + cap.asString() );
   }
 
-  return true;
+  return ret;
 }
 
 ///////////////////////////////////////////////////////////////////
 
-FillSearchTableSelectable::FillSearchTableSelectable( Table & table, TriBool installed_only )
+FillSearchTableSelectable::FillSearchTableSelectable( SolvableTable & table, TriBool installed_only )
 : _table( &table )
 , _instNotinst( installed_only )
 , _tagForeign( InitRepoSettings::instance()._repoFilter.size() )
@@ -193,13 +186,7 @@ FillSearchTableSelectable::FillSearchTableSelectable( Table & table, TriBool ins
   // *** CAUTION: It's a mess, but adding/changing colums here requires
   //              adapting OutXML::searchResult !
   //
-  *_table << ( TableHeader()
-          // translators: S for installed Status
-          << N_("S")
-          << table::Column( N_("Name"), table::CStyle::SortCi )
-          // translators: package summary (header)
-          << N_("Summary")
-          << N_("Type") );
+  _table->setColumns( { SolvableTable::Status, SolvableTable::Name, SolvableTable::Summary, SolvableTable::Kind } );
 }
 
 bool FillSearchTableSelectable::operator()( const ui::Selectable::constPtr & s ) const
@@ -225,16 +212,119 @@ bool FillSearchTableSelectable::operator()( const ui::Selectable::constPtr & s )
       return true;
   }
 
-  *_table << ( TableRow()
-  << statusIndicator
-  << s->name()
-  << s->theObj()->summary()
-  << kind_to_string_localized( s->kind(), 1 )
-  );
+  _table->add( s->theObj().satSolvable(), statusIndicator );
 
   return true;
 }
 
+///////////////////////////////////////////////////////////////////
+// class SearchResultStream
+///////////////////////////////////////////////////////////////////
+
+SearchResultStream::SearchResultStream( Out & out_r )
+: _xml( out_r.typeXML() )
+, _json( typeJSON( out_r ) )
+{}
+
+SearchResultStream::~SearchResultStream()
+{ finish(); }
+
+void SearchResultStream::flush( SolvableTable & table_r, const std::vector<std::string> & lastRowDetails_r )
+{
+  if ( table_r.empty() || _finished )
+    return;
+
+  if ( _xml && ! _rows )
+  {
+    _xmlAttributes = OutXML::searchResultAttributes( table_r.header() );
+    cout << "<search-result version=\"0.0\">" << endl;
+    cout << "<solvable-list>" << endl;
+  }
+  else if ( _json && ! _rows )
+    _xmlAttributes = OutXML::searchResultAttributes( table_r.header() );
+
+  for ( SolvableTable::size_type idx = 0; idx < table_r.size(); ++idx )
+  {
+    TableRow row { table_r.row( idx ) };
+    if ( _xml )
+      OutXML::searchResultRow( cout, _xmlAttributes, row );
+    else if ( _json )
+      OutJSON::searchResultRow( cout, _xmlAttributes, row );
+    else
+    {
+      // Unaligned, but the same separator as in tables.
+      bool first = true;
+      for ( const std::string & col : row.columns() )
+      {
+        if ( first )
+          first = false;
+        else
+          cout << " | ";
+        cout << col;
+      }
+      cout << '\n';
+    }
+    ++_rows;
+  }
+
+  if ( ! ( _xml || _json ) )
+  {
+    for ( const std::string & detail : lastRowDetails_r )
+      cout << "    " << detail << '\n';
+  }
+
+  table_r.clear();
+}
+
+void SearchResultStream::finish()
+{
+  if ( _finished )
+    return;
+  _finished = true;
+
+  if ( _xml && _rows )
+  {
+    cout << "</solvable-list>" << endl;
+    cout << "</search-result>" << endl;
+  }
+  else
+    cout << flush;
+}
+
+///////////////////////////////////////////////////////////////////
+
+void printSearchResult( Out & out_r, const SolvableTable & table_r, unsigned abbrevColumn_r )
+{
+  bool xml { out_r.typeXML() };
+  bool json { typeJSON( out_r ) };
+  if ( ! ( xml || json ) )
+  {
+    table_r.dumpTo( cout, abbrevColumn_r );
+    return;
+  }
+
+  if ( xml )
+  {
+    cout << "<search-result version=\"0.0\">" << endl;
+    cout << "<solvable-list>" << endl;
+  }
+  std::vector<std::string> attributes( OutXML::searchResultAttributes( table_r.header() ) );
+  for ( SolvableTable::size_type idx = 0; idx < table_r.size(); ++idx )
+  {
+    if ( xml )
+      OutXML::searchResultRow( cout, attributes, table_r.row( idx ) );
+    else
+      OutJSON::searchResultRow( cout, attributes, table_r.row( idx ) );
+  }
+  if ( xml )
+  {
+    cout << "</solvable-list>" << endl;
+    cout << "</search-result>" << endl;
+  }
+  else
+    cout << flush;
+}
+
 ///////////////////////////////////////////////////////////////////
 
 static std::string string_weak_status( const ResStatus & rs )
@@ -364,7 +454,7 @@ void list_packages(Zypper & zypper , ListPackagesFlags flags_r )
   };
 
   MIL << "Going to list packages." << std::endl;
-  Table tbl;
+  SolvableTable tbl( { SolvableTable::Status, SolvableTable::Repository, SolvableTable::Name, SolvableTable::Edition, SolvableTable::Arch } );
 
   bool repofilter =  InitRepoSettings::instance()._repoFilter.size() ;	// suppress @System if repo filter is on
   bool showInstalled = !flags_r.testFlag( ListPackagesBits::HideInstalled ); //installed_only || !uninstalled_only;
@@ -431,12 +521,7 @@ void list_packages(Zypper & zypper , ListPackagesFlags flags_r )
       if ( repofilter && pi.repository().isSystemRepo() )
         continue;
 
-      tbl << ( TableRow()
-          << computeStatusIndicator( pi, sel )
-          << pi.repository().asUserString()
-          << pi.name()
-          << pi.edition().asString()
-          << pi.arch().asString() );
+      tbl.add( pi.satSolvable(), computeStatusIndicator( pi, sel ) );
     }
   }
 
@@ -445,20 +530,15 @@ void list_packages(Zypper & zypper , ListPackagesFlags flags_r )
   else
   {
     // display the result, even if --quiet specified
-    tbl << ( TableHeader()
-        // translators: S for installed Status
-        << N_("S")
-        << N_("Repository")
-        << table::Column( N_("Name"), table::CStyle::SortCi )
-        << table::Column( N_("Version"), table::CStyle::Edition )
-        << N_("Arch") );
-
     if ( flags_r.testFlag( ListPackagesBits::SortByRepo ) )
-      tbl.sort( 1 ); // Repo
+      tbl.sort( { SolvableTable::Repository } );
     else
-      tbl.sort( 2 ); // Name
+      tbl.sort( { SolvableTable::Name } );
 
-    cout << tbl;
+    if ( typeJSON( zypper.out() ) )
+      printSearchResult( zypper.out(), tbl );
+    else
+      tbl.dumpTo( cout );
   }
 }
 
@@ -504,6 +584,8 @@ void list_product_table(Zypper & zypper , SolvableFilterMode mode_r)
   bool repofilter =  InitRepoSettings::instance()._repoFilter.size() ;	// suppress @System if repo filter is on
   bool installed_only = mode_r == SolvableFilterMode::ShowOnlyInstalled;
   bool notinst_only = mode_r == SolvableFilterMode::ShowOnlyNotInstalled;
+  bool json = typeJSON( zypper.out() );
+  std::vector<std::pair<std::string,OutJSON::Record>> records;	// --jsonout: by name
 
   for( const auto & sel : God->pool().proxy().byKind<Product>() )
   {
@@ -518,6 +600,15 @@ void list_product_table(Zypper & zypper , SolvableFilterMode mode_r)
         continue;
 
       // NOTE: 'Is Base' is available in the installed object only.
+      if ( json )
+      {
+        OutJSON::Record record( "product" );
+        record.add( "status", OutXML::searchResultStatus( statusIndicator ) ).addSolvable( pi.satSolvable() )
+              .add( "summary", pi.summary() )
+              .add( "isbase", iType && sel->identicalInstalledObj( pi )->asKind<Product>()->isTargetDistribution() );
+        records.push_back( { pi.summary(), std::move(record) } );
+        continue;
+      }
       tbl << ( TableRow()
           << statusIndicator
           << pi.repository().asUserString()
@@ -529,6 +620,18 @@ void list_product_table(Zypper & zypper , SolvableFilterMode mode_r)
     }
   }
 
+  if ( json )
+  {
+    std::stable_sort( records.begin(), records.end(), []( const auto & lhs, const auto & rhs ) {
+      return str::compareCI( lhs.first, rhs.first ) < 0;
+    } );
+    for ( const auto & record : records )
+      OutJSON::writeRecord( cout, record.second );
+    if ( records.empty() )
+      zypper.out().info(_("No products found.") );
+    return;
+  }
+
   tbl.sort(1); // Name
 
   if ( tbl.empty() )
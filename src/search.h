@@ -15,6 +15,7 @@
 #include "Zypper.h"
 #include "Table.h"
 #include "utils/misc.h"
+#include "utils/SolvableTable.h"
 
 ///////////////////////////////////////////////////////////////////
 /// \class FillSearchTableSolvable
@@ -22,7 +23,7 @@
 ///////////////////////////////////////////////////////////////////
 struct FillSearchTableSolvable
 {
-  FillSearchTableSolvable( Table & table_r, TriBool instNotinst_r = indeterminate );
+  FillSearchTableSolvable( SolvableTable & table_r, TriBool instNotinst_r = indeterminate );
 
   /** Add this PoolItem if no filter applies */
   bool operator()( const PoolItem & pi_r ) const;
@@ -33,11 +34,16 @@ struct FillSearchTableSolvable
   /** For reverse dependency search */
   bool operator()( const sat::Solvable & solv_r, const sat::SolvAttr &searchedAttr, const CapabilitySet &matchedReq ) const;
 
+  /** The detail lines about the matches provided by a PoolQuery iterator. */
+  static std::vector<std::string> matchDetails( const PoolQuery::const_iterator & it_r );
+  /** The detail lines for reverse dependency search */
+  static std::vector<std::string> matchDetails( const sat::Solvable & solv_r, const sat::SolvAttr &searchedAttr, const CapabilitySet &matchedReq );
+
 private:
-  std::string attribStr(const sat::SolvAttr &attr) const;
+  static std::string attribStr(const sat::SolvAttr &attr);
 
 private:
-  Table * _table;		//!< The table used for output
+  SolvableTable * _table;	//!< The table used for output
   std::set<std::string> _repos;	//!< Filter --repo
   TriBool _instNotinst;		//!< Filter --[not-]installed
 
@@ -46,16 +52,63 @@ private:
 struct FillSearchTableSelectable
 {
   // the table used for output
-  Table * _table;
+  SolvableTable * _table;
   TriBool _instNotinst;
   bool _tagForeign;		//!< see NOTE in operator()
 
   FillSearchTableSelectable(
-      Table & table, TriBool installed_only = indeterminate);
+      SolvableTable & table, TriBool installed_only = indeterminate);
 
   bool operator()(const ui::Selectable::constPtr & s) const;
 };
 
+///////////////////////////////////////////////////////////////////
+/// \class SearchResultStream
+/// \brief Write search results as they are found (search --stream).
+///
+/// Rows are written one per line (XML: one \c <solvable> element each)
+/// rather than collecting them in a Table, which is sorted and aligned
+/// once it is complete. The SolvableTable filled by the FillSearchTable
+/// functors is just used as a buffer for the rows not yet written.
+///////////////////////////////////////////////////////////////////
+class SearchResultStream
+{
+public:
+  SearchResultStream( Out & out_r );
+
+  /** Calls \ref finish. */
+  ~SearchResultStream();
+
+  /** Write and remove the rows buffered in \a table_r.
+   * The optional \a lastRowDetails_r are written after the last row.
+   */
+  void flush( SolvableTable & table_r, const std::vector<std::string> & lastRowDetails_r = std::vector<std::string>() );
+
+  /** Close the result list (XML) if any rows were written. */
+  void finish();
+
+  /** The number of rows written. */
+  unsigned size() const
+  { return _rows; }
+
+  /** Whether no rows were written. */
+  bool empty() const
+  { return ! _rows; }
+
+private:
+  bool _xml;
+  bool _json;
+  bool _finished = false;
+  unsigned _rows = 0;
+  std::vector<std::string> _xmlAttributes;	///< also used for JSON
+};
+
+/** Write the sorted \a table_r as search result (like \ref Out::searchResult)
+ * without building a \ref Table. The text table shortens the column
+ * \a abbrevColumn_r if it does not fit on the screen.
+ */
+void printSearchResult( Out & out_r, const SolvableTable & table_r, unsigned abbrevColumn_r = unsigned(-1) );
+
 // struct FillPatchesTable		in src/utils/misc.h
 // struct FillPatchesTableForIssue	in src/utils/misc.h
 
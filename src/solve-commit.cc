@@ -8,6 +8,10 @@
 #include <iostream>
 #include <sstream>
 #include <optional>
+#include <memory>
+#include <csignal>
+#include <unistd.h>
+#include <sys/prctl.h>
 
 #include <zypp/ZYppFactory.h>
 #include <zypp/base/Logger.h>
@@ -17,16 +21,22 @@
 #include <zypp/base/IOStream.h>
 
 #include <zypp/media/MediaException.h>
-#include <zypp/misc/CheckAccessDeleted.h>
+#include <zypp/Package.h>
+#include <zypp/ZYppCallbacks.h>
+#include <zypp/target/CommitPackageCache.h>
 
 #include "misc.h"		// confirm_licenses
 #include "repos.h"		// get_repo - used in dist_upgrade
 #include "utils/misc.h"
 #include "utils/prompt.h"	// Continue? and solver problem prompt
 #include "utils/pager.h"	// to view the summary
+#include "utils/Profile.h"
+#include "utils/DeletedFilesScanner.h"
+#include "utils/ParallelJobs.h"
 #include "utils/messages.h"
 #include "global-settings.h"
 #include "CommitSummary.h"
+#include "output/OutJSON.h"
 
 #include "solve-commit.h"
 #include "commands/needs-rebooting.h"
@@ -63,6 +73,158 @@ private:
   Pathname _watch;
 };
 
+///////////////////////////////////////////////////////////////////
+/// \class PackagePrefetch
+/// \brief Download the packages to install while the user reads the summary.
+///
+/// Started when the 'Continue?' prompt is shown (zypper.conf:
+/// commit.prefetchPackages). A background job downloads the not yet cached
+/// packages of downloading repos (http, ftp, ...; not local or CD/DVD
+/// media) into the package cache, where the commit finds them. The job
+/// is cancelled as soon as the prompt is answered; a download in progress
+/// is aborted via its progress callback, so no partial file is left. The
+/// commit then downloads whatever is still missing at full speed.
+///
+/// Unless \ref keep is called because the commit runs, the dtor removes the
+/// prefetched packages of repos which do not keep their packages, as the
+/// commit would have done. This includes leaving the prompt by 'n', by
+/// solving again, or by an interrupt.
+///
+/// The job runs non-interactive. Anything needing the user (e.g. an unknown
+/// key) lets the download fail, and the commit asks as usual.
+///////////////////////////////////////////////////////////////////
+class PackagePrefetch
+{
+public:
+  PackagePrefetch( Zypper & zypper_r )
+  {
+    std::vector<PoolItem> todo;
+    for ( const PoolItem & pi : God->pool().byKind<Package>() )
+    {
+      if ( pi.status().isToBeInstalled() && pi.repoInfo().url().schemeIsDownloading()
+           && ! pi->asKind<Package>()->isCached() )
+        todo.push_back( pi );
+    }
+    if ( todo.empty() )
+      return;
+    _todo = todo;
+
+    unsigned maxSpeed = zypper_r.config().commit_prefetchMaxSpeed;
+    MIL << "Prefetching " << todo.size() << " packages while prompting (max " << maxSpeed << " KiB/s)" << endl;
+    _job.reset( new BackgroundJob( [&zypper_r,todo,maxSpeed]() -> int
+    {
+      // a signal (or the parent going away) stops the job after cleaning up
+      ::prctl( PR_SET_PDEATHSIG, SIGTERM );
+      struct sigaction sa {};
+      sa.sa_handler = []( int ) { _stop = 1; };
+      ::sigaction( SIGTERM, &sa, nullptr );
+      ::sigaction( SIGINT, &sa, nullptr );
+
+      zypper_r.configNoConst().non_interactive = true;
+      zypper_r.configNoConst().gpg_auto_import_keys = false;
+      callback::TempConnect<media::MediaChangeReport> tempDisconnect;
+      Throttle throttle( maxSpeed * 1024.0 );
+      throttle.connect();
+
+      unsigned got = 0;
+      target::CommitPackageCache packageCache;
+      for ( const PoolItem & pi : todo )
+      {
+        if ( _stop )
+          break;
+        try
+        {
+          ManagedFile localfile( packageCache.get( pi ) );
+          localfile.resetDispose();
+          ++got;
+        }
+        catch ( const Exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+        }
+      }
+      MIL << "Prefetched " << got << " of " << todo.size() << " packages" << endl;
+      return 0;
+    } ) );
+  }
+
+  PackagePrefetch( const PackagePrefetch & ) = delete;
+  PackagePrefetch & operator=( const PackagePrefetch & ) = delete;
+
+  /** Dtor cancels the job and, unless \ref keep was called, discards the prefetched packages. */
+  ~PackagePrefetch()
+  {
+    if ( _keep )
+      cancel();
+    else
+      discard();
+  }
+
+  /** Stop downloading; the commit runs and uses the packages downloaded so far. */
+  void keep()
+  {
+    cancel();
+    _keep = true;
+  }
+
+  /** Stop downloading (the packages downloaded so far stay in the cache). */
+  void cancel()
+  {
+    if ( _job )
+    {
+      _job->cancel();
+      _job.reset();
+    }
+  }
+
+  /** Stop downloading and remove the packages downloaded so far, unless their repo keeps packages.
+   * They were not cached when the job started, so what is cached now was prefetched.
+   */
+  void discard()
+  {
+    cancel();
+    if ( _todo.empty() )
+      return;
+    unsigned removed = 0;
+    for ( const PoolItem & pi : _todo )
+    {
+      if ( pi.repoInfo().keepPackages() )
+        continue;
+      Package::constPtr pkg { pi->asKind<Package>() };
+      if ( pkg->isCached() && filesystem::unlink( pkg->cachedLocation() ) == 0 )
+        ++removed;
+    }
+    _todo.clear();
+    MIL << "Removed " << removed << " prefetched packages" << endl;
+  }
+
+private:
+  /** Aborts the download when stopped, and slows it down to \a maxSpeed_r (bytes per second; 0: no limit). */
+  struct Throttle : public callback::ReceiveReport<media::DownloadProgressReport>
+  {
+    Throttle( double maxSpeed_r )
+    : _maxSpeed( maxSpeed_r )
+    {}
+
+    bool progress( int /*value*/, const Url & /*file*/, double dbps_avg, double /*dbps_current*/ ) override
+    {
+      // Called from within the transfer loop; while we sleep nothing is read.
+      if ( _maxSpeed > 0 && dbps_avg > _maxSpeed && ! _stop )
+        ::usleep( 100000 );
+      return ! _stop;
+    }
+
+    double _maxSpeed;
+  };
+
+  static volatile std::sig_atomic_t _stop;
+  std::unique_ptr<BackgroundJob> _job;
+  std::vector<PoolItem> _todo;	///< not cached when the job started
+  bool _keep = false;		///< the commit runs
+};
+
+volatile std::sig_atomic_t PackagePrefetch::_stop = 0;
+
 ///////////////////////////////////////////////////////////////////
 namespace {
   inline ColorString tagProblem() {
@@ -609,35 +771,56 @@ SolveAndCommitPolicy & SolveAndCommitPolicy::downloadMode( DownloadMode dlMode )
 DownloadMode SolveAndCommitPolicy::downloadMode() const
 { return _zyppCommitPolicy.downloadMode(); }
 
+/** The files owned by installed packages which are going to be removed or replaced.
+ * Must be collected before the commit; the 'zypper ps' check after the commit
+ * looks for processes using these files only.
+ */
+static std::unordered_set<std::string> files_deleted_by_transaction()
+{
+  std::unordered_set<std::string> ret;
+  for ( const PoolItem & pi : God->pool() )
+  {
+    if ( pi.status().isInstalled() && pi.status().isToBeUninstalled() && pi.isKind<Package>() )
+    {
+      for ( const std::string & file : asKind<Package>( pi )->filelist() )
+        ret.insert( file );
+    }
+  }
+  MIL << ret.size() << " files will be deleted by the transaction" << endl;
+  return ret;
+}
+
 /** fate #300763
  * This is called after each commit to notify user about running processes that
  * use libraries or other files that have been removed since their execution.
  */
-static void notify_processes_using_deleted_files( Zypper & zypper )
+static void notify_processes_using_deleted_files( Zypper & zypper, std::unordered_set<std::string> deletedFiles_r )
 {
   if ( ! zypper.config().psCheckAccessDeleted ) {
     zypper.out().info( str::form(_("Check for running processes using deleted libraries is disabled in zypper.conf. Run '%s' to check manually."),
                                  "zypper ps -s" ) );
   } else {
     zypper.out().info(_("Checking for running processes using deleted libraries..."), Out::HIGH );
-    CheckAccessDeleted checker( false ); // wait for explicit call to check()
+    DeletedFilesScanner scanner;
+    scanner.setFileFilter( std::move(deletedFiles_r) );
+    std::vector<DeletedFilesScanner::ProcInfo> procs;
     try
     {
-      checker.check();
+      procs = scanner.scan();
     }
     catch( const Exception & e )
     {
       if ( zypper.out().verbosity() > Out::NORMAL )
       {
         if ( e.historySize() )
-    zypper.out().error( e, _("Check failed:") );
+          zypper.out().error( e, _("Check failed:") );
         else
-            zypper.out().info( str::Str() << ( ColorContext::MSG_WARNING << _("Skip check:") ) << " " << e.asUserString() );
+          zypper.out().info( str::Str() << ( ColorContext::MSG_WARNING << _("Skip check:") ) << " " << e.asUserString() );
       }
     }
 
     // Don't suggest "zypper ps" if zypper is the only prog with deleted open files.
-    if ( checker.size() > 1 || ( checker.size() == 1 && checker.begin()->pid != str::numstring(::getpid()) ) )
+    if ( procs.size() > 1 || ( procs.size() == 1 && procs.front().pid != str::numstring(::getpid()) ) )
     {
       zypper.out().info( str::Format(_("There are running programs which still use files and libraries deleted or updated by recent upgrades. They should be restarted to benefit from the latest updates. Run '%1%' to list these programs.") )
       % "zypper ps -s" );
@@ -712,6 +895,7 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
 
       while ( true )
       {
+        Profile::start( "solve" );
         bool success;
         if ( zypper.command() == ZypperCommand::VERIFY )
           success = verify(zypper);
@@ -725,6 +909,7 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
           zypper.out().info(_("Resolving package dependencies...") );
           success = resolve( zypper );
         }
+        Profile::stop( "solve" );	// (not the problem prompt)
 
         // go on, we've got solution or we don't want a solution (we want testcase)
         if ( success || SolverSettings::instance()._debugSolver )
@@ -740,6 +925,7 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
     } else {
       MIL << "Computing package update..." << endl;
       set_solver_flags( zypper );   // bsc#1201972: make sure 'up' also respects solver options
+      Profile::Phase phase { "solve" };
       zypp::getZYpp()->resolver()->doUpdate();
     }
 
@@ -753,6 +939,7 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
 
     // SHOW SUMMARY
 
+    Profile::start( "summary" );
     Summary summary( God->pool(), std::move(policy.summaryHints), policy.summaryOptions() );
 
     if ( zypper.out().verbosity() == Out::HIGH )
@@ -775,8 +962,11 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
     // show the summary
     if ( zypper.out().type() == Out::TYPE_XML )
       summary.dumpAsXmlTo( cout );
+    else if ( typeJSON( zypper.out() ) )
+      summary.dumpAsJsonTo( cout );
     else
       summary.dumpTo( cout );
+    Profile::stop( "summary" );
 
 
     if ( summary.packagesToGetAndInstall()
@@ -852,6 +1042,12 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
         prompt_text = str;
       }
 
+      // prefetch while waiting for the answer
+      std::unique_ptr<PackagePrefetch> prefetch;
+      if ( zypper.config().commit_prefetchPackages && !zypper.config().non_interactive
+        && !policy.zyppCommitPolicy().dryRun() )
+        prefetch.reset( new PackagePrefetch( zypper ) );
+
       bool do_commit = false;
       unsigned reply;
       do
@@ -919,6 +1115,8 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
           need_another_solver_run = false;
         }
       } while ( reply > 2 );
+      if ( prefetch && do_commit )
+        prefetch->cancel();	// otherwise ('n', or 'p' solving again) the dtor discards them
 
       if ( need_another_solver_run )
         continue;
@@ -937,8 +1135,14 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
           zypper.setExitCode( ZYPPER_EXIT_ERR_ZYPP );
           return;
         }
+        if ( prefetch )
+        {
+          prefetch->keep();
+          prefetch.reset();
+        }
 
         std::optional<ZYppCommitResult> result;
+        std::unordered_set<std::string> deletedFiles;
         try
         {
           RuntimeData & gData = Zypper::instance().runtimeData();
@@ -964,8 +1168,15 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
           // bsc#1183268: Patch reboot-needed flag overrules included packages.
           PatchRebootRulesWatchdog guard { summary.hasViewOption( Summary::PATCH_REBOOT_RULES ) && not summary.needMachineReboot() };
 
+          // the files the post commit 'zypper ps' check looks for
+          if ( !( zypper.config().changedRoot || dryRunEtc ) && zypper.config().psCheckAccessDeleted )
+            deletedFiles = files_deleted_by_transaction();
+
           MIL << "Using commit policy: " << policy.zyppCommitPolicy() << endl;
-          result = God->commit( policy.zyppCommitPolicy() );
+          {
+            Profile::Phase phase { "commit" };
+            result = God->commit( policy.zyppCommitPolicy() );
+          }
 
           gData.entered_commit = false;
 
@@ -1059,6 +1270,8 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
             // show the summary
             if ( zypper.out().type() == Out::TYPE_XML )
               cSummary.dumpAsXmlTo( cout );
+            else if ( typeJSON( zypper.out() ) )
+              cSummary.dumpAsJsonTo( cout );
             else
               cSummary.dumpTo( cout );
 
@@ -1102,7 +1315,7 @@ void solve_and_commit ( Zypper &zypper, SolveAndCommitPolicy policy )
         if ( !( zypper.config().changedRoot || dryRunEtc )
           && ( summary.packagesToRemove() || summary.packagesToUpgrade() || summary.packagesToDowngrade() ) )
         {
-          notify_processes_using_deleted_files( zypper );
+          notify_processes_using_deleted_files( zypper, std::move(deletedFiles) );
         }
       }
     }
@@ -14,6 +14,7 @@
 #include "update.h"
 #include "main.h"
 #include "global-settings.h"
+#include "output/OutJSON.h"
 #include "utils/misc.h"
 
 using namespace zypp;
@@ -100,16 +101,22 @@ namespace
     return str;
   }
 
-  /** RNC: Print patch-update element */
-  inline std::ostream & xmlPrintPatchUpdateOn( std::ostream & str, const PoolItem & pi_r, const PatchHistoryData & patchHistoryData_r )
+  /** The patch flags not making a patch interactive. */
+  inline Patch::InteractiveFlags patchIgnoreFlags()
   {
-    Patch::constPtr patch = pi_r->asKind<Patch>();
-
     Patch::InteractiveFlags ignoreFlags = Patch::NoFlags;
     if ( Zypper::instance().config().reboot_req_non_interactive )
       ignoreFlags |= Patch::Reboot;
     if ( LicenseAgreementPolicy::instance()._autoAgreeWithLicenses )
       ignoreFlags |= Patch::License;
+    return ignoreFlags;
+  }
+
+  /** RNC: Print patch-update element */
+  inline std::ostream & xmlPrintPatchUpdateOn( std::ostream & str, const PoolItem & pi_r, const PatchHistoryData & patchHistoryData_r )
+  {
+    Patch::constPtr patch = pi_r->asKind<Patch>();
+    Patch::InteractiveFlags ignoreFlags = patchIgnoreFlags();
 
     // write the node
     xmlout::Node parent { str, "update", xmlout::Node::optionalContent, {
@@ -160,6 +167,87 @@ namespace
     return str;
   }
 
+  /** JSON: The repo a solvable comes from (like the XML source element). */
+  inline OutJSON::Record jsonSource( const RepoInfo & repoInfo_r )
+  {
+    OutJSON::Record source;
+    source.add( "url", repoInfo_r.url().asString() ).add( "alias", repoInfo_r.alias() );
+    return source;
+  }
+
+  /** JSON: Print an update record for a non-patch (like xmlPrintOtherUpdateOn). */
+  inline std::ostream & jsonPrintOtherUpdateOn( std::ostream & str, const PoolItem & pi_r )
+  {
+    OutJSON::Record record( "update" );
+    record.add( "kind", pi_r.kind().asString() )
+          .add( "name", pi_r.name() )
+          .add( "edition", pi_r.edition().asString() )
+          .add( "arch", pi_r.arch().asString() );
+    {
+      const PoolItem & ipi( ui::Selectable::get(pi_r)->installedObj() );
+      if ( ipi )
+      {
+        if ( pi_r.edition() != ipi.edition() )
+          record.add( "edition-old", ipi.edition().asString() );
+        if ( pi_r.arch() != ipi.arch() )
+          record.add( "arch-old", ipi.arch().asString() );
+      }
+    }
+    record.addIfNotEmpty( "summary", pi_r.summary() )
+          .addIfNotEmpty( "description", pi_r.description() )
+          .addIfNotEmpty( "license", pi_r.licenseToConfirm() );
+    if ( !pi_r.repoInfo().alias().empty() )
+      record.add( "source", jsonSource( pi_r.repoInfo() ) );
+
+    OutJSON::writeRecord( str, record );
+    return str;
+  }
+
+  /** JSON: Print an update record for a patch (like xmlPrintPatchUpdateOn).
+   * \a list_r tells the list the patch belongs to, e.g. 'blocked'.
+   */
+  inline std::ostream & jsonPrintPatchUpdateOn( std::ostream & str, const PoolItem & pi_r, const PatchHistoryData & patchHistoryData_r, const std::string & list_r = std::string() )
+  {
+    Patch::constPtr patch = pi_r->asKind<Patch>();
+
+    OutJSON::Record record( "update" );
+    record.addIfNotEmpty( "list", list_r )
+          .add( "kind", "patch" )
+          .add( "name", patch->name() )
+          .add( "edition", patch->edition().asString() )
+          .add( "arch", patch->arch().asString() )
+          .add( "status", textPatchStatus( pi_r ) )
+          .add( "category", patch->category() )
+          .add( "severity", patch->severity() )
+          .add( "pkgmanager", patch->restartSuggested() )
+          .add( "restart", patch->rebootSuggested() )
+          .add( "interactive", patch->interactiveWhenIgnoring( patchIgnoreFlags() ) );
+
+    if ( PatchHistoryData::value_type res { patchHistoryData_r[pi_r] }; res != PatchHistoryData::noData )
+    {
+      if ( res.second == pi_r.status().validate() )
+        record.add( "status-since", Date::ValueType( res.first ) );
+    }
+    record.addIfNotEmpty( "summary", patch->summary() )
+          .addIfNotEmpty( "description", patch->description() )
+          .addIfNotEmpty( "license", patch->licenseToConfirm() );
+    if ( !patch->repoInfo().alias().empty() )
+      record.add( "source", jsonSource( patch->repoInfo() ) );
+    record.add( "issue-date", Date::ValueType( patch->timestamp() ) );
+
+    std::vector<OutJSON::Record> issues;
+    for_( it, patch->referencesBegin(), patch->referencesEnd() )
+    {
+      OutJSON::Record issue;
+      issue.add( "type", it.type() ).add( "id", it.id() ).addIfNotEmpty( "title", it.title() ).addIfNotEmpty( "href", it.href() );
+      issues.push_back( std::move(issue) );
+    }
+    record.add( "issues", issues );
+
+    OutJSON::writeRecord( str, record );
+    return str;
+  }
+
 } //namespace
 ///////////////////////////////////////////////////////////////////
 
@@ -469,8 +557,11 @@ void patch_check( bool updatestackOnly )
   { zypper.setExitCode( stats.security() ? ZYPPER_EXIT_INF_SEC_UPDATE_NEEDED : ZYPPER_EXIT_INF_UPDATE_NEEDED ); }
 }
 
-// returns true if NEEDED! restartSuggested() patches are available
-static bool xml_list_patches (Zypper & zypper, bool all_r, const PatchHistoryData & patchHistoryData_r )
+/** Collect the patches to show in the XML/JSON update list and those
+ * blocked by update stack patches (if not \a all_r).
+ * Returns true if NEEDED! restartSuggested() patches are available.
+ */
+static bool collect_patch_updates( bool all_r, std::vector<PoolItem> & updates_r, std::vector<PoolItem> & blocked_r, unsigned & patchcount_r )
 {
   const ResPool& pool = God->pool();
 
@@ -485,23 +576,36 @@ static bool xml_list_patches (Zypper & zypper, bool all_r, const PatchHistoryDat
     }
   }
 
-  unsigned patchcount = 0;
+  patchcount_r = 0;
   for_( it, pool.byKindBegin(ResKind::patch), pool.byKindEnd(ResKind::patch) )
   {
     if ( all_r || patchIsApplicable( *it ) )
     {
       const PoolItem & pi( *it );
-      Patch::constPtr patch = pi->asKind<Patch>();
 
       // if updates stack patches are available, show only those
       if ( all_r || !pkg_mgr_available || patchIsNeededRestartSuggested( pi ) )
-      {
-        xmlPrintPatchUpdateOn( cout, pi, patchHistoryData_r );
-      }
+        updates_r.push_back( pi );
+      else
+        blocked_r.push_back( pi );
     }
-    ++patchcount;
+    ++patchcount_r;
   }
 
+  return pkg_mgr_available;
+}
+
+// returns true if NEEDED! restartSuggested() patches are available
+static bool xml_list_patches (Zypper & zypper, bool all_r, const PatchHistoryData & patchHistoryData_r )
+{
+  std::vector<PoolItem> updates;
+  std::vector<PoolItem> blocked;
+  unsigned patchcount = 0;
+  bool pkg_mgr_available = collect_patch_updates( all_r, updates, blocked, patchcount );
+
+  for ( const PoolItem & pi : updates )
+    xmlPrintPatchUpdateOn( cout, pi, patchHistoryData_r );
+
   //! \todo change this from appletinfo to something general, define in xmlout.rnc
   if (patchcount == 0)
     cout << "<appletinfo status=\"no-update-repositories\"/>" << endl;
@@ -514,16 +618,8 @@ static bool xml_list_patches (Zypper & zypper, bool all_r, const PatchHistoryDat
     if ( ! all_r )
     {
     cout << "<blocked-update-list>" << endl;
-    for_( it, pool.byKindBegin(ResKind::patch), pool.byKindEnd(ResKind::patch) )
-    {
-      if ( patchIsApplicable( *it ) )
-      {
-        const PoolItem & pi( *it );
-        Patch::constPtr patch = pi->asKind<Patch>();
-        if ( ! patchIsNeededRestartSuggested( pi ) )
-          xmlPrintPatchUpdateOn( cout, pi, patchHistoryData_r );
-      }
-    }
+    for ( const PoolItem & pi : blocked )
+      xmlPrintPatchUpdateOn( cout, pi, patchHistoryData_r );
     cout << "</blocked-update-list>" << endl;
     }
   }
@@ -531,6 +627,29 @@ static bool xml_list_patches (Zypper & zypper, bool all_r, const PatchHistoryDat
   return pkg_mgr_available;
 }
 
+// returns true if NEEDED! restartSuggested() patches are available
+static bool json_list_patches( Zypper & zypper, bool all_r, const PatchHistoryData & patchHistoryData_r )
+{
+  std::vector<PoolItem> updates;
+  std::vector<PoolItem> blocked;
+  unsigned patchcount = 0;
+  bool pkg_mgr_available = collect_patch_updates( all_r, updates, blocked, patchcount );
+
+  for ( const PoolItem & pi : updates )
+    jsonPrintPatchUpdateOn( cout, pi, patchHistoryData_r );
+
+  if ( patchcount == 0 )
+    OutJSON::writeRecord( cout, OutJSON::Record( "update-status" ).add( "status", "no-update-repositories" ) );
+
+  if ( pkg_mgr_available && ! all_r )
+  {
+    for ( const PoolItem & pi : blocked )
+      jsonPrintPatchUpdateOn( cout, pi, patchHistoryData_r, "blocked" );
+  }
+
+  return pkg_mgr_available;
+}
+
 // ----------------------------------------------------------------------------
 
 static void xml_list_updates(const ResKindSet & kinds, bool all_r )
@@ -544,6 +663,15 @@ static void xml_list_updates(const ResKindSet & kinds, bool all_r )
   }
 }
 
+static void json_list_updates( const ResKindSet & kinds, bool all_r )
+{
+  Candidates candidates;
+  find_updates( kinds, candidates, all_r );
+
+  for( const PoolItem & pi : candidates )
+    jsonPrintOtherUpdateOn( cout, pi );
+}
+
 // ----------------------------------------------------------------------------
 
 // returns true if NEEDED! restartSuggested() patches are available
@@ -716,6 +844,21 @@ void list_updates(Zypper & zypper, const ResKindSet & kinds, bool best_effort, b
 {
   PatchHistoryData patchHistoryData;	// commonly used by all tables
 
+  if ( typeJSON( zypper.out() ) )
+  {
+    // one record per update; patches first
+    bool affects_pkgmgr = false;
+    if ( kinds.count( ResKind::patch ) )
+      affects_pkgmgr = json_list_patches( zypper, all_r, patchHistoryData );
+    if ( !affects_pkgmgr )
+    {
+      ResKindSet localkinds = kinds;
+      localkinds.erase( ResKind::patch );
+      json_list_updates( localkinds, all_r );
+    }
+    return;
+  }
+
   if (zypper.out().type() == Out::TYPE_XML)
   {
     // TODO: go for XmlNode
@@ -943,6 +1086,13 @@ void list_patches_by_issue( Zypper & zypper, bool all_r, const PatchSelector & s
     xmlPrintPatchUpdateListOn( *parent, "issue-matches", zypp_pending::make_map_key_Iterable( iresult ), patchHistoryData );
     xmlPrintPatchUpdateListOn( *parent, "description-matches", dresult, patchHistoryData );
   }
+  else if ( typeJSON( zypper.out() ) )
+  {
+    for ( const auto & res : iresult )
+      jsonPrintPatchUpdateOn( cout, res.first, patchHistoryData, "issue-matches" );
+    for ( const PoolItem & pi : dresult )
+      jsonPrintPatchUpdateOn( cout, pi, patchHistoryData, "description-matches" );
+  }
   else
   {
     // iresult to table
@@ -0,0 +1,51 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <unistd.h>
+#include <fstream>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+
+#include "AtomicFile.h"
+
+using namespace zypp;
+
+bool writeFileAtomic( const Pathname & file_r, const std::function<void(std::ostream &)> & write_r, std::ios_base::openmode mode_r )
+{
+  if ( filesystem::assert_dir( file_r.dirname() ) != 0 )
+  {
+    DBG << "Can't create " << file_r.dirname() << endl;
+    return false;
+  }
+
+  Pathname tmpFile { file_r.extend( ".new." + str::numstring( ::getpid() ) ) };
+  {
+    std::ofstream out( tmpFile.c_str(), mode_r | std::ios_base::out | std::ios_base::trunc );
+    if ( ! out )
+    {
+      DBG << "Can't write " << tmpFile << endl;
+      return false;
+    }
+    write_r( out );
+    if ( ! out.flush() )
+    {
+      WAR << "Can't write " << tmpFile << endl;
+      filesystem::unlink( tmpFile );
+      return false;
+    }
+  }
+  if ( filesystem::rename( tmpFile, file_r ) != 0 )
+  {
+    WAR << "Can't rename " << tmpFile << " to " << file_r << endl;
+    filesystem::unlink( tmpFile );
+    return false;
+  }
+  DBG << "Saved " << file_r << endl;
+  return true;
+}
@@ -0,0 +1,28 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_ATOMICFILE_H
+#define ZYPPER_UTILS_ATOMICFILE_H
+
+#include <ios>
+#include <functional>
+
+#include <zypp/Pathname.h>
+
+/** Replace \a file_r by what \a write_r writes to the passed stream.
+ *
+ * The content is written to a temporary file next to \a file_r, which is
+ * renamed to \a file_r only if it was completely written. Concurrent
+ * readers (and writers) thus see either the old or the new file, never a
+ * partial one. The directory is created if it does not exist.
+ *
+ * Used for zypper's caches, so errors are just logged.
+ * \return Whether \a file_r was replaced.
+ */
+bool writeFileAtomic( const zypp::Pathname & file_r, const std::function<void(std::ostream &)> & write_r,
+                      std::ios_base::openmode mode_r = std::ios_base::out );
+
+#endif // ZYPPER_UTILS_ATOMICFILE_H
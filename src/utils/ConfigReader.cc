@@ -0,0 +1,164 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+
+#include "Zypper.h"
+#include "utils/ConfigReader.h"
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  inline const char * envNotEmpty( const char * var_r )
+  {
+    const char * ret = ::getenv( var_r );
+    if ( ret && ! *ret )
+      ret = nullptr;
+
+    return ret;
+  }
+
+  inline bool isKeyChar( char ch_r )
+  { return ::isalnum( (unsigned char)ch_r ) || ch_r == '.' || ch_r == '_'; }
+
+  /** Length of the keyword (lens: kw_re) at the start of \a str_r (0 if none). */
+  std::string::size_type keywordLength( const std::string & str_r, std::string::size_type pos_r )
+  {
+    if ( pos_r >= str_r.size() || ! ::isalpha( (unsigned char)str_r[pos_r] ) )
+      return 0;
+
+    std::string::size_type end = pos_r + 1;
+    while ( end < str_r.size() && isKeyChar( str_r[end] ) )
+      ++end;
+    while ( end > pos_r+1 && ! ::isalnum( (unsigned char)str_r[end-1] ) )
+      --end;	// must end with a letter or number
+    return( end - pos_r > 1 ? end - pos_r : 0 );
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+ConfigReader::Options ConfigReader::parse( std::istream & str_r, const Pathname & file_r )
+{
+  Options ret;
+  std::string section;	// empty: the anonymous section
+  std::string line;
+  unsigned lineno = 0;
+
+  auto fail = [&]( const std::string & msg_r ) {
+    ZYPP_THROW( Exception( str::Format( "%1%\nat %2%: %3%" ) % file_r % lineno % msg_r ) );
+  };
+
+  while ( std::getline( str_r, line ) )
+  {
+    ++lineno;
+    line = str::rtrim( line );
+    std::string::size_type pos = line.find_first_not_of( " \t" );
+
+    if ( pos == std::string::npos || line[pos] == '#' )
+      continue;	// empty line, comment or commented kv
+
+    if ( line[pos] == '[' )
+    {
+      std::string::size_type end = line.find( ']' );
+      if ( pos != 0 || end != line.size()-1 || end == 1 || line.find_first_of( " \t/" ) < end )
+        fail( _("Malformed section title.") );
+      section = line.substr( 1, end-1 );
+      continue;
+    }
+
+    std::string::size_type keylen = keywordLength( line, pos );
+    std::string::size_type eq = line.find_first_not_of( " \t", pos+keylen );
+    if ( ! keylen || eq == std::string::npos || line[eq] != '=' )
+      fail( _("Expected 'key = value'.") );
+    if ( section.empty() )
+      fail( _("Option outside of a section.") );
+
+    std::string::size_type val = line.find_first_not_of( " \t", eq+1 );
+    ret[section+"/"+line.substr( pos, keylen )].push_back( val == std::string::npos ? std::string() : line.substr( val ) );
+  }
+  return ret;
+}
+
+ConfigReader::ConfigReader( Pathname customcfg_r )
+{
+  MIL << "Going to read zypper config..." << endl;
+
+  // determine the config files to load
+  if ( customcfg_r.empty() )
+  {
+    // add $HOME/.zypper.conf
+    if ( const char * HOME = envNotEmpty( "HOME" ) )
+      _cfgFiles.push_back( { Pathname(HOME) / ".zypper.conf", Options() } );
+    else
+      WAR << "Cannot figure out user's home directory. Skipping user's config." << endl;
+
+    // add /etc/zypp/zypper.conf
+    _cfgFiles.push_back( { "/etc/zypp/zypper.conf", Options() } );
+  }
+  else
+  {
+    // set user supplied custom config file
+    if ( customcfg_r.relative() )
+    {
+      const char * PWD = envNotEmpty( "PWD" );
+      customcfg_r = (PWD ? PWD : "/") / customcfg_r;
+    }
+
+    PathInfo pi( customcfg_r );
+    if ( pi.isExist() && ! pi.isFile() )
+      ZYPP_THROW( Exception(str::Format(_("Config file '%1%' exists but is not a file." ) ) % customcfg_r ) );
+
+    _cfgFiles.push_back( { customcfg_r, Options() } );
+  }
+
+  // load the config files
+  for ( auto & cfg : _cfgFiles )
+  {
+    if ( PathInfo( cfg.first ).isExist() )
+    {
+      std::ifstream in( cfg.first.c_str() );
+      if ( ! in )
+        ZYPP_THROW( Exception( str::Format( "%1%\n%2%" ) % cfg.first % _("Could not load the config files.") ) );
+      cfg.second = parse( in, cfg.first );
+      MIL << "READ config file: " << cfg.first << endl;
+    }
+    else
+    {
+      if ( ! customcfg_r.empty() )
+        Zypper::instance().out().warning( str::Format(_("Config file '%1%' does not exist." ) ) % cfg.first );
+      WAR << "MISS config file: " << cfg.first << endl;
+    }
+  }
+}
+
+Pathname ConfigReader::getSaveFile() const
+{ return( _cfgFiles.empty() ? Pathname() : _cfgFiles[0].first ); }
+
+std::string ConfigReader::getOption( const std::string & option_r ) const
+{
+  for ( const auto & cfg : _cfgFiles )
+  {
+    auto it = cfg.second.find( option_r );
+    if ( it == cfg.second.end() )
+      continue;
+
+    if ( it->second.size() > 1 )
+    {
+      // translator: %1% is the path to a config file, %2% is the name of an options inside the file
+      Zypper::instance().out().error( str::Format(_("%1%: Option '%2%' is defined multiple times. Using the last one.") ) % cfg.first % option_r );
+    }
+    DBG << cfg.first << ": " << option_r << " = " << it->second.back() << endl;
+    return it->second.back();
+  }
+  return std::string();
+}
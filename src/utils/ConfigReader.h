@@ -0,0 +1,56 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#ifndef ZYPPER_UTIL_CONFIGREADER_H_
+#define ZYPPER_UTIL_CONFIGREADER_H_
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <zypp/Pathname.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class ConfigReader
+/// \brief Read-only access to the zypper config files.
+///
+/// Parses the files like the \c ZYpper augeas lens (utils/zypper.aug)
+/// does, but without loading augeas. It's used to read the config on
+/// every zypper start; \ref Augeas is needed only to save changes.
+///
+/// A file which does not match the lens is rejected as a whole.
+///////////////////////////////////////////////////////////////////
+class ConfigReader
+{
+public:
+  /** Ctor opt. taking a custom config file (otherwise the default cfg files are used).
+   * \throws zypp::Exception if a config file can not be parsed.
+   */
+  ConfigReader( zypp::Pathname customcfg_r = zypp::Pathname() );
+
+public:
+  /** Returns the value for \a option_r ("SECTION/VARIABLE") or an empty string. */
+  std::string getOption( const std::string & option_r ) const;
+
+  /** The config file to save changes to. */
+  zypp::Pathname getSaveFile() const;
+
+public:
+  /** The values by "SECTION/VARIABLE" in the order defined. */
+  using Options = std::map<std::string,std::vector<std::string>>;
+
+  /** Parse a config file read from \a str_r (\a file_r is for messages).
+   * \throws zypp::Exception if \a str_r can not be parsed.
+   */
+  static Options parse( std::istream & str_r, const zypp::Pathname & file_r );
+
+private:
+  std::vector<std::pair<zypp::Pathname,Options>> _cfgFiles;	///< config files loaded (higher prio first)
+};
+
+#endif /* ZYPPER_UTIL_CONFIGREADER_H_ */
@@ -0,0 +1,341 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pwd.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <zypp/base/Exception.h>
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/Pathname.h>
+
+#include "DeletedFilesScanner.h"
+
+namespace
+{
+  /** Deleted files at these locations are not of interest. */
+  bool ignoredFile( std::string_view file_r )
+  {
+    static const std::string_view ignored[] = {
+      "/dev/", "/proc/", "/sys/", "/run/", "/var/run/", "/tmp/", "/var/tmp/",
+      "/memfd:", "/SYSV", "/[aio]", "/drm", "/i915", "/dmabuf",
+    };
+    for ( const auto & prefix : ignored )
+    {
+      if ( file_r.substr( 0, prefix.size() ) == prefix )
+        return true;
+    }
+    return false;
+  }
+
+  /** The file name if \a link_r is the name of a deleted file, or empty. */
+  std::string_view deletedFile( std::string_view link_r )
+  {
+    static const std::string_view deleted { " (deleted)" };
+    if ( link_r.size() <= deleted.size() || link_r[0] != '/'
+         || link_r.substr( link_r.size() - deleted.size() ) != deleted )
+      return std::string_view();
+    link_r.remove_suffix( deleted.size() );
+    return ignoredFile( link_r ) ? std::string_view() : link_r;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  /// Scans processes; one per thread. Buffers are reused for all
+  /// processes the thread scans.
+  class Worker
+  {
+  public:
+    Worker( const std::unordered_set<std::string> & filter_r )
+    : _filter { filter_r }
+    , _buffer( 64 * 1024 )
+    {}
+
+    void scan( pid_t pid_r, std::vector<DeletedFilesScanner::ProcInfo> & result_r )
+    {
+      _dir = "/proc/" + std::to_string( pid_r );
+      _files.clear();
+      scanMaps();
+      scanFds();
+      if ( _files.empty() || DeletedFilesScanner::runsInContainer( pid_r ) )
+        return;
+
+      DeletedFilesScanner::ProcInfo info;
+      info.pid = std::to_string( pid_r );
+      readStatus( info );
+      if ( readFile( _dir + "/comm" ) )
+        info.command = zypp::str::rtrim( std::string( _buffer.data(), _size ) );
+      info.files.assign( _files.begin(), _files.end() );
+      result_r.push_back( std::move(info) );
+    }
+
+  private:
+    /** Read \a file_r into \ref _buffer (growing it if necessary). */
+    bool readFile( const std::string & file_r )
+    {
+      _size = 0;
+      int fd = ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC );
+      if ( fd == -1 )
+        return false;	// gone or no permission
+      while ( true )
+      {
+        if ( _size == _buffer.size() )
+          _buffer.resize( 2 * _buffer.size() );
+        ssize_t cnt = ::read( fd, _buffer.data() + _size, _buffer.size() - _size );
+        if ( cnt < 0 && errno == EINTR )
+          continue;
+        if ( cnt <= 0 )
+          break;
+        _size += cnt;
+      }
+      ::close( fd );
+      return true;
+    }
+
+    void addFile( std::string_view file_r )
+    {
+      if ( file_r.empty() )
+        return;
+      std::string file { file_r };
+      if ( _filter.empty() || _filter.count( file ) )
+        _files.insert( std::move(file) );
+    }
+
+    /** "address perms offset dev inode   pathname" */
+    void scanMaps()
+    {
+      if ( ! readFile( _dir + "/maps" ) )
+        return;
+
+      std::string_view data( _buffer.data(), _size );
+      while ( ! data.empty() )
+      {
+        std::string_view::size_type eol = data.find( '\n' );
+        std::string_view line = data.substr( 0, eol );
+        data.remove_prefix( eol == std::string_view::npos ? data.size() : eol + 1 );
+
+        // the pathname is the first field starting with '/'
+        std::string_view::size_type pos = line.find( " /" );
+        if ( pos != std::string_view::npos )
+          addFile( deletedFile( line.substr( pos + 1 ) ) );
+      }
+    }
+
+    void scanFds()
+    {
+      std::string fddir( _dir + "/fd" );
+      DIR * dir = ::opendir( fddir.c_str() );
+      if ( ! dir )
+        return;	// gone or no permission
+
+      char link[PATH_MAX];
+      while ( struct dirent * entry = ::readdir( dir ) )
+      {
+        if ( entry->d_name[0] == '.' )
+          continue;
+        ssize_t len = ::readlinkat( ::dirfd( dir ), entry->d_name, link, sizeof(link) );
+        if ( len > 0 )
+          addFile( deletedFile( std::string_view( link, len ) ) );
+      }
+      ::closedir( dir );
+    }
+
+    /** PPid and Uid from the status file. */
+    void readStatus( DeletedFilesScanner::ProcInfo & info_r )
+    {
+      if ( ! readFile( _dir + "/status" ) )
+        return;
+
+      std::string_view data( _buffer.data(), _size );
+      auto field = [&data]( std::string_view name_r ) -> std::string {
+        std::string_view::size_type pos = data.find( name_r );
+        if ( pos == std::string_view::npos )
+          return std::string();
+        std::string_view val = data.substr( pos + name_r.size() );
+        val.remove_prefix( std::min( val.find_first_not_of( " \t" ), val.size() ) );
+        return std::string( val.substr( 0, val.find_first_of( " \t\n" ) ) );
+      };
+      info_r.ppid = field( "\nPPid:" );
+      info_r.puid = field( "\nUid:" );	// the real uid
+      info_r.login = login( info_r.puid );
+    }
+
+    const std::string & login( const std::string & uid_r )
+    {
+      auto it = _logins.find( uid_r );
+      if ( it != _logins.end() )
+        return it->second;
+
+      std::string name;
+      if ( ! uid_r.empty() )
+      {
+        struct passwd pwd;
+        struct passwd * result = nullptr;
+        char buf[4096];
+        if ( ::getpwuid_r( zypp::str::strtonum<uid_t>( uid_r ), &pwd, buf, sizeof(buf), &result ) == 0 && result )
+          name = pwd.pw_name;
+      }
+      return _logins.emplace( uid_r, std::move(name) ).first->second;
+    }
+
+  private:
+    const std::unordered_set<std::string> & _filter;
+    std::vector<char> _buffer;
+    size_t _size = 0;
+    std::string _dir;
+    std::set<std::string> _files;
+    std::map<std::string,std::string> _logins;
+  };
+} // namespace
+
+DeletedFilesScanner::DeletedFilesScanner( unsigned threads_r )
+: _threads { threads_r }
+{
+  if ( ! _threads )
+  {
+    long cpus = ::sysconf( _SC_NPROCESSORS_ONLN );
+    _threads = std::min( cpus > 0 ? unsigned(cpus) : 1U, 16U );
+  }
+}
+
+void DeletedFilesScanner::setFileFilter( std::unordered_set<std::string> files_r )
+{
+  _filter = std::move(files_r);
+
+  // The files are deleted, but their directories still exist.
+  std::unordered_map<std::string,std::string> resolved;	// dir -> real path
+  std::vector<std::string> more;
+  for ( const std::string & file : _filter )
+  {
+    std::string::size_type sep = file.rfind( '/' );
+    if ( sep == std::string::npos || sep == 0 )
+      continue;
+    std::string dir { file.substr( 0, sep ) };
+    auto it = resolved.find( dir );
+    if ( it == resolved.end() )
+    {
+      char buf[PATH_MAX];
+      it = resolved.emplace( dir, ::realpath( dir.c_str(), buf ) ? std::string( buf ) : dir ).first;
+    }
+    if ( it->second != dir )
+      more.push_back( it->second + file.substr( sep ) );
+  }
+  _filter.insert( more.begin(), more.end() );
+}
+
+bool DeletedFilesScanner::runsInContainer( pid_t pid_r )
+{
+  enum Type { IGNORE, HOST, CONTAINER };
+  // Whether the file the magic link \a link_r refers to is the one found at its path.
+  auto inOurRoot = []( const std::string & link_r ) -> Type {
+    struct stat procStat;
+    if ( ::stat( link_r.c_str(), &procStat ) != 0 || procStat.st_nlink == 0 )
+      return IGNORE;	// gone or unlinked
+    char target[PATH_MAX];
+    ssize_t len = ::readlink( link_r.c_str(), target, sizeof(target) - 1 );
+    if ( len <= 0 || target[0] != '/' )
+      return IGNORE;	// pipe, socket or anon_inode
+    target[len] = '\0';
+    struct stat targetStat;
+    if ( ::stat( target, &targetStat ) != 0 )
+      return CONTAINER;	// not reachable by us
+    if ( targetStat.st_ino != procStat.st_ino || targetStat.st_dev != procStat.st_dev )
+      return CONTAINER;
+    return HOST;
+  };
+
+  std::string dir { "/proc/" + std::to_string( pid_r ) };
+  Type res = inOurRoot( dir + "/exe" );
+  if ( res != IGNORE )
+    return res == CONTAINER;
+
+  // the executable was deleted: try the mapped files until one tells
+  std::string mapFiles { dir + "/map_files" };
+  DIR * mapDir = ::opendir( mapFiles.c_str() );
+  if ( ! mapDir )
+    return false;
+  while ( struct dirent * entry = ::readdir( mapDir ) )
+  {
+    if ( entry->d_name[0] == '.' )
+      continue;
+    res = inOurRoot( mapFiles + "/" + entry->d_name );
+    if ( res != IGNORE )
+      break;
+  }
+  ::closedir( mapDir );
+  return res == CONTAINER;
+}
+
+std::vector<DeletedFilesScanner::ProcInfo> DeletedFilesScanner::scan() const
+{
+  std::vector<pid_t> pids;
+  DIR * dir = ::opendir( "/proc" );
+  if ( dir )
+  {
+    while ( struct dirent * entry = ::readdir( dir ) )
+    {
+      if ( ::isdigit( entry->d_name[0] ) )
+        pids.push_back( zypp::str::strtonum<pid_t>( entry->d_name ) );
+    }
+    ::closedir( dir );
+  }
+  else
+  {
+    int err = errno;
+    ERR << "Can't read /proc: " << zypp::str::strerror( err ) << std::endl;
+    ZYPP_THROW( zypp::Exception( zypp::str::Str() << "Can't read /proc: " << zypp::str::strerror( err ) ) );
+  }
+
+  return scan( pids );
+}
+
+std::vector<DeletedFilesScanner::ProcInfo> DeletedFilesScanner::scan( pid_t pid_r ) const
+{ return scan( std::vector<pid_t>{ pid_r } ); }
+
+std::vector<DeletedFilesScanner::ProcInfo> DeletedFilesScanner::scan( const std::vector<pid_t> & pids_r ) const
+{
+  unsigned threads = std::max( 1U, std::min( _threads, unsigned( pids_r.size() / 64 + 1 ) ) );
+  MIL << "Scanning " << pids_r.size() << " processes using " << threads << " threads"
+      << ( _filter.empty() ? "" : " (filtered)" ) << std::endl;
+
+  std::atomic<size_t> next { 0 };
+  std::vector<std::vector<ProcInfo>> results( threads );
+  auto work = [&]( unsigned idx_r ) {
+    Worker worker( _filter );
+    for ( size_t i = next++; i < pids_r.size(); i = next++ )
+      worker.scan( pids_r[i], results[idx_r] );
+  };
+
+  std::vector<std::thread> workers;
+  for ( unsigned i = 1; i < threads; ++i )
+    workers.emplace_back( work, i );
+  work( 0 );
+  for ( auto & worker : workers )
+    worker.join();
+
+  std::vector<ProcInfo> ret;
+  for ( auto & result : results )
+    std::move( result.begin(), result.end(), std::back_inserter( ret ) );
+  std::sort( ret.begin(), ret.end(), []( const ProcInfo & lhs, const ProcInfo & rhs ) {
+    return zypp::str::strtonum<pid_t>( lhs.pid ) < zypp::str::strtonum<pid_t>( rhs.pid );
+  } );
+  MIL << ret.size() << " processes use deleted files" << std::endl;
+  return ret;
+}
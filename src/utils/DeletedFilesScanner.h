@@ -0,0 +1,69 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_DELETEDFILESSCANNER_H
+#define ZYPPER_UTILS_DELETEDFILESSCANNER_H
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <zypp/misc/CheckAccessDeleted.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class DeletedFilesScanner
+/// \brief Find running processes using deleted files (zypper ps).
+///
+/// A replacement for zypp::CheckAccessDeleted::check which reads
+/// \c /proc/<pid>/maps and \c /proc/<pid>/fd directly instead of running
+/// \c lsof. The processes are distributed among a few threads, each of
+/// them using its own read buffer. The threads just read from /proc and
+/// don't call into libzypp.
+///
+/// The result is the same kind of ProcInfo list CheckAccessDeleted
+/// provides, sorted by PID. Files below /dev, /proc, /sys, /run, /tmp and
+/// similar volatile locations as well as shared memory objects are not
+/// reported. Like CheckAccessDeleted, processes running in a container
+/// (a different root) are not reported either.
+///////////////////////////////////////////////////////////////////
+class DeletedFilesScanner
+{
+public:
+  using ProcInfo = zypp::CheckAccessDeleted::ProcInfo;
+
+public:
+  /** Ctor taking the max. number of threads to use (0: number of online CPUs). */
+  DeletedFilesScanner( unsigned threads_r = 0 );
+
+  /** Report only deleted files contained in \a files_r (e.g. the files
+   * touched by the last transaction). An empty set reports all files.
+   *
+   * Processes see the resolved paths (e.g. /usr/lib64 rather than /lib64
+   * on a usr-merged system), so the directories of the \a files_r are
+   * resolved and the files are matched by both paths.
+   */
+  void setFileFilter( std::unordered_set<std::string> files_r );
+
+  /** Scan all processes in \c /proc.
+   * \throws zypp::Exception if \c /proc can not be read.
+   */
+  std::vector<ProcInfo> scan() const;
+
+  /** Whether the process \a pid_r runs in a container (as CheckAccessDeleted decides it). */
+  static bool runsInContainer( pid_t pid_r );
+
+  /** Scan the process \a pid_r only. */
+  std::vector<ProcInfo> scan( pid_t pid_r ) const;
+
+private:
+  std::vector<ProcInfo> scan( const std::vector<pid_t> & pids_r ) const;
+
+private:
+  unsigned _threads;
+  std::unordered_set<std::string> _filter;
+};
+
+#endif // ZYPPER_UTILS_DELETEDFILESSCANNER_H
@@ -0,0 +1,222 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+
+#include "HistoryLog.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+// class HistoryLog::Line
+///////////////////////////////////////////////////////////////////
+
+std::string_view HistoryLog::Line::field( unsigned idx_r ) const
+{
+  std::string_view::size_type start = 0;
+  for ( std::string_view::size_type pos = 0; pos <= text.size(); ++pos )
+  {
+    if ( pos == text.size() || text[pos] == '|' )
+    {
+      if ( idx_r == 0 )
+        return text.substr( start, pos - start );
+      --idx_r;
+      start = pos + 1;
+    }
+    else if ( text[pos] == '\\' )
+      ++pos;	// escaped char
+  }
+  return std::string_view();
+}
+
+std::string_view HistoryLog::Line::action() const
+{
+  std::string_view ret { field( 1 ) };
+  std::string_view::size_type end = ret.find_last_not_of( ' ' );
+  return ret.substr( 0, end == std::string_view::npos ? 0 : end + 1 );
+}
+
+HistoryLogData::FieldVector HistoryLog::Line::fields() const
+{
+  HistoryLogData::FieldVector ret;
+  str::splitEscaped( std::string( text ), std::back_inserter(ret), "|", true );
+  return ret;
+}
+
+HistoryLogData::Ptr HistoryLog::Line::data() const
+{
+  try
+  {
+    return HistoryLogData::create( fields() );
+  }
+  catch ( const Exception & excpt )
+  {
+    ZYPP_CAUGHT( excpt );	// like parser::HistoryLogReader::IGNORE_INVALID_ITEMS
+  }
+  return HistoryLogData::Ptr();
+}
+
+///////////////////////////////////////////////////////////////////
+// class HistoryLog
+///////////////////////////////////////////////////////////////////
+
+HistoryLog::HistoryLog( const Pathname & file_r )
+: _file( file_r )
+{
+  int fd = ::open( file_r.c_str(), O_RDONLY | O_CLOEXEC );
+  if ( fd < 0 )
+  {
+    if ( errno != ENOENT )
+      WAR << "Can't open " << file_r << ": " << ::strerror( errno ) << endl;
+    return;
+  }
+
+  struct stat st;
+  if ( ::fstat( fd, &st ) == 0 && S_ISREG(st.st_mode) )
+  {
+    _valid = true;
+    _size = st.st_size;
+    if ( _size )
+    {
+      void * addr = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if ( addr == MAP_FAILED )
+      {
+        WAR << "Can't map " << file_r << ": " << ::strerror( errno ) << endl;
+        _valid = false;
+        _size = 0;
+      }
+      else
+      {
+        _data = static_cast<const char *>( addr );
+        const void * lastNL = ::memrchr( _data, '\n', _size );
+        _end = lastNL ? static_cast<const char *>( lastNL ) - _data + 1 : 0;
+      }
+    }
+  }
+  ::close( fd );
+  DBG << file_r << ": " << _end << " bytes of complete lines" << endl;
+}
+
+HistoryLog::~HistoryLog()
+{
+  if ( _data )
+    ::munmap( const_cast<char *>( _data ), _size );
+}
+
+std::string HistoryLog::dateString( const Date & date_r )
+{ return date_r.form( HISTORY_LOG_DATE_FORMAT ); }
+
+void HistoryLog::buildIndex() const
+{
+  std::string_view maxDate;
+  for ( off_t block = 0; block < _end; block += indexBlockSize )
+  {
+    // the first line starting at or after block
+    off_t pos = block;
+    if ( pos )
+    {
+      const void * nl = ::memchr( _data + pos - 1, '\n', _end - pos + 1 );
+      pos = static_cast<const char *>( nl ) - _data + 1;	// _end is past a newline
+    }
+    // its date, skipping comments
+    while ( pos < _end )
+    {
+      const char * eol = static_cast<const char *>( ::memchr( _data + pos, '\n', _end - pos ) );
+      Line line { std::string_view( _data + pos, eol - ( _data + pos ) ), pos };
+      if ( ! line.text.empty() && line.text[0] != '#' )
+      {
+        std::string_view date { line.date() };
+        if ( date > maxDate )
+          maxDate = date;
+        if ( _index.empty() || _index.back().second != pos )
+          _index.push_back( { maxDate, pos } );
+        break;
+      }
+      pos = eol - _data + 1;
+    }
+  }
+  DBG << _file << ": " << _index.size() << " index entries" << endl;
+}
+
+off_t HistoryLog::seek( const std::string & since_r ) const
+{
+  if ( _index.empty() )
+    buildIndex();
+
+  // The first entry dated since_r or later; the lines before it
+  // back to the previous entry may be dated since_r as well.
+  auto it = std::lower_bound( _index.begin(), _index.end(), std::string_view( since_r ),
+                              []( const std::pair<std::string_view,off_t> & entry_r, std::string_view date_r ) {
+                                return entry_r.first < date_r;
+                              } );
+  if ( it == _index.begin() )
+    return 0;
+  return (--it)->second;
+}
+
+unsigned HistoryLog::forEach( const Filter & filter_r, const std::function<bool(const Line &)> & fnc_r ) const
+{
+  if ( ! _data || ! fnc_r )
+    return 0;
+
+  off_t pos = filter_r._offset;
+  std::string since;
+  if ( filter_r._since )
+  {
+    since = dateString( filter_r._since );
+    pos = std::max( pos, seek( dateString( Date( Date::ValueType(filter_r._since) - clockSlack ) ) ) );
+  }
+  std::string until;
+  std::string untilSlack;
+  if ( filter_r._until )
+  {
+    until = dateString( filter_r._until );
+    untilSlack = dateString( Date( Date::ValueType(filter_r._until) + clockSlack ) );
+  }
+
+  unsigned ret = 0;
+  while ( pos < _end )
+  {
+    const char * eol = static_cast<const char *>( ::memchr( _data + pos, '\n', _end - pos ) );
+    Line line { std::string_view( _data + pos, eol - ( _data + pos ) ), pos };
+    pos = eol - _data + 1;
+
+    if ( line.text.empty() || line.text[0] == '#' )
+      continue;
+
+    if ( ! since.empty() || ! until.empty() )
+    {
+      std::string_view date { line.date() };
+      if ( ! since.empty() && date < since )
+        continue;
+      if ( ! until.empty() && date > until )
+      {
+        if ( date > untilSlack )
+          break;	// the rest is even later
+        continue;
+      }
+    }
+
+    if ( ! filter_r._actions.empty()
+      && std::find( filter_r._actions.begin(), filter_r._actions.end(), line.action() ) == filter_r._actions.end() )
+      continue;
+
+    ++ret;
+    if ( ! fnc_r( line ) )
+      break;
+  }
+  return ret;
+}
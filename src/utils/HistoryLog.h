@@ -0,0 +1,124 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_HISTORYLOG_H
+#define ZYPPER_UTILS_HISTORYLOG_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/Date.h>
+#include <zypp/HistoryLogData.h>
+#include <zypp/Pathname.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class HistoryLog
+/// \brief Memory mapped read access to the zypp history log.
+///
+/// Unlike parser::HistoryLogReader no object is created for a line unless
+/// asked for (\ref Line::data). Lines are filtered by date and action ID
+/// on the mapped data. The log is written in chronological order, so a
+/// sparse index of the dates (one per \ref indexBlockSize bytes) is used
+/// to skip the lines before the requested time range.
+///
+/// The dates are written in local time, so they may go back when the
+/// clock is changed (e.g. daylight saving time). The index lookup allows
+/// for \ref clockSlack; the lines are then compared exactly.
+///
+/// Just the complete lines present when the log was opened are visible.
+///////////////////////////////////////////////////////////////////
+class HistoryLog : private zypp::base::NonCopyable
+{
+public:
+  /** Bytes per index entry. */
+  static constexpr off_t indexBlockSize = 64 * 1024;
+  /** How far the dates in the log may go back. */
+  static constexpr zypp::Date::ValueType clockSlack = 2 * 60 * 60;
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class HistoryLog::Line
+  /// \brief A line of the log. The text points into the mapped file.
+  ///////////////////////////////////////////////////////////////////
+  struct Line
+  {
+    std::string_view text;	///< the line without the newline
+    off_t offset = 0;		///< the lines offset in the file
+
+    /** The \a idx_r-th field (still escaped) or an empty view. */
+    std::string_view field( unsigned idx_r ) const;
+
+    std::string_view date() const
+    { return field( 0 ); }
+
+    /** The action ID without the padding the log writes for some
+     * (\c "remove ", \c "patch  "), as \ref zypp::HistoryActionID::asString. */
+    std::string_view action() const;
+
+    /** The unescaped fields. */
+    zypp::HistoryLogData::FieldVector fields() const;
+
+    /** The parsed line or \c nullptr if it is malformed. */
+    zypp::HistoryLogData::Ptr data() const;
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class HistoryLog::Filter
+  /// \brief The lines to visit in \ref forEach.
+  ///
+  /// \c _actions are compared to \ref Line::action, so they are unpadded.
+  ///////////////////////////////////////////////////////////////////
+  struct Filter
+  {
+    zypp::Date _since;			///< no lines before (Date() for any)
+    zypp::Date _until;			///< no lines after (Date() for any)
+    std::vector<std::string> _actions;	///< unpadded action IDs (empty for all)
+    off_t _offset = 0;			///< start at this offset (must be a line start)
+  };
+
+public:
+  /** Ctor mapping \a file_r. */
+  HistoryLog( const zypp::Pathname & file_r );
+
+  ~HistoryLog();
+
+  /** Whether the log could be opened (an empty log is fine). */
+  explicit operator bool() const
+  { return _valid; }
+
+  /** The offset past the last complete line. */
+  off_t end() const
+  { return _end; }
+
+  /** Call \a fnc_r for each line (no comments) passing \a filter_r in
+   * chronological order. Stop if it returns \c false.
+   * \return the number of lines passed to \a fnc_r.
+   */
+  unsigned forEach( const Filter & filter_r, const std::function<bool(const Line &)> & fnc_r ) const;
+
+  /** The string a lines date is compared to. */
+  static std::string dateString( const zypp::Date & date_r );
+
+private:
+  /** The offset of a line at or before the first one dated \a since_r (local time string). */
+  off_t seek( const std::string & since_r ) const;
+  void buildIndex() const;
+
+private:
+  zypp::Pathname _file;
+  const char * _data = nullptr;
+  size_t _size = 0;
+  off_t _end = 0;
+  bool _valid = false;
+  /** The first date at or after each block start and its line offset.
+   * Dates are made non-decreasing (the maximum seen so far). */
+  mutable std::vector<std::pair<std::string_view,off_t>> _index;
+};
+
+#endif // ZYPPER_UTILS_HISTORYLOG_H
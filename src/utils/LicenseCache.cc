@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/Digest.h>
+
+#include "AtomicFile.h"
+#include "LicenseCache.h"
+
+using namespace zypp;
+
+namespace
+{
+  const std::string magic { "zypper-license-cache 1" };
+}
+
+LicenseCache::LicenseCache( Pathname file_r )
+: _file( std::move(file_r) )
+{
+  std::ifstream in( _file.c_str() );
+  if ( ! in )
+    return;
+
+  std::string line;
+  if ( ! std::getline( in, line ) || line != magic )
+  {
+    MIL << "Ignore unknown license cache " << _file << endl;
+    return;
+  }
+  while ( std::getline( in, line ) )
+  {
+    // ident TAB hash
+    std::vector<std::string> words;
+    if ( str::split( line, std::back_inserter(words), "\t" ) != 2 )
+    {
+      WAR << "Ignore broken license cache " << _file << endl;
+      _hashes.clear();
+      return;
+    }
+    _hashes[words[0]] = words[1];
+  }
+  DBG << _file << ": " << _hashes.size() << " licenses" << endl;
+}
+
+std::string LicenseCache::licenseHash( const std::string & license_r )
+{
+  std::istringstream str( license_r );
+  return Digest::digest( Digest::sha256(), str );
+}
+
+bool LicenseCache::accepted( const std::string & ident_r, const std::string & license_r ) const
+{
+  auto it = _hashes.find( ident_r );
+  return it != _hashes.end() && it->second == licenseHash( license_r );
+}
+
+void LicenseCache::accept( const std::string & ident_r, const std::string & license_r )
+{
+  std::string & hash { _hashes[ident_r] };
+  std::string newHash { licenseHash( license_r ) };
+  if ( hash != newHash )
+  {
+    hash.swap( newHash );
+    _dirty = true;
+  }
+}
+
+void LicenseCache::save()
+{
+  if ( ! _dirty || _file.empty() )
+    return;
+  _dirty = false;
+
+  writeFileAtomic( _file, [this]( std::ostream & out ) {
+    out << magic << '\n';
+    for ( const auto & p : _hashes )
+      out << p.first << '\t' << p.second << '\n';
+  } );
+}
@@ -0,0 +1,56 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_LICENSECACHE_H
+#define ZYPPER_UTILS_LICENSECACHE_H
+
+#include <map>
+#include <string>
+
+#include <zypp/Pathname.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class LicenseCache
+/// \brief Hashes of the license texts agreed to, by product/package.
+///
+/// A license needs no confirmation on update if it did not change since
+/// the installed version. Instead of loading and comparing the full texts
+/// of all installed versions, the new text's hash is compared to the one
+/// remembered when the license was last agreed to. The texts are compared
+/// just if there is no (matching) entry yet, e.g. after the cache was
+/// cleaned.
+///
+/// The cache is kept in the zypper subdirectory of the repo cache.
+///////////////////////////////////////////////////////////////////
+class LicenseCache
+{
+public:
+  /** Ctor reading \a file_r (if it exists). */
+  LicenseCache( zypp::Pathname file_r );
+
+  /** The cache file used for \a repoCachePath_r. */
+  static zypp::Pathname defaultFile( const zypp::Pathname & repoCachePath_r )
+  { return repoCachePath_r / "zypper/accepted-licenses"; }
+
+  /** Whether \a license_r is the text last agreed to for \a ident_r. */
+  bool accepted( const std::string & ident_r, const std::string & license_r ) const;
+
+  /** Remember \a license_r was agreed to for \a ident_r. */
+  void accept( const std::string & ident_r, const std::string & license_r );
+
+  /** Write the cache (see \ref writeFileAtomic) if it was changed. */
+  void save();
+
+  /** The hash of \a license_r. */
+  static std::string licenseHash( const std::string & license_r );
+
+private:
+  zypp::Pathname _file;
+  std::map<std::string,std::string> _hashes;	///< by ident
+  bool _dirty = false;
+};
+
+#endif // ZYPPER_UTILS_LICENSECACHE_H
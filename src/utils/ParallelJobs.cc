@@ -0,0 +1,267 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <list>
+#include <map>
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <zypp/base/Logger.h>
+
+#include "Zypper.h"
+#include "ParallelJobs.h"
+
+namespace
+{
+  /** Exit status of a child if the job threw or returned an out of range value. */
+  constexpr int childFailed = 255;
+
+  /** Prepare the forked child and run the job. Never returns. */
+  [[noreturn]] void runInChild( const ParallelJobs::Job & job_r )
+  {
+    ::signal( SIGINT,  SIG_DFL );
+    ::signal( SIGTERM, SIG_DFL );
+    ::signal( SIGPIPE, SIG_DFL );
+
+    int devnull = ::open( "/dev/null", O_RDWR );
+    if ( devnull != -1 )
+    {
+      ::dup2( devnull, STDIN_FILENO );
+      ::dup2( devnull, STDOUT_FILENO );
+      ::dup2( devnull, STDERR_FILENO );
+      if ( devnull > STDERR_FILENO )
+        ::close( devnull );
+    }
+
+    int res = childFailed;
+    try
+    {
+      res = job_r();
+    }
+    catch ( const Exception & excpt )
+    {
+      ZYPP_CAUGHT( excpt );
+    }
+    catch ( ... )
+    {
+      ERR << "Job in child " << ::getpid() << " threw an unknown exception." << endl;
+    }
+    if ( res < 0 || res >= childFailed )
+      res = childFailed;
+    ::_exit( res );
+  }
+} // namespace
+
+ParallelJobs::ParallelJobs( unsigned maxJobs_r )
+: _maxJobs( maxJobs_r ? maxJobs_r : 1 )
+{}
+
+std::vector<int> ParallelJobs::run( const Finished & finished_r )
+{
+  std::vector<int> ret( _jobs.size(), failed );
+  if ( _jobs.empty() )
+    return ret;
+
+  MIL << "Running " << _jobs.size() << " jobs (max " << _maxJobs << " in parallel, max "
+      << _maxJobsPerGroup << " per group)" << endl;
+
+  std::list<unsigned> pending;			// job indices not yet started
+  for ( unsigned idx = 0; idx < _jobs.size(); ++idx )
+    pending.push_back( idx );
+  std::map<pid_t,unsigned> running;		// child pid -> job index
+  std::map<std::string,unsigned> runningInGroup;
+  bool terminated = false;
+
+  auto done = [&]( unsigned idx_r )
+  {
+    const std::string & group( _jobs[idx_r]._group );
+    if ( ! group.empty() )
+      --runningInGroup[group];
+    if ( finished_r )
+      finished_r( idx_r, ret[idx_r] );
+  };
+
+  // Collect finished children. If wait_r is set return not before at
+  // least one child finished (or none is running).
+  auto collect = [&]( bool wait_r )
+  {
+    while ( ! running.empty() )
+    {
+      bool reaped = false;
+      for ( auto it = running.begin(); it != running.end(); )
+      {
+        int status = 0;
+        pid_t pid = ::waitpid( it->first, &status, WNOHANG );
+        if ( pid == 0 || ( pid == -1 && errno == EINTR ) )
+        {
+          ++it;	// still running
+          continue;
+        }
+
+        unsigned idx = it->second;
+        if ( pid == it->first && WIFEXITED( status ) && WEXITSTATUS( status ) != childFailed )
+          ret[idx] = WEXITSTATUS( status );
+        else
+          WAR << "Job " << idx << " (pid " << it->first << ") failed with status " << status << endl;
+        it = running.erase( it );
+        reaped = true;
+        done( idx );
+      }
+
+      // No need to wait for the remaining jobs if the user wants to quit.
+      // (instance(true): don't exit from here while children are running)
+      if ( ! terminated && Zypper::instance( true ).exitRequested() )
+      {
+        WAR << "Exit requested: terminating " << running.size() << " running jobs." << endl;
+        for ( const auto & el : running )
+          ::kill( el.first, SIGTERM );
+        terminated = true;
+      }
+
+      if ( reaped || ! wait_r )
+        break;
+      ::usleep( 10000 );
+    }
+  };
+
+  // The first pending job whose group is not at its limit.
+  auto nextStartable = [&]() -> std::list<unsigned>::iterator
+  {
+    if ( ! _maxJobsPerGroup )
+      return pending.begin();
+    for ( auto it = pending.begin(); it != pending.end(); ++it )
+    {
+      const std::string & group( _jobs[*it]._group );
+      if ( group.empty() || runningInGroup[group] < _maxJobsPerGroup )
+        return it;
+    }
+    return pending.end();
+  };
+
+  while ( ! pending.empty() )
+  {
+    if ( terminated || Zypper::instance( true ).exitRequested() )
+    {
+      WAR << "Exit requested: not starting the remaining " << pending.size() << " jobs." << endl;
+      break;
+    }
+
+    auto next = pending.end();
+    if ( running.size() < _maxJobs )
+      next = nextStartable();
+    if ( next == pending.end() )
+    {
+      collect( true );	// all slots (or all slots of the pending groups) are busy
+      continue;
+    }
+
+    unsigned idx = *next;
+    pending.erase( next );
+
+    // don't let the child inherit pending output
+    cout.flush();
+    cerr.flush();
+
+    pid_t pid = ::fork();
+    if ( pid == -1 )
+    {
+      ERR << "fork for job " << idx << " failed: " << ::strerror( errno ) << endl;
+      if ( finished_r )
+        finished_r( idx, ret[idx] );	// ret[idx] stays 'failed'
+      continue;
+    }
+    if ( pid == 0 )
+      runInChild( _jobs[idx]._job );
+
+    DBG << "Job " << idx << " running in pid " << pid << endl;
+    running[pid] = idx;
+    if ( ! _jobs[idx]._group.empty() )
+      ++runningInGroup[_jobs[idx]._group];
+    collect( false );
+  }
+
+  while ( ! running.empty() )
+    collect( true );
+
+  MIL << "Done running jobs" << endl;
+  return ret;
+}
+
+unsigned ParallelJobs::onlineCPUs()
+{
+  long cpus = ::sysconf( _SC_NPROCESSORS_ONLN );
+  return cpus > 0 ? unsigned(cpus) : 1U;
+}
+
+///////////////////////////////////////////////////////////////////
+/// class BackgroundJob
+///////////////////////////////////////////////////////////////////
+
+BackgroundJob::BackgroundJob( const ParallelJobs::Job & job_r )
+{
+  // don't let the child inherit pending output
+  cout.flush();
+  cerr.flush();
+
+  _pid = ::fork();
+  if ( _pid == -1 )
+  {
+    ERR << "fork for background job failed: " << ::strerror( errno ) << endl;
+    return;
+  }
+  if ( _pid == 0 )
+    runInChild( job_r );
+
+  DBG << "Background job running in pid " << _pid << endl;
+}
+
+BackgroundJob::~BackgroundJob()
+{ wait(); }
+
+int BackgroundJob::wait()
+{
+  bool terminated = false;
+  while ( _pid > 0 )
+  {
+    int status = 0;
+    pid_t pid = ::waitpid( _pid, &status, WNOHANG );
+    if ( pid == 0 || ( pid == -1 && errno == EINTR ) )
+    {
+      // (instance(true): don't exit from here while the child is running)
+      if ( ! terminated && Zypper::instance( true ).exitRequested() )
+      {
+        WAR << "Exit requested: terminating background job " << _pid << endl;
+        ::kill( _pid, SIGTERM );
+        terminated = true;
+      }
+      ::usleep( 10000 );
+      continue;
+    }
+
+    if ( pid == _pid && WIFEXITED( status ) && WEXITSTATUS( status ) != childFailed )
+      _result = WEXITSTATUS( status );
+    else
+      WAR << "Background job (pid " << _pid << ") failed with status " << status << endl;
+    _pid = -1;
+  }
+  return _result;
+}
+
+int BackgroundJob::cancel()
+{
+  if ( _pid > 0 )
+  {
+    DBG << "Cancelling background job " << _pid << endl;
+    ::kill( _pid, SIGTERM );
+  }
+  return wait();
+}
@@ -0,0 +1,140 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_PARALLELJOBS_H
+#define ZYPPER_UTILS_PARALLELJOBS_H
+
+#include <sys/types.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////
+/// \class ParallelJobs
+/// \brief Run independent jobs concurrently in forked worker processes.
+///
+/// libzypp is not thread safe, so work which could be done concurrently
+/// (e.g. downloading the raw metadata of different repos) is executed in
+/// child processes. At most \ref maxJobs children are running at a time.
+///
+/// A job is executed in the child and its return value (0..254) becomes
+/// the childs exit status. Anything else the parent needs to know must be
+/// passed via the filesystem (e.g. the metadata cache).
+///
+/// The children terminate via \c _exit, so no static destructors (e.g.
+/// the one releasing the zypp lock) are run. Their stdin, stdout and
+/// stderr are redirected to /dev/null and the default signal handlers
+/// are restored. A job must not expect to interact with the user.
+///
+/// Jobs may be assigned to a group (e.g. the repo they download from) and
+/// the number of concurrently running jobs per group can be limited by
+/// \ref setMaxJobsPerGroup.
+///
+/// Jobs are started in the order they were added (unless their group is
+/// at its limit). \ref run returns the results in the order the jobs were
+/// added, independent of when the children finished.
+///////////////////////////////////////////////////////////////////
+class ParallelJobs
+{
+public:
+  using Job = std::function<int()>;
+
+  /** Called in the parent whenever a job is done: (job index, result). */
+  using Finished = std::function<void( unsigned, int )>;
+
+  /** Result of a job which could not be started, crashed or was killed. */
+  static constexpr int failed = -1;
+
+public:
+  /** Ctor taking the max. number of concurrently running jobs (at least 1). */
+  ParallelJobs( unsigned maxJobs_r );
+
+  /** The max. number of concurrently running jobs. */
+  unsigned maxJobs() const
+  { return _maxJobs; }
+
+  /** The max. number of concurrently running jobs per group (0: no limit). */
+  unsigned maxJobsPerGroup() const
+  { return _maxJobsPerGroup; }
+
+  /** Set the max. number of concurrently running jobs per group (0: no limit). */
+  void setMaxJobsPerGroup( unsigned maxJobs_r )
+  { _maxJobsPerGroup = maxJobs_r; }
+
+  /** Number of jobs added. */
+  unsigned size() const
+  { return _jobs.size(); }
+
+  /** Whether no jobs were added. */
+  bool empty() const
+  { return _jobs.empty(); }
+
+  /** Add a job to be run in a child process.
+   * Jobs with an empty \a group_r are not subject to the per group limit.
+   */
+  void add( Job job_r, std::string group_r = std::string() )
+  { _jobs.push_back( { std::move(job_r), std::move(group_r) } ); }
+
+  /** Run all jobs and wait until they are done.
+   * If zypper is requested to exit, no new jobs are started and the
+   * running ones are terminated.
+   * \param finished_r optional callback invoked as each job is done
+   * \return the job results in the order the jobs were added.
+   */
+  std::vector<int> run( const Finished & finished_r = Finished() );
+
+  /** The number of online CPUs (at least 1). */
+  static unsigned onlineCPUs();
+
+private:
+  struct JobEntry
+  {
+    Job _job;
+    std::string _group;
+  };
+
+  unsigned _maxJobs;
+  unsigned _maxJobsPerGroup = 0;
+  std::vector<JobEntry> _jobs;
+};
+
+///////////////////////////////////////////////////////////////////
+/// \class BackgroundJob
+/// \brief Run a single job in a forked worker process while the parent continues.
+///
+/// The same rules as for \ref ParallelJobs apply to the job. The child is
+/// started by the ctor. The dtor waits for it, unless \ref wait was called.
+///////////////////////////////////////////////////////////////////
+class BackgroundJob
+{
+public:
+  /** Ctor starting \a job_r in a child process. */
+  BackgroundJob( const ParallelJobs::Job & job_r );
+
+  BackgroundJob( const BackgroundJob & ) = delete;
+  BackgroundJob & operator=( const BackgroundJob & ) = delete;
+
+  /** Dtor waits for the child. */
+  ~BackgroundJob();
+
+  /** Wait until the job is done.
+   * If zypper is requested to exit, the child is terminated.
+   * \return the job result or \ref ParallelJobs::failed.
+   */
+  int wait();
+
+  /** Ask the job to stop (SIGTERM) and wait until it is done.
+   * \return the job result or \ref ParallelJobs::failed.
+   */
+  int cancel();
+
+private:
+  pid_t _pid = -1;
+  int _result = ParallelJobs::failed;
+};
+
+#endif // ZYPPER_UTILS_PARALLELJOBS_H
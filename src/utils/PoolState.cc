@@ -0,0 +1,197 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <list>
+#include <sstream>
+#include <vector>
+#include <sys/stat.h>
+
+#include <zypp/ZYpp.h>
+#include <zypp/ZConfig.h>
+#include <zypp/Target.h>
+#include <zypp/Repository.h>
+#include <zypp/PathInfo.h>
+#include <zypp/base/Logger.h>
+#include <zypp/sat/Pool.h>
+
+#include "Zypper.h"
+#include "PoolState.h"
+
+extern ZYpp::Ptr God;
+
+PoolState::Stamp::Stamp( const Pathname & file_r )
+{
+  struct stat st;
+  if ( ::stat( file_r.c_str(), &st ) == 0 )
+  {
+    _mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    _size = st.st_size;
+    _ino = st.st_ino;
+  }
+}
+
+PoolState::Stamps PoolState::rpmdbStamps( Zypper & zypper_r )
+{
+  // whatever backend and location the rpm database uses
+  static const char * dirs[] = { "usr/lib/sysimage/rpm", "var/lib/rpm" };
+  static const char * files[] = { "rpmdb.sqlite", "rpmdb.sqlite-wal", "Packages.db", "Packages" };
+
+  Stamps ret;
+  Pathname root { zypper_r.config().root_dir };
+  for ( const char * dir : dirs )
+  {
+    for ( const char * file : files )
+    {
+      Pathname path { root / dir / file };
+      ret[path.asString()] = Stamp( path );
+    }
+  }
+  return ret;
+}
+
+PoolState::Stamps PoolState::repoConfigStamps( Zypper & zypper_r )
+{
+  Stamps ret;
+  const RepoManagerOptions & options { zypper_r.config().rm_options };
+  for ( const Pathname & dir : { options.knownReposPath, options.knownServicesPath } )
+  {
+    ret[dir.asString()] = Stamp( dir );	// files added or removed
+    std::list<std::string> entries;
+    if ( filesystem::readdir( entries, dir, /*dots*/false ) == 0 )
+    {
+      for ( const std::string & entry : entries )
+        ret[(dir/entry).asString()] = Stamp( dir/entry );
+    }
+  }
+  return ret;
+}
+
+std::string PoolState::fingerprint( Zypper & zypper_r, const std::list<RepoInfo> & repos_r )
+{
+  std::ostringstream str;
+  auto add = [&str]( const std::string & name_r, const Stamp & stamp_r ) {
+    str << name_r << ' ' << stamp_r._mtime << ' ' << stamp_r._size << ' ' << stamp_r._ino << '\n';
+  };
+
+  for ( const auto & p : rpmdbStamps( zypper_r ) )
+    add( p.first, p.second );
+  for ( const auto & p : repoConfigStamps( zypper_r ) )
+    add( p.first, p.second );
+
+  const Pathname & solvCache { zypper_r.config().rm_options.repoSolvCachePath };
+  for ( const RepoInfo & repo : repos_r )
+  {
+    Stamp solv { solvCache / repo.escaped_alias() / "solv" };
+    if ( solv._size < 0 )
+      return std::string();
+    add( "solv:" + repo.alias(), solv );
+    add( "cookie:" + repo.alias(), Stamp( solvCache / repo.escaped_alias() / "cookie" ) );
+  }
+
+  // a file or a directory and the files in it
+  auto addTree = [&add]( const std::string & name_r, const Pathname & path_r ) {
+    add( name_r, Stamp( path_r ) );
+    std::list<std::string> entries;
+    if ( filesystem::readdir( entries, path_r, /*dots*/false ) == 0 )
+    {
+      for ( const std::string & entry : entries )
+        add( name_r + "/" + entry, Stamp( path_r/entry ) );
+    }
+  };
+
+  const ZConfig & zconfig { ZConfig::instance() };
+  const Pathname & root { zypper_r.config().root_dir };
+  add( "locks", Stamp( Pathname::assertprefix( root, zconfig.locksFile() ) ) );
+  add( "history", Stamp( Pathname::assertprefix( root, zconfig.historyLogFile() ) ) );	// patch history
+
+  // more solver input: vendor equivalence, system requirements, multiversion
+  // packages, requested locales and the autoinstalled packages
+  addTree( "vendors", Pathname::assertprefix( root, zconfig.vendorPath() ) );
+  add( "systemCheck", Stamp( Pathname::assertprefix( root, zconfig.solver_checkSystemFile() ) ) );
+  addTree( "systemCheck.d", Pathname::assertprefix( root, zconfig.solver_checkSystemFileDir() ) );
+  addTree( "multiversion.d", Pathname::assertprefix( root, zconfig.configPath() / "multiversion.d" ) );
+  add( "locales", Stamp( root / "var/lib/zypp/RequestedLocales" ) );
+  add( "autoinstalled", Stamp( root / "var/lib/zypp/AutoInstalled" ) );
+  const char * zyppConf { ::getenv( "ZYPP_CONF" ) };
+  add( "zypp.conf", Stamp( zyppConf && *zyppConf ? zyppConf : "/etc/zypp/zypp.conf" ) );
+  str << "arch " << zconfig.systemArchitecture() << '\n';
+  return str.str();
+}
+
+void PoolState::setTargetLoaded( Zypper & zypper_r )
+{
+  _targetLoaded = true;
+  _rpmdb = rpmdbStamps( zypper_r );
+}
+
+void PoolState::setReposInitialized( Zypper & zypper_r )
+{
+  _reposInitialized = true;
+  _repoConfig = repoConfigStamps( zypper_r );
+}
+
+void PoolState::setRepoLoaded( Zypper & zypper_r, const RepoInfo & repo_r )
+{ _solv[repo_r.alias()] = Stamp( zypper_r.config().rm_options.repoSolvCachePath / repo_r.escaped_alias() / "solv" ); }
+
+void PoolState::reloadChanged( Zypper & zypper_r )
+{
+  if ( _targetLoaded && rpmdbStamps( zypper_r ) != _rpmdb )
+  {
+    MIL << "The rpm database changed. Unloading the installed packages." << endl;
+    God->target()->unload();
+    _targetLoaded = false;
+  }
+
+  if ( _reposInitialized && repoConfigStamps( zypper_r ) != _repoConfig )
+  {
+    MIL << "The repo configuration changed. Unloading the repos." << endl;
+    std::vector<Repository> repos;
+    for ( const Repository & repo : sat::Pool::instance().knownRepositories() )
+    {
+      if ( ! repo.isSystemRepo() )
+        repos.push_back( repo );
+    }
+    for ( Repository & repo : repos )
+      repo.eraseFromPool();
+
+    zypper_r.initRepoManager();
+    zypper_r.runtimeData().repos.clear();
+    _reposInitialized = false;
+    _reposLoaded = false;
+    _repoConfig.clear();
+    _solv.clear();
+    return;
+  }
+
+  if ( ! _reposLoaded )
+    return;
+
+  for ( const RepoInfo & repo : zypper_r.runtimeData().repos )
+  {
+    auto it = _solv.find( repo.alias() );
+    if ( it == _solv.end() )
+      continue;	// not loaded
+
+    Stamp current { zypper_r.config().rm_options.repoSolvCachePath / repo.escaped_alias() / "solv" };
+    if ( current == it->second )
+      continue;
+
+    MIL << "The cache of " << repo.alias() << " changed. Reloading it." << endl;
+    try
+    {
+      zypper_r.repoManager().loadFromCache( repo );
+      it->second = current;
+    }
+    catch ( const Exception & e )
+    {
+      ZYPP_CAUGHT( e );
+      WAR << "Reloading " << repo.alias() << " failed. Dropping it." << endl;
+      sat::Pool::instance().reposErase( repo.alias() );
+      _solv.erase( it );
+    }
+  }
+}
@@ -0,0 +1,94 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_POOLSTATE_H
+#define ZYPPER_UTILS_POOLSTATE_H
+
+#include <list>
+#include <map>
+#include <string>
+
+#include <zypp/Pathname.h>
+#include <zypp/RepoInfo.h>
+
+class Zypper;
+
+///////////////////////////////////////////////////////////////////
+/// \class PoolState
+/// \brief What has been loaded into the pool, and from which on-disk state.
+///
+/// The target, the repo configuration and the repos are loaded once
+/// per zypper instance. In the zypper shell they are kept for the next
+/// command and \ref reloadChanged drops just the data whose on-disk state
+/// changed since it was loaded: the installed packages if the rpm
+/// database changed, a repo if its solv file changed, and all repos if a
+/// .repo or .service file was added, removed or modified.
+///////////////////////////////////////////////////////////////////
+class PoolState
+{
+public:
+  bool targetLoaded() const		{ return _targetLoaded; }
+  bool reposInitialized() const		{ return _reposInitialized; }
+  bool reposLoaded() const		{ return _reposLoaded; }
+
+  /** The installed packages have been loaded. */
+  void setTargetLoaded( Zypper & zypper_r );
+
+  /** The repos to use have been read from the repo configuration. */
+  void setReposInitialized( Zypper & zypper_r );
+
+  /** The solv file of \a repo_r has been loaded. */
+  void setRepoLoaded( Zypper & zypper_r, const zypp::RepoInfo & repo_r );
+
+  /** All repos have been loaded. */
+  void setReposLoaded()
+  { _reposLoaded = true; }
+
+  /** Reload or drop (to be reloaded on demand) what changed on disk since it was loaded. */
+  void reloadChanged( Zypper & zypper_r );
+
+  /** A string identifying the on-disk state a pool of the installed packages
+   * and \a repos_r is built from: the rpm database, the repo configuration,
+   * the solv files and cookies of \a repos_r, the locks, the history log,
+   * zypp.conf and the other solver input (vendors.d, systemCheck(.d),
+   * multiversion.d, the requested locales and the autoinstalled packages).
+   * Empty if a solv file of \a repos_r does not exist (yet).
+   */
+  static std::string fingerprint( Zypper & zypper_r, const std::list<zypp::RepoInfo> & repos_r );
+
+private:
+  /** Identifies a files content (mtime, size and inode). */
+  struct Stamp
+  {
+    Stamp()
+    {}
+    Stamp( const zypp::Pathname & file_r );
+
+    bool operator==( const Stamp & rhs ) const
+    { return _mtime == rhs._mtime && _size == rhs._size && _ino == rhs._ino; }
+    bool operator!=( const Stamp & rhs ) const
+    { return ! operator==( rhs ); }
+
+    long long _mtime = 0;	///< nsec
+    long long _size = -1;	///< -1 if the file does not exist
+    unsigned long long _ino = 0;
+  };
+  using Stamps = std::map<std::string,Stamp>;
+
+  static Stamps rpmdbStamps( Zypper & zypper_r );
+  static Stamps repoConfigStamps( Zypper & zypper_r );
+
+private:
+  bool _targetLoaded = false;
+  bool _reposInitialized = false;
+  bool _reposLoaded = false;
+
+  Stamps _rpmdb;	///< by path
+  Stamps _repoConfig;	///< by path
+  Stamps _solv;		///< by repo alias
+};
+
+#endif // ZYPPER_UTILS_POOLSTATE_H
@@ -0,0 +1,261 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <sys/resource.h>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/base/Xml.h>
+
+#include "Zypper.h"
+#include "Table.h"
+#include "output/OutJSON.h"
+#include "Profile.h"
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  /** CPU time (user + system) of the process and its collected children in usec. */
+  long long cpuTime()
+  {
+    auto usec = []( const struct timeval & tv_r ) -> long long
+    { return tv_r.tv_sec * 1000000LL + tv_r.tv_usec; };
+
+    long long ret = 0;
+    struct rusage ru;
+    if ( ::getrusage( RUSAGE_SELF, &ru ) == 0 )
+      ret += usec( ru.ru_utime ) + usec( ru.ru_stime );
+    if ( ::getrusage( RUSAGE_CHILDREN, &ru ) == 0 )
+      ret += usec( ru.ru_utime ) + usec( ru.ru_stime );
+    return ret;
+  }
+
+  /** The process' peak RSS in KiB. */
+  long peakRss()
+  {
+    struct rusage ru;
+    return ::getrusage( RUSAGE_SELF, &ru ) == 0 ? ru.ru_maxrss : 0;
+  }
+
+  struct Record
+  {
+    std::string _name;
+    unsigned _depth = 0;	///< nesting level when first started
+    unsigned _calls = 0;
+    Clock::duration _wall = Clock::duration::zero();
+    long long _cpu = 0;		///< usec
+    long _peakRss = 0;		///< KiB
+
+    // while running:
+    bool _running = false;
+    Clock::time_point _wallStart;
+    long long _cpuStart = 0;
+  };
+
+  struct Data
+  {
+    bool _enabled = false;
+    Clock::time_point _wallStart;
+    long long _cpuStart = 0;
+    std::vector<Record> _records;	// in order of their first start
+    unsigned _running = 0;		// number of running phases
+
+    Record * find( const std::string & name_r )
+    {
+      for ( Record & rec : _records )
+      {
+        if ( rec._name == name_r )
+          return &rec;
+      }
+      return nullptr;
+    }
+
+    Record & record( const std::string & name_r )
+    {
+      if ( Record * rec = find( name_r ) )
+        return *rec;
+      _records.push_back( Record() );
+      _records.back()._name = name_r;
+      _records.back()._depth = _running;
+      return _records.back();
+    }
+  };
+
+  Data & data()
+  {
+    static Data _data;
+    return _data;
+  }
+
+  inline double msec( Clock::duration dur_r )
+  { return std::chrono::duration<double,std::milli>( dur_r ).count(); }
+
+  inline double msec( long long usec_r )
+  { return usec_r / 1000.0; }
+
+  inline std::string asMsecString( double msec_r )
+  { return str::form( "%.1f", msec_r ); }
+} // namespace
+
+void Profile::enable()
+{
+  Data & d( data() );
+  if ( d._enabled )
+    return;
+  d._enabled = true;
+  d._wallStart = Clock::now();
+  d._cpuStart = cpuTime();
+  MIL << "Profiling enabled" << endl;
+}
+
+bool Profile::enabled()
+{ return data()._enabled; }
+
+void Profile::start( const std::string & phase_r )
+{
+  Data & d( data() );
+  if ( ! d._enabled )
+    return;
+
+  Record & rec( d.record( phase_r ) );
+  if ( rec._running )
+    return;	// already running (recursion)
+  rec._running = true;
+  ++d._running;
+  ++rec._calls;
+  rec._wallStart = Clock::now();
+  rec._cpuStart = cpuTime();
+}
+
+void Profile::stop( const std::string & phase_r )
+{
+  Data & d( data() );
+  if ( ! d._enabled )
+    return;
+
+  Record * rec = d.find( phase_r );
+  if ( ! rec || ! rec->_running )
+    return;
+  rec->_running = false;
+  --d._running;
+  rec->_wall += Clock::now() - rec->_wallStart;
+  rec->_cpu += cpuTime() - rec->_cpuStart;
+  rec->_peakRss = std::max( rec->_peakRss, peakRss() );
+}
+
+void Profile::report( Zypper & zypper_r )
+{
+  Data & d( data() );
+  if ( ! d._enabled )
+    return;
+
+  // stop what is still running (e.g. after an exception)
+  for ( Record & rec : d._records )
+  {
+    if ( rec._running )
+      stop( rec._name );
+  }
+
+  Clock::duration wall = Clock::now() - d._wallStart;
+  long long cpu = cpuTime() - d._cpuStart;
+
+  MIL << "Profile: total " << asMsecString( msec( wall ) ) << "ms wall, " << asMsecString( msec( cpu ) ) << "ms CPU" << endl;
+  for ( const Record & rec : d._records )
+  {
+    MIL << "Profile: " << std::string( 2*rec._depth, ' ' ) << rec._name << " (" << rec._calls << "x) "
+        << asMsecString( msec( rec._wall ) ) << "ms wall, " << asMsecString( msec( rec._cpu ) ) << "ms CPU, "
+        << rec._peakRss << "KiB peak RSS" << endl;
+  }
+
+  if ( zypper_r.out().typeXML() )
+  {
+    // <profile wall="1234.5" cpu="1000.2" peak-rss="123456">
+    //   <phase name="target init" depth="0" calls="1" wall="12.3" cpu="10.1" peak-rss="54321"/>
+    // </profile>
+    xmlout::Node guard( cout, "profile", {
+      { "wall", asMsecString( msec( wall ) ) },
+      { "cpu", asMsecString( msec( cpu ) ) },
+      { "peak-rss", peakRss() },
+    } );
+    for ( const Record & rec : d._records )
+    {
+      xmlout::Node( *guard, "phase", xmlout::Node::optionalContent, {
+        { "name", rec._name },
+        { "depth", rec._depth },
+        { "calls", rec._calls },
+        { "wall", asMsecString( msec( rec._wall ) ) },
+        { "cpu", asMsecString( msec( rec._cpu ) ) },
+        { "peak-rss", rec._peakRss },
+      } );
+    }
+    return;
+  }
+
+  if ( typeJSON( zypper_r.out() ) )
+  {
+    // {"type":"profile","wall":"1234.5","cpu":"1000.2","peak-rss":123456,"phases":[{"name":"target init","depth":0,...},...]}
+    std::vector<OutJSON::Record> phases;
+    for ( const Record & rec : d._records )
+    {
+      OutJSON::Record phase;
+      phase.add( "name", rec._name )
+           .add( "depth", rec._depth )
+           .add( "calls", rec._calls )
+           .add( "wall", asMsecString( msec( rec._wall ) ) )
+           .add( "cpu", asMsecString( msec( rec._cpu ) ) )
+           .add( "peak-rss", rec._peakRss );
+      phases.push_back( phase );
+    }
+    OutJSON::Record record( "profile" );
+    record.add( "wall", asMsecString( msec( wall ) ) )
+          .add( "cpu", asMsecString( msec( cpu ) ) )
+          .add( "peak-rss", peakRss() )
+          .add( "phases", phases );
+    OutJSON::writeRecord( cout, record );
+    return;
+  }
+
+  Table tbl;
+  tbl << ( TableHeader()
+  // translators: header of table column - a phase of the command like 'solve' or 'commit'
+  << N_("Phase")
+  // translators: header of table column - how often a phase was entered
+  << N_("Calls")
+  // translators: header of table column - elapsed (wall clock) time in milliseconds
+  << N_("Wall (ms)")
+  // translators: header of table column - CPU time in milliseconds
+  << N_("CPU (ms)")
+  // translators: header of table column - the peak memory usage (resident set size) in KiB
+  << N_("Peak RSS (KiB)")
+  );
+
+  for ( const Record & rec : d._records )
+  {
+    tbl << ( TableRow()
+    << ( std::string( 2*rec._depth, ' ' ) + rec._name )
+    << rec._calls
+    << asMsecString( msec( rec._wall ) )
+    << asMsecString( msec( rec._cpu ) )
+    << rec._peakRss
+    );
+  }
+  tbl << ( TableRow()
+  // translators: the overall time and memory usage of the zypper call
+  << _("Total")
+  << ""
+  << asMsecString( msec( wall ) )
+  << asMsecString( msec( cpu ) )
+  << peakRss()
+  );
+
+  zypper_r.out().gap();
+  cout << tbl;
+}
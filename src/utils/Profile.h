@@ -0,0 +1,78 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_PROFILE_H
+#define ZYPPER_UTILS_PROFILE_H
+
+#include <string>
+
+class Zypper;
+
+///////////////////////////////////////////////////////////////////
+/// \class Profile
+/// \brief Wall time, CPU time and peak RSS of the commands lifecycle phases (--profile).
+///
+/// The phases (target init, repo refresh, solve, commit, ...) are marked
+/// in the code by \ref Profile::Phase guards or \ref start / \ref stop
+/// pairs. Unless enabled by the global \c --profile option this costs
+/// nothing but a test of a flag.
+///
+/// A phase entered more than once (e.g. building the cache of several
+/// repos) accumulates the times. A phase started while another one is
+/// running is reported as nested below it. CPU time includes the
+/// children (e.g. worker processes) collected during the phase. The
+/// peak RSS is the process' high water mark at the end of the phase.
+///////////////////////////////////////////////////////////////////
+class Profile
+{
+public:
+  /** Start recording the phases (--profile). */
+  static void enable();
+
+  /** Whether recording the phases is enabled. */
+  static bool enabled();
+
+  /** Start timing \a phase_r. */
+  static void start( const std::string & phase_r );
+
+  /** Stop timing \a phase_r. */
+  static void stop( const std::string & phase_r );
+
+  /** \overload No string is built unless profiling is enabled. */
+  static void start( const char * phase_r )
+  { if ( enabled() ) start( std::string( phase_r ) ); }
+
+  /** \overload No string is built unless profiling is enabled. */
+  static void stop( const char * phase_r )
+  { if ( enabled() ) stop( std::string( phase_r ) ); }
+
+  /** Write the breakdown (if enabled); a table or a \c <profile> element. */
+  static void report( Zypper & zypper_r );
+
+public:
+  /** Time the phase \a name_r during the guards lifetime.
+   * \a name_r must outlive the guard (it's usually a literal); no string is
+   * built unless profiling is enabled.
+   */
+  class Phase
+  {
+  public:
+    Phase( const char * name_r )
+    : _name { enabled() ? name_r : nullptr }
+    { if ( _name ) start( _name ); }
+
+    ~Phase()
+    { if ( _name ) stop( _name ); }
+
+    Phase( const Phase & ) = delete;
+    Phase & operator=( const Phase & ) = delete;
+
+  private:
+    const char * _name;	///< nullptr if not profiling
+  };
+};
+
+#endif // ZYPPER_UTILS_PROFILE_H
@@ -0,0 +1,181 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <unistd.h>
+#include <clocale>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/Digest.h>
+#include <zypp/PathInfo.h>
+
+#include "Zypper.h"
+#include "main.h"
+#include "output/OutJSON.h"
+#include "utils/AtomicFile.h"
+#include "utils/console.h"
+#include "utils/misc.h"
+#include "utils/PoolState.h"
+#include "ResultCache.h"
+
+using namespace zypp;
+
+namespace
+{
+  const std::string magic { "zypper-result-cache 1" };
+
+  /** A streambuf passing everything to \a target_r and keeping a copy. */
+  class TeeBuf : public std::streambuf
+  {
+  public:
+    TeeBuf( std::streambuf * target_r )
+    : _target( target_r )
+    {}
+
+    const std::string & copy() const
+    { return _copy; }
+
+  protected:
+    int overflow( int ch_r ) override
+    {
+      if ( ch_r == traits_type::eof() )
+        return traits_type::not_eof( ch_r );
+      _copy += traits_type::to_char_type( ch_r );
+      return _target->sputc( traits_type::to_char_type( ch_r ) );
+    }
+
+    std::streamsize xsputn( const char * s_r, std::streamsize n_r ) override
+    {
+      _copy.append( s_r, n_r );
+      return _target->sputn( s_r, n_r );
+    }
+
+    int sync() override
+    { return _target->pubsync(); }
+
+  private:
+    std::streambuf * _target;
+    std::string _copy;
+  };
+
+  /** Results worth remembering: no error. */
+  inline bool cacheable( int exitCode_r )
+  { return exitCode_r == ZYPPER_EXIT_OK || exitCode_r == ZYPPER_EXIT_INF_UPDATE_NEEDED || exitCode_r == ZYPPER_EXIT_INF_SEC_UPDATE_NEEDED; }
+} // namespace
+
+ResultCache::ResultCache( Zypper & zypper_r, std::string name_r, std::string args_r )
+: _zypper( zypper_r )
+, _name( std::move(name_r) )
+, _args( std::move(args_r) )
+{
+  if ( ! _zypper.config().cacheQueryResults || ! _zypper.runtimeData().temporary_repos.empty() )
+    return;
+
+  if ( ::geteuid() == 0 )
+    _file = _zypper.config().rm_options.repoCachePath / "zypper/results" / _name;
+  else
+  {
+    Pathname cacheHome { env::XDG_CACHE_HOME() };
+    if ( cacheHome.empty() )
+      return;
+    _file = cacheHome / "zypper/results" / _name;
+  }
+  _key = computeKey();
+}
+
+std::string ResultCache::computeKey() const
+{
+  std::string fingerprint { PoolState::fingerprint( _zypper, _zypper.runtimeData().repos ) };
+  if ( fingerprint.empty() )
+    return std::string();
+
+  const Config & config { _zypper.config() };
+  const Out & out { _zypper.out() };
+  std::stringstream str;
+  str << VERSION << '\n'
+      << _name << ' ' << _args << '\n'
+      << "out " << int(out.type()) << ' ' << typeJSON( out ) << ' ' << int(out.verbosity())
+      << ' ' << config.terse << ' ' << config.do_colors << ' ' << get_screen_width() << '\n'
+      << "lang " << ::setlocale( LC_MESSAGES, nullptr ) << '\n'
+      << "root " << config.root_dir << '\n'
+      << "recommends " << config.solver_installRecommends << '\n';
+  for ( const RepoInfo & repo : _zypper.runtimeData().repos )
+    str << "repo " << repo.alias() << ' ' << repo.priority() << '\n';
+  str << fingerprint;
+  return Digest::digest( Digest::sha256(), str );
+}
+
+bool ResultCache::replay()
+{
+  if ( _key.empty() )
+    return false;
+
+  std::ifstream in( _file.c_str() );
+  std::string line;
+  if ( ! in || ! std::getline( in, line ) || line != magic )
+    return false;
+  if ( ! std::getline( in, line ) || line != _key )
+  {
+    DBG << _file << ": outdated" << endl;
+    return false;
+  }
+  int exitCode = ZYPPER_EXIT_OK;
+  if ( ! std::getline( in, line ) || ! str::strtonum( line, exitCode ) )
+    return false;
+
+  std::ostringstream output;
+  if ( in.peek() != std::ifstream::traits_type::eof() && ! ( output << in.rdbuf() ) )
+    return false;
+
+  MIL << "Replaying the result of '" << _name << "' from " << _file << endl;
+  std::cout << output.str() << std::flush;
+  _zypper.setExitCode( exitCode );
+  return true;
+}
+
+void ResultCache::record( const std::function<void()> & command_r )
+{
+  if ( _key.empty() )
+  {
+    command_r();
+    return;
+  }
+
+  TeeBuf tee( std::cout.rdbuf() );
+  std::streambuf * orig = std::cout.rdbuf( &tee );
+  try
+  {
+    command_r();
+  }
+  catch ( ... )
+  {
+    std::cout.rdbuf( orig );
+    throw;
+  }
+  std::cout.flush();
+  std::cout.rdbuf( orig );
+
+  if ( ! cacheable( _zypper.exitCode() ) )
+    return;
+  // e.g. a solv file was rebuilt while loading the repos
+  if ( computeKey() != _key )
+  {
+    MIL << "The input of '" << _name << "' changed meanwhile. Not caching the result." << endl;
+    return;
+  }
+  save( tee.copy(), _zypper.exitCode() );
+}
+
+void ResultCache::save( const std::string & output_r, int exitCode_r ) const
+{
+  writeFileAtomic( _file, [&]( std::ostream & out ) {
+    out << magic << '\n' << _key << '\n' << exitCode_r << '\n' << output_r;
+  } );
+}
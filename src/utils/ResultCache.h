@@ -0,0 +1,70 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_RESULTCACHE_H
+#define ZYPPER_UTILS_RESULTCACHE_H
+
+#include <functional>
+#include <string>
+
+#include <zypp/Pathname.h>
+
+class Zypper;
+
+///////////////////////////////////////////////////////////////////
+/// \class ResultCache
+/// \brief The output and exit code of a query command, for as long as
+/// its input is unchanged.
+///
+/// Commands like 'list-updates' or 'patch-check' are run periodically
+/// by monitoring tools, mostly on an unchanged system. The cache is keyed
+/// by a hash of everything the result depends on: the on-disk state the
+/// pool is built from (\ref PoolState::fingerprint of the repos to load),
+/// the command and its arguments, and the output settings (type,
+/// verbosity, colors, screen width, language). On a hit the recorded
+/// output is replayed without loading the pool at all.
+///
+/// The key is computed after the repos were refreshed (InitRepos) and
+/// again after the command ran. Results are recorded only if both match
+/// and the command succeeded (exit code \c 0 or informational \c 1xx).
+///
+/// The cache is kept per command in the zypp cache directory (root) or
+/// in $XDG_CACHE_HOME/zypper (other users), one entry per command.
+/// zypper.conf: main.cacheQueryResults.
+///////////////////////////////////////////////////////////////////
+class ResultCache
+{
+public:
+  /** Ctor for command \a name_r called with \a args_r (anything affecting its result). */
+  ResultCache( Zypper & zypper_r, std::string name_r, std::string args_r );
+
+  /** Whether the result can be cached at all. */
+  explicit operator bool() const
+  { return ! _key.empty(); }
+
+  /** If a result for the current key was recorded, write its output and set the exit code.
+   * \return whether the result was replayed.
+   */
+  bool replay();
+
+  /** Run \a command_r recording everything written to stdout, and
+   * save the result if it is cacheable.
+   */
+  void record( const std::function<void()> & command_r );
+
+private:
+  std::string computeKey() const;
+  void save( const std::string & output_r, int exitCode_r ) const;
+
+private:
+  Zypper & _zypper;
+  std::string _name;
+  std::string _args;
+  zypp::Pathname _file;
+  std::string _key;
+};
+
+#endif // ZYPPER_UTILS_RESULTCACHE_H
@@ -0,0 +1,423 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <unordered_map>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/Easy.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/RepoInfo.h>
+#include <zypp/sat/SolvAttr.h>
+
+#include "Zypper.h"
+#include "utils/AtomicFile.h"
+#include "SearchIndex.h"
+
+using namespace zypp;
+
+///////////////////////////////////////////////////////////////////
+//
+// Index file layout (native byte order, it's a local cache):
+//
+//   Header
+//   Entry[Header::_entries[Name]]	sorted by trigram
+//   Entry[Header::_entries[Text]]	sorted by trigram
+//   postings				per Entry: ascending solvable
+//					positions, delta and varint encoded
+//
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  const char * const indexFileName = "zypper-search.idx";
+  const char indexMagic[8] = { 'Z', 'Y', 'P', 'P', 'S', 'I', 'X', '\0' };
+  constexpr uint32_t indexVersion = 1;
+
+  enum Table { Name = 0, Text = 1 };
+
+  struct Header
+  {
+    char _magic[8];
+    uint32_t _version;
+    uint32_t _solvables;	///< number of solvables in the repo
+    uint64_t _solvSize;
+    int64_t  _solvMtime;
+    char _cookie[40];		///< sha1 of the solv cookie file
+    uint32_t _entries[2];	///< number of trigram entries per Table
+  };
+
+  struct Entry
+  {
+    uint32_t _trigram;
+    uint32_t _count;		///< number of solvables
+    uint64_t _offset;		///< of the postings in the file
+    uint64_t _size;		///< of the postings in bytes
+  };
+
+  using Postings = std::unordered_map<uint32_t,std::vector<uint32_t>>;
+
+  /** The solv cache directory of \a repo_r. */
+  inline Pathname solvDir( const Repository & repo_r )
+  { return Zypper::instance().config().rm_options.repoSolvCachePath / repo_r.info().escaped_alias(); }
+
+  /** Lowercase ASCII only (UTF-8 sequences remain unchanged). */
+  inline std::string asciiLower( std::string str_r )
+  {
+    for ( char & ch : str_r )
+    {
+      if ( 'A' <= ch && ch <= 'Z' )
+        ch += 'a' - 'A';
+    }
+    return str_r;
+  }
+
+  inline uint32_t trigram( const char * p_r )
+  { return ( uint32_t((unsigned char)p_r[0]) << 16 ) | ( uint32_t((unsigned char)p_r[1]) << 8 ) | uint32_t((unsigned char)p_r[2]); }
+
+  /** Remember the trigrams of (lowercased) \a str_r for solvable \a pos_r. */
+  void addTrigrams( Postings & postings_r, const std::string & str_r, uint32_t pos_r )
+  {
+    for ( std::string::size_type i = 0; i + 3 <= str_r.size(); ++i )
+    {
+      std::vector<uint32_t> & list( postings_r[trigram( str_r.data() + i )] );
+      if ( list.empty() || list.back() != pos_r )
+        list.push_back( pos_r );
+    }
+  }
+
+  /** The distinct trigrams of (lowercased) \a str_r. */
+  std::vector<uint32_t> trigramsOf( const std::string & str_r )
+  {
+    std::vector<uint32_t> ret;
+    for ( std::string::size_type i = 0; i + 3 <= str_r.size(); ++i )
+      ret.push_back( trigram( str_r.data() + i ) );
+    std::sort( ret.begin(), ret.end() );
+    ret.erase( std::unique( ret.begin(), ret.end() ), ret.end() );
+    return ret;
+  }
+
+  void appendVarint( std::string & buf_r, uint32_t val_r )
+  {
+    while ( val_r >= 0x80 )
+    {
+      buf_r += char( ( val_r & 0x7f ) | 0x80 );
+      val_r >>= 7;
+    }
+    buf_r += char( val_r );
+  }
+
+  /** The solv cookie checksum. Empty if there is no cookie. */
+  inline std::string cookieChecksum( const Pathname & solvDir_r )
+  {
+    Pathname cookie( solvDir_r / "cookie" );
+    return PathInfo( cookie ).isFile() ? filesystem::sha1sum( cookie ) : std::string();
+  }
+} // namespace
+
+///////////////////////////////////////////////////////////////////
+/// SearchIndex::Impl: the mmapped index file
+///////////////////////////////////////////////////////////////////
+struct SearchIndex::Impl
+{
+  Impl( Repository repo_r )
+  : _repo( repo_r )
+  {
+    Pathname dir( solvDir( repo_r ) );
+    Pathname file( dir / indexFileName );
+
+    int fd = ::open( file.c_str(), O_RDONLY|O_CLOEXEC );
+    if ( fd == -1 )
+      return;
+    off_t size = ::lseek( fd, 0, SEEK_END );
+    if ( size >= off_t(sizeof(Header)) )
+    {
+      void * addr = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if ( addr != MAP_FAILED )
+      {
+        _data = static_cast<const char *>( addr );
+        _size = size;
+      }
+    }
+    ::close( fd );
+    if ( ! _data )
+      return;
+
+    const Header & header( *reinterpret_cast<const Header *>( _data ) );
+    PathInfo solv( dir / "solv" );
+    if ( ::memcmp( header._magic, indexMagic, sizeof(indexMagic) ) != 0
+         || header._version != indexVersion
+         || header._solvables != repo_r.solvablesSize()
+         || ! solv.isFile()
+         || header._solvSize != uint64_t(solv.size())
+         || header._solvMtime != int64_t(solv.mtime())
+         || std::string( header._cookie, sizeof(header._cookie) ) != cookieChecksum( dir )
+         || _size < sizeof(Header) + ( uint64_t(header._entries[Name]) + header._entries[Text] ) * sizeof(Entry) )
+    {
+      DBG << "Search index of " << repo_r.alias() << " is outdated." << endl;
+      return;
+    }
+
+    _entries[Name] = reinterpret_cast<const Entry *>( _data + sizeof(Header) );
+    _entries[Text] = _entries[Name] + header._entries[Name];
+    _entriesSize[Name] = header._entries[Name];
+    _entriesSize[Text] = header._entries[Text];
+
+    // The postings follow the entries without gaps and end at the end of
+    // the file. Anything else is a truncated or corrupt file.
+    uint64_t offset = sizeof(Header) + ( uint64_t(_entriesSize[Name]) + _entriesSize[Text] ) * sizeof(Entry);
+    for ( Table table : { Name, Text } )
+    {
+      for ( uint32_t i = 0; i < _entriesSize[table]; ++i )
+      {
+        const Entry & entry { _entries[table][i] };
+        if ( entry._offset != offset || entry._size > _size - offset || ( i && entry._trigram <= _entries[table][i-1]._trigram ) )
+        {
+          WAR << "Search index of " << repo_r.alias() << " is corrupt." << endl;
+          return;
+        }
+        offset += entry._size;
+      }
+    }
+    if ( offset != _size )
+    {
+      WAR << "Search index of " << repo_r.alias() << " is corrupt." << endl;
+      return;
+    }
+    _valid = true;
+  }
+
+  ~Impl()
+  {
+    if ( _data )
+      ::munmap( const_cast<char *>( _data ), _size );
+  }
+
+  Impl( const Impl & ) = delete;
+  Impl & operator=( const Impl & ) = delete;
+
+  /** The Entry for \a trigram_r in \a table_r or nullptr. */
+  const Entry * find( Table table_r, uint32_t trigram_r ) const
+  {
+    const Entry * begin = _entries[table_r];
+    const Entry * end = begin + _entriesSize[table_r];
+    const Entry * it = std::lower_bound( begin, end, trigram_r,
+                                         []( const Entry & lhs, uint32_t rhs ) { return lhs._trigram < rhs; } );
+    if ( it == end || it->_trigram != trigram_r || it->_offset + it->_size > _size )
+      return nullptr;
+    return it;
+  }
+
+  /** Decode the postings of \a entry_r. */
+  std::vector<uint32_t> postings( const Entry & entry_r ) const
+  {
+    std::vector<uint32_t> ret;
+    ret.reserve( entry_r._count );
+    const unsigned char * p = reinterpret_cast<const unsigned char *>( _data + entry_r._offset );
+    const unsigned char * end = p + entry_r._size;
+    uint32_t last = 0;
+    while ( p != end )
+    {
+      uint32_t val = 0;
+      unsigned shift = 0;
+      while ( p != end && ( *p & 0x80 ) )
+      {
+        val |= uint32_t( *p++ & 0x7f ) << shift;
+        shift += 7;
+      }
+      if ( p == end )
+        break;	// broken
+      val |= uint32_t( *p++ ) << shift;
+      last += val;
+      ret.push_back( last );
+    }
+    return ret;
+  }
+
+  /** Solvable positions which may contain (lowercased) \a str_r in \a table_r. */
+  std::vector<uint32_t> lookup( Table table_r, const std::string & str_r ) const
+  {
+    std::vector<const Entry *> entries;
+    for ( uint32_t tri : trigramsOf( str_r ) )
+    {
+      const Entry * entry = find( table_r, tri );
+      if ( ! entry )
+        return std::vector<uint32_t>();
+      entries.push_back( entry );
+    }
+    if ( entries.empty() )
+      return std::vector<uint32_t>();
+
+    // intersect, starting with the shortest list
+    std::sort( entries.begin(), entries.end(), []( const Entry * lhs, const Entry * rhs ) { return lhs->_count < rhs->_count; } );
+    std::vector<uint32_t> ret( postings( *entries[0] ) );
+    for ( unsigned i = 1; i < entries.size() && ! ret.empty(); ++i )
+    {
+      std::vector<uint32_t> next( postings( *entries[i] ) );
+      std::vector<uint32_t> both;
+      std::set_intersection( ret.begin(), ret.end(), next.begin(), next.end(), std::back_inserter( both ) );
+      ret.swap( both );
+    }
+    return ret;
+  }
+
+  /** The repos solvables by position. */
+  const std::vector<sat::Solvable> & solvables() const
+  {
+    if ( _solvables.empty() )
+    {
+      _solvables.reserve( _repo.solvablesSize() );
+      for_( it, _repo.solvablesBegin(), _repo.solvablesEnd() )
+        _solvables.push_back( *it );
+    }
+    return _solvables;
+  }
+
+  Repository _repo;
+  const char * _data = nullptr;
+  uint64_t _size = 0;
+  bool _valid = false;
+  const Entry * _entries[2] = { nullptr, nullptr };
+  uint32_t _entriesSize[2] = { 0, 0 };
+  mutable std::vector<sat::Solvable> _solvables;
+};
+
+///////////////////////////////////////////////////////////////////
+/// class SearchIndex
+///////////////////////////////////////////////////////////////////
+
+bool SearchIndex::enabled()
+{ return Zypper::instance().config().search_useIndex; }
+
+bool SearchIndex::update( Repository repo_r )
+{
+  if ( ! repo_r || repo_r.isSystemRepo() )
+    return false;
+  if ( SearchIndex( repo_r ) )
+    return true;
+
+  Pathname dir( solvDir( repo_r ) );
+  PathInfo solv( dir / "solv" );
+  std::string cookie( cookieChecksum( dir ) );
+  if ( ! solv.isFile() || cookie.size() != sizeof(Header::_cookie) )
+  {
+    DBG << "No solv cache for " << repo_r.alias() << ". Not building a search index." << endl;
+    return false;
+  }
+
+  MIL << "Building search index for " << repo_r.alias() << endl;
+  Postings postings[2];
+  uint32_t pos = 0;
+  for_( it, repo_r.solvablesBegin(), repo_r.solvablesEnd() )
+  {
+    addTrigrams( postings[Name], asciiLower( it->ident().asString() ), pos );
+    std::string text( it->lookupStrAttribute( sat::SolvAttr::summary ) );
+    text += '\n';
+    text += it->lookupStrAttribute( sat::SolvAttr::description );
+    addTrigrams( postings[Text], asciiLower( std::move(text) ), pos );
+    ++pos;
+  }
+
+  Header header;
+  ::memset( &header, 0, sizeof(header) );
+  ::memcpy( header._magic, indexMagic, sizeof(indexMagic) );
+  header._version = indexVersion;
+  header._solvables = pos;
+  header._solvSize = solv.size();
+  header._solvMtime = solv.mtime();
+  ::memcpy( header._cookie, cookie.data(), sizeof(header._cookie) );
+
+  std::vector<Entry> entries;
+  std::string blob;
+  for ( Table table : { Name, Text } )
+  {
+    std::vector<uint32_t> trigrams;
+    trigrams.reserve( postings[table].size() );
+    for ( const auto & el : postings[table] )
+      trigrams.push_back( el.first );
+    std::sort( trigrams.begin(), trigrams.end() );
+
+    header._entries[table] = trigrams.size();
+    for ( uint32_t tri : trigrams )
+    {
+      const std::vector<uint32_t> & list( postings[table][tri] );
+      Entry entry { tri, uint32_t(list.size()), blob.size(), 0 };	// _offset is relative to the blob here
+      uint32_t last = 0;
+      for ( uint32_t val : list )
+      {
+        appendVarint( blob, val - last );
+        last = val;
+      }
+      entry._size = blob.size() - entry._offset;
+      entries.push_back( entry );
+    }
+  }
+  uint64_t blobOffset = sizeof(Header) + entries.size() * sizeof(Entry);
+  for ( Entry & entry : entries )
+    entry._offset += blobOffset;
+
+  Pathname file( dir / indexFileName );
+  bool saved = writeFileAtomic( file, [&]( std::ostream & str ) {
+    str.write( reinterpret_cast<const char *>( &header ), sizeof(header) );
+    str.write( reinterpret_cast<const char *>( entries.data() ), entries.size() * sizeof(Entry) );
+    str.write( blob.data(), blob.size() );
+  }, std::ios::binary );
+  if ( ! saved )
+    return false;
+  MIL << "Search index for " << repo_r.alias() << ": " << pos << " solvables, " << entries.size() << " trigrams" << endl;
+  return true;
+}
+
+bool SearchIndex::matches( const sat::Solvable & solv_r, const std::string & str_r, bool text_r, bool caseSensitive_r )
+{
+  const std::string & needle( caseSensitive_r ? str_r : asciiLower( str_r ) );
+  auto contains = [&]( const std::string & haystack_r ) {
+    return ( caseSensitive_r ? haystack_r : asciiLower( haystack_r ) ).find( needle ) != std::string::npos;
+  };
+
+  if ( contains( solv_r.ident().asString() ) )
+    return true;
+  return text_r && ( contains( solv_r.lookupStrAttribute( sat::SolvAttr::summary ) )
+                     || contains( solv_r.lookupStrAttribute( sat::SolvAttr::description ) ) );
+}
+
+SearchIndex::SearchIndex( Repository repo_r )
+: _pimpl( new Impl( repo_r ) )
+{}
+
+SearchIndex::operator bool() const
+{ return _pimpl->_valid; }
+
+std::vector<sat::Solvable> SearchIndex::candidates( const std::string & str_r, bool text_r ) const
+{
+  std::vector<sat::Solvable> ret;
+  if ( ! _pimpl->_valid )
+    return ret;
+
+  std::string lstr( asciiLower( str_r ) );
+  std::vector<uint32_t> found( _pimpl->lookup( Name, lstr ) );
+  if ( text_r )
+  {
+    std::vector<uint32_t> text( _pimpl->lookup( Text, lstr ) );
+    std::vector<uint32_t> both;
+    std::set_union( found.begin(), found.end(), text.begin(), text.end(), std::back_inserter( both ) );
+    found.swap( both );
+  }
+
+  const std::vector<sat::Solvable> & solvables( _pimpl->solvables() );
+  for ( uint32_t pos : found )
+  {
+    if ( pos < solvables.size() )
+      ret.push_back( solvables[pos] );
+  }
+  return ret;
+}
@@ -0,0 +1,71 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_SEARCHINDEX_H
+#define ZYPPER_UTILS_SEARCHINDEX_H
+
+#include <string>
+#include <vector>
+
+#include <zypp/base/PtrTypes.h>
+#include <zypp/Repository.h>
+#include <zypp/sat/Solvable.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class SearchIndex
+/// \brief Trigram index of a repos solvable names, summaries and descriptions.
+///
+/// The index is stored next to the repos solv file and remains valid as
+/// long as the solv file and its cookie are unchanged. 'zypper search'
+/// uses it to find the candidates for a substring search instead of
+/// scanning all solvables of the repo.
+///
+/// Solvables are referred to by their position in the repo, which is
+/// the same whenever the same solv file is loaded. The index is built
+/// from lowercased (ASCII) strings, so the candidates are a superset of
+/// the case sensitive and insensitive matches. Use \ref matches to check
+/// them.
+///////////////////////////////////////////////////////////////////
+class SearchIndex
+{
+public:
+  /** Search strings must have at least this size to be looked up. */
+  static constexpr unsigned minStringSize = 3;
+
+  /** Whether the index is enabled in zypper.conf (search.useIndex). */
+  static bool enabled();
+
+  /** Build the index for the loaded \a repo_r unless it is up to date.
+   * Errors (e.g. no permission to write the solv cache) are just logged.
+   * \return whether an up to date index exists.
+   */
+  static bool update( zypp::Repository repo_r );
+
+  /** Whether \a solv_r matches the substring \a str_r in its name (ident)
+   * or, if \a text_r is set, in its summary or description.
+   */
+  static bool matches( const zypp::sat::Solvable & solv_r, const std::string & str_r, bool text_r, bool caseSensitive_r );
+
+public:
+  /** Open the index of the loaded \a repo_r. */
+  SearchIndex( zypp::Repository repo_r );
+
+  /** Whether the index is up to date and can be used. */
+  explicit operator bool() const;
+
+  /** The solvables which may contain \a str_r in their name or, if \a text_r
+   * is set, in their summary or description.
+   * \a str_r must have at least \ref minStringSize bytes.
+   */
+  std::vector<zypp::sat::Solvable> candidates( const std::string & str_r, bool text_r ) const;
+
+public:
+  struct Impl;
+private:
+  zypp::RW_pointer<Impl> _pimpl;
+};
+
+#endif // ZYPPER_UTILS_SEARCHINDEX_H
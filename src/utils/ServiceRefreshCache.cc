@@ -0,0 +1,106 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/Digest.h>
+#include <zypp/PathInfo.h>
+
+#include "AtomicFile.h"
+#include "ServiceRefreshCache.h"
+
+using namespace zypp;
+
+namespace
+{
+  const std::string magic { "zypper-service-refresh-cache 1" };
+}
+
+ServiceRefreshCache::ServiceRefreshCache( Pathname file_r )
+: _file( std::move(file_r) )
+{
+  std::ifstream in( _file.c_str() );
+  if ( ! in )
+    return;
+
+  std::string line;
+  if ( ! std::getline( in, line ) || line != magic )
+  {
+    MIL << "Ignore unknown service refresh cache " << _file << endl;
+    return;
+  }
+  while ( std::getline( in, line ) )
+  {
+    // alias TAB refreshed TAB hash
+    std::vector<std::string> words;
+    if ( str::split( line, std::back_inserter(words), "\t" ) != 3 )
+    {
+      WAR << "Ignore broken service refresh cache " << _file << endl;
+      _entries.clear();
+      return;
+    }
+    _entries[words[0]] = Entry { Date( str::strtonum<Date::ValueType>( words[1] ) ), words[2] };
+  }
+  DBG << _file << ": " << _entries.size() << " services" << endl;
+}
+
+std::string ServiceRefreshCache::definitionHash( const ServiceInfo & service_r )
+{
+  std::stringstream str;
+  service_r.dumpAsIniOn( str );
+  return Digest::digest( Digest::sha256(), str );
+}
+
+bool ServiceRefreshCache::isFresh( const ServiceInfo & service_r, Date::Duration ttl_r, Date now_r ) const
+{
+  if ( ttl_r <= 0 )
+    return false;
+
+  auto it = _entries.find( service_r.alias() );
+  if ( it == _entries.end() )
+    return false;
+
+  const Entry & entry { it->second };
+  if ( entry._refreshed > now_r || now_r - entry._refreshed >= ttl_r )
+    return false;	// expired (or the clock went back)
+
+  if ( entry._hash != definitionHash( service_r ) )
+  {
+    MIL << "Service '" << service_r.alias() << "' was changed since its last refresh" << endl;
+    return false;
+  }
+  return true;
+}
+
+void ServiceRefreshCache::refreshed( const ServiceInfo & service_r, Date now_r )
+{
+  _entries[service_r.alias()] = Entry { now_r, definitionHash( service_r ) };
+  _dirty = true;
+}
+
+void ServiceRefreshCache::forget( const std::string & alias_r )
+{
+  if ( _entries.erase( alias_r ) )
+    _dirty = true;
+}
+
+void ServiceRefreshCache::save()
+{
+  if ( ! _dirty || _file.empty() )
+    return;
+  _dirty = false;
+
+  writeFileAtomic( _file, [this]( std::ostream & out ) {
+    out << magic << '\n';
+    for ( const auto & p : _entries )
+      out << p.first << '\t' << Date::ValueType(p.second._refreshed) << '\t' << p.second._hash << '\n';
+  } );
+}
@@ -0,0 +1,71 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_SERVICEREFRESHCACHE_H
+#define ZYPPER_UTILS_SERVICEREFRESHCACHE_H
+
+#include <map>
+#include <string>
+
+#include <zypp/Date.h>
+#include <zypp/Pathname.h>
+#include <zypp/ServiceInfo.h>
+
+///////////////////////////////////////////////////////////////////
+/// \class ServiceRefreshCache
+/// \brief When the autorefresh services were last refreshed.
+///
+/// Root commands refresh all autorefresh services before loading the
+/// repos, which costs a network round trip per service. The cache
+/// remembers for each service the time of its last successful refresh
+/// and a hash of its definition (as written to the .service file) right
+/// after it. A service is not refreshed again until the TTL expired,
+/// unless its definition changed meanwhile (e.g. a new URL or credentials,
+/// repos to enable, or a refresh by another tool).
+///
+/// A TTL the service itself requests (\c ttl in repoindex.xml) is still
+/// honored by libzypp.
+///
+/// The cache is kept as hidden file in the services directory.
+///////////////////////////////////////////////////////////////////
+class ServiceRefreshCache
+{
+public:
+  /** Ctor reading \a file_r (if it exists). */
+  ServiceRefreshCache( zypp::Pathname file_r );
+
+  /** The cache file used for \a servicesDir_r. */
+  static zypp::Pathname defaultFile( const zypp::Pathname & servicesDir_r )
+  { return servicesDir_r / ".zypper-refresh.cache"; }
+
+  /** Whether \a service_r was refreshed less than \a ttl_r ago and is unchanged since. */
+  bool isFresh( const zypp::ServiceInfo & service_r, zypp::Date::Duration ttl_r, zypp::Date now_r = zypp::Date::now() ) const;
+
+  /** Remember \a service_r (as read after the refresh) was refreshed at \a now_r. */
+  void refreshed( const zypp::ServiceInfo & service_r, zypp::Date now_r = zypp::Date::now() );
+
+  /** Forget about \a alias_r. */
+  void forget( const std::string & alias_r );
+
+  /** Write the cache (see \ref writeFileAtomic) if it was changed. */
+  void save();
+
+  /** The hash of the definition of \a service_r. */
+  static std::string definitionHash( const zypp::ServiceInfo & service_r );
+
+private:
+  struct Entry
+  {
+    zypp::Date _refreshed;
+    std::string _hash;
+  };
+
+  zypp::Pathname _file;
+  std::map<std::string,Entry> _entries;	///< by alias
+  bool _dirty = false;
+};
+
+#endif // ZYPPER_UTILS_SERVICEREFRESHCACHE_H
@@ -0,0 +1,296 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/Repository.h>
+
+#include "main.h"
+#include "utils/misc.h"
+#include "utils/text.h"
+#include "utils/console.h"
+#include "utils/colors.h"
+#include "SolvableTable.h"
+
+using namespace zypp;
+
+namespace
+{
+  /** The vertical, horizontal and crossing line of the ztui Table styles (by TableLineStyle). */
+  const char * const lineChars[][3] = {
+    { "|", "-", "+" },					// Ascii
+    { "\xE2\x94\x82", "\xE2\x94\x80", "\xE2\x94\xBC" },	// Light
+    { "\xE2\x94\x83", "\xE2\x94\x81", "\xE2\x95\x8B" },	// Heavy
+    { "\xE2\x95\x91", "\xE2\x95\x90", "\xE2\x95\xAC" },	// Double
+    { "\xE2\x94\x86", "\xE2\x94\x84", "\xE2\x94\xBC" },	// Light3
+    { "\xE2\x94\x87", "\xE2\x94\x85", "\xE2\x94\x8B" },	// Heavy3
+    { "\xE2\x94\x82", "\xE2\x94\x81", "\xE2\x94\xBF" },	// LightHeavy
+    { "\xE2\x94\x82", "\xE2\x95\x90", "\xE2\x95\xAA" },	// LightDouble
+    { "\xE2\x94\x83", "\xE2\x94\x80", "\xE2\x95\x82" },	// HeavyLight
+    { "\xE2\x95\x91", "\xE2\x94\x80", "\xE2\x95\xAB" },	// DoubleLight
+    { ":", "-", "+" },					// Colon
+    { " ", " ", " " },					// none
+  };
+
+  /** Write \a cell_r padded to \a width_r columns (or cut with '->' if it's wider). */
+  void writeCell( std::ostream & str_r, const std::string & cell_r, unsigned width_r, bool pad_r )
+  {
+    unsigned width { mbs_width( cell_r ) };
+    if ( width > width_r && width_r > 2 )
+    {
+      str_r << mbs_substr_by_width( cell_r, 0, width_r - 2 ) << ( ColorContext::LOWLIGHT << "->" );
+      return;
+    }
+    str_r << cell_r;
+    if ( pad_r && width < width_r )
+      str_r << std::string( width_r - width, ' ' );
+  }
+}
+
+SolvableTable::SolvableTable( Columns columns_r, std::string systemRepoLabel_r )
+{ setColumns( std::move(columns_r), std::move(systemRepoLabel_r) ); }
+
+void SolvableTable::setColumns( Columns columns_r, std::string systemRepoLabel_r )
+{
+  _columns = std::move(columns_r);
+  _systemRepoLabel = std::move(systemRepoLabel_r);
+  _repoLabels.clear();
+}
+
+void SolvableTable::add( const sat::Solvable & solv_r, const char * status_r, picklist_size_type picklistPos_r )
+{
+  _solv.push_back( solv_r );
+  _status.push_back( status_r ? status_r : "" );
+  _picklistPos.push_back( picklistPos_r );
+}
+
+void SolvableTable::addDetail( std::string detail_r )
+{
+  if ( ! empty() )
+    _details[size()-1].push_back( std::move(detail_r) );
+}
+
+void SolvableTable::clear()
+{
+  _solv.clear();
+  _status.clear();
+  _picklistPos.clear();
+  _details.clear();
+}
+
+const std::string & SolvableTable::repoLabel( const sat::Solvable & solv_r ) const
+{
+  zypp::Repository repo { solv_r.repository() };
+  auto it = _repoLabels.find( repo.id() );
+  if ( it == _repoLabels.end() )
+  {
+    std::string label { repo.isSystemRepo() && ! _systemRepoLabel.empty() ? _systemRepoLabel : repo.asUserString() };
+    it = _repoLabels.insert( { repo.id(), std::move(label) } ).first;
+  }
+  return it->second;
+}
+
+void SolvableTable::sort( const Columns & keys_r )
+{
+  auto compare = [this]( Column key_r, size_type lhs_r, size_type rhs_r ) -> int {
+    const sat::Solvable & lhs { _solv[lhs_r] };
+    const sat::Solvable & rhs { _solv[rhs_r] };
+    switch ( key_r )
+    {
+      case Status:	return ::strcmp( _status[lhs_r], _status[rhs_r] );
+      case Name:	return str::compareCI( solvableName( lhs ), solvableName( rhs ) );
+      case Summary:	return lhs.summary().compare( rhs.summary() );
+      case Kind:	return lhs.kind().compare( rhs.kind() );
+      case Edition:	return lhs.edition().compare( rhs.edition() );
+      case Arch:	return ::strcmp( lhs.arch().c_str(), rhs.arch().c_str() );
+      case Repository:	return repoLabel( lhs ).compare( repoLabel( rhs ) );
+    }
+    return 0;
+  };
+
+  std::vector<size_type> order( size() );
+  for ( size_type idx = 0; idx < order.size(); ++idx )
+    order[idx] = idx;
+
+  std::stable_sort( order.begin(), order.end(), [&]( size_type lhs, size_type rhs ) {
+    for ( Column key : keys_r )
+    {
+      if ( int diff = compare( key, lhs, rhs ) )
+        return diff < 0;
+    }
+    return _picklistPos[lhs] < _picklistPos[rhs];
+  } );
+
+  // apply the order to all columns
+  std::vector<sat::Solvable> solv;
+  std::vector<const char *> status;
+  std::vector<picklist_size_type> picklistPos;
+  std::unordered_map<size_type,std::vector<std::string>> details;
+  solv.reserve( order.size() );
+  status.reserve( order.size() );
+  picklistPos.reserve( order.size() );
+  for ( size_type idx : order )
+  {
+    solv.push_back( _solv[idx] );
+    status.push_back( _status[idx] );
+    picklistPos.push_back( _picklistPos[idx] );
+    auto it = _details.find( idx );
+    if ( it != _details.end() )
+      details[solv.size()-1] = std::move( it->second );
+  }
+  _solv.swap( solv );
+  _status.swap( status );
+  _picklistPos.swap( picklistPos );
+  _details.swap( details );
+}
+
+TableHeader SolvableTable::header() const
+{
+  TableHeader th;
+  for ( Column column : _columns )
+  {
+    switch ( column )
+    {
+      // translators: S for 'installed Status'
+      case Status:	th << N_("S");	break;
+      // translators: name (general header)
+      case Name:	th << table::Column( N_("Name"), table::CStyle::SortCi );	break;
+      // translators: package summary (header)
+      case Summary:	th << N_("Summary");	break;
+      // translators: type (general header)
+      case Kind:	th << N_("Type");	break;
+      // translators: package version (header)
+      case Edition:	th << table::Column( N_("Version"), table::CStyle::Edition );	break;
+      // translators: package architecture (header)
+      case Arch:	th << N_("Arch");	break;
+      // translators: package's repository (header)
+      case Repository:	th << N_("Repository");	break;
+    }
+  }
+  return th;
+}
+
+std::string SolvableTable::cell( Column column_r, size_type idx_r ) const
+{
+  const sat::Solvable & solv { _solv[idx_r] };
+  switch ( column_r )
+  {
+    case Status:	return _status[idx_r];
+    case Name:		return solv.name();
+    case Summary:	return solv.summary();
+    case Kind:		return kind_to_string_localized( solv.kind(), 1 );
+    case Edition:	return solv.edition().asString();
+    case Arch:		return solv.arch().asString();
+    case Repository:	return repoLabel( solv );
+  }
+  return std::string();
+}
+
+TableRow SolvableTable::row( size_type idx_r ) const
+{
+  TableRow row( _columns.size() );
+  for ( Column column : _columns )
+    row << cell( column, idx_r );
+
+  if ( _picklistPos[idx_r] != ui::Selectable::picklistNoPos )
+    row.userData( SolvableCSI( _solv[idx_r], _picklistPos[idx_r] ) );
+
+  auto it = _details.find( idx_r );
+  if ( it != _details.end() )
+  {
+    for ( const std::string & detail : it->second )
+      row.addDetail( detail );
+  }
+  return row;
+}
+
+void SolvableTable::fill( Table & table_r ) const
+{
+  table_r << header();
+  for ( size_type idx = 0; idx < size(); ++idx )
+    table_r << row( idx );
+  DBG << "Wrote " << size() << " rows" << endl;
+}
+
+void SolvableTable::dumpTo( std::ostream & str_r, unsigned abbrevColumn_r ) const
+{
+  if ( empty() )
+    return;
+
+  TableLineStyle style { Table::defaultStyle < TableLineStyle::TLS_End ? Table::defaultStyle : TableLineStyle::Ascii };
+  const char * const * lines { lineChars[style] };
+  std::string separator { style == TableLineStyle::none ? "  " : std::string(" ") + lines[0] + " " };
+
+  // 1st pass: the column widths (cells are built per row and dropped)
+  const TableHeader::container & head { header().columns() };
+  std::vector<unsigned> widths( _columns.size(), 0 );
+  for ( unsigned cidx = 0; cidx < widths.size() && cidx < head.size(); ++cidx )
+    widths[cidx] = mbs_width( head[cidx] );
+  for ( size_type idx = 0; idx < size(); ++idx )
+  {
+    for ( unsigned cidx = 0; cidx < widths.size(); ++cidx )
+      widths[cidx] = std::max( widths[cidx], unsigned(mbs_width( cell( _columns[cidx], idx ) )) );
+  }
+
+  // shorten the abbrev column if the table does not fit on the screen
+  if ( abbrevColumn_r < widths.size() )
+  {
+    unsigned total { unsigned( ( widths.size() - 1 ) * mbs_width( separator ) ) };
+    for ( unsigned width : widths )
+      total += width;
+    unsigned screen { get_screen_width() };
+    if ( total > screen )
+    {
+      unsigned & width { widths[abbrevColumn_r] };
+      static constexpr unsigned minWidth = 5;
+      unsigned excess { total - screen };
+      width = ( width > minWidth + excess ? width - excess : std::min( width, minWidth ) );
+    }
+  }
+
+  // 2nd pass: write header, rule and rows
+  auto writeRow = [&]( const std::vector<std::string> & cells_r ) {
+    for ( unsigned cidx = 0; cidx < widths.size(); ++cidx )
+    {
+      if ( cidx )
+        str_r << separator;
+      writeCell( str_r, cidx < cells_r.size() ? cells_r[cidx] : std::string(), widths[cidx], cidx + 1 < widths.size() );
+    }
+    str_r << '\n';
+  };
+
+  writeRow( head );
+  for ( unsigned cidx = 0; cidx < widths.size(); ++cidx )
+  {
+    if ( cidx )
+      str_r << lines[1] << lines[2] << lines[1];
+    for ( unsigned i = 0; i < widths[cidx]; ++i )
+      str_r << lines[1];
+  }
+  str_r << '\n';
+
+  std::vector<std::string> cells;
+  for ( size_type idx = 0; idx < size(); ++idx )
+  {
+    cells.clear();
+    for ( Column column : _columns )
+      cells.push_back( cell( column, idx ) );
+    writeRow( cells );
+
+    auto it = _details.find( idx );
+    if ( it != _details.end() )
+    {
+      for ( const std::string & detail : it->second )
+        str_r << "    " << detail << '\n';
+    }
+  }
+  str_r << std::flush;
+  DBG << "Wrote " << size() << " rows" << endl;
+}
@@ -0,0 +1,121 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+#ifndef ZYPPER_UTILS_SOLVABLETABLE_H
+#define ZYPPER_UTILS_SOLVABLETABLE_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <zypp/sat/Solvable.h>
+#include <zypp/ui/Selectable.h>
+
+#include "Table.h"
+
+///////////////////////////////////////////////////////////////////
+/// \class SolvableTable
+/// \brief Compact table of solvables for huge listings (packages, search).
+///
+/// A \ref Table row stores each cell as a string. For a listing of all
+/// packages these are millions of small allocations, and sorting compares
+/// (and parses editions from) these strings. A SolvableTable stores
+/// per row just the solvable, a pointer to the static status indicator
+/// and the picklist position, column by column. The cells are computed
+/// from the solvable (name, edition, arch, repo, ...) when the rows are
+/// sorted or written. \ref dumpTo writes the rows aligned like a \ref Table,
+/// building the cells of one row at a time.
+///
+/// \code
+///   SolvableTable st( { SolvableTable::Status, SolvableTable::Name, SolvableTable::Edition } );
+///   st.add( pi.satSolvable(), computeStatusIndicator( pi ) );
+///   st.sort( { SolvableTable::Name } );
+///   st.dumpTo( cout );
+/// \endcode
+///////////////////////////////////////////////////////////////////
+class SolvableTable
+{
+public:
+  enum Column
+  {
+    Status,	///< the status indicator passed to \ref add
+    Name,
+    Summary,
+    Kind,	///< localized
+    Edition,
+    Arch,
+    Repository	///< user string, \ref systemRepoLabel for the system repo
+  };
+  using Columns = std::vector<Column>;
+  using size_type = std::vector<zypp::sat::Solvable>::size_type;
+  using picklist_size_type = zypp::ui::Selectable::picklist_size_type;
+
+public:
+  /** Ctor taking the \a columns_r to show (see \ref setColumns). */
+  SolvableTable( Columns columns_r = Columns(), std::string systemRepoLabel_r = std::string() );
+
+  /** Set the \a columns_r to show.
+   * If not empty, \a systemRepoLabel_r is shown for the system repo instead
+   * of its user string.
+   */
+  void setColumns( Columns columns_r, std::string systemRepoLabel_r = std::string() );
+
+  /** Add a row.
+   * If a \a picklistPos_r is passed, it's used as secondary sort key and the
+   * written \ref TableRow gets a \ref SolvableCSI as userData.
+   */
+  void add( const zypp::sat::Solvable & solv_r, const char * status_r, picklist_size_type picklistPos_r = zypp::ui::Selectable::picklistNoPos );
+
+  /** Add a detail line to the last row. */
+  void addDetail( std::string detail_r );
+
+  bool empty() const
+  { return _solv.empty(); }
+
+  size_type size() const
+  { return _solv.size(); }
+
+  /** Remove all rows. */
+  void clear();
+
+  /** Sort the rows by \a keys_r, then by picklist position (stable). */
+  void sort( const Columns & keys_r );
+
+public:
+  /** The table header. */
+  TableHeader header() const;
+
+  /** The \a idx_r-th row. */
+  TableRow row( size_type idx_r ) const;
+
+  /** Append header and rows to \a table_r (which should not be sorted again). */
+  void fill( Table & table_r ) const;
+
+  /** Write header and rows to \a str_r formatted like a \ref Table in the
+   * \ref Table::defaultStyle.
+   * If the table is wider than the screen, the column \a abbrevColumn_r
+   * is shortened (see \ref Table::allowAbbrev).
+   */
+  void dumpTo( std::ostream & str_r, unsigned abbrevColumn_r = unsigned(-1) ) const;
+
+private:
+  std::string cell( Column column_r, size_type idx_r ) const;
+  const std::string & repoLabel( const zypp::sat::Solvable & solv_r ) const;
+
+private:
+  Columns _columns;
+  std::string _systemRepoLabel;
+
+  std::vector<zypp::sat::Solvable> _solv;
+  std::vector<const char *> _status;
+  std::vector<picklist_size_type> _picklistPos;
+  std::unordered_map<size_type,std::vector<std::string>> _details;	///< by row
+
+  mutable std::unordered_map<zypp::sat::detail::RepoIdType,std::string> _repoLabels;	///< computed once per repo
+};
+
+#endif // ZYPPER_UTILS_SOLVABLETABLE_H
@@ -7,16 +7,19 @@
 
 #include <sstream>
 #include <iostream>
+#include <fstream>
 #include <unistd.h>          // for getcwd()
 
 #include <zypp/base/Logger.h>
 #include <zypp/base/String.h>
 #include <zypp/base/Easy.h>
 #include <zypp/base/Regex.h>
+#include <zypp/CheckSum.h>
+#include <zypp/PathInfo.h>
 #include <zypp/media/MediaManager.h>
 #include <zypp/ExternalProgram.h>
 #include <zypp/parser/ProductFileReader.h>
-#include <zypp/parser/HistoryLogReader.h>
+#include <zypp/HistoryLogData.h>
 
 #include <zypp/ZYpp.h>
 #include <zypp/Target.h>
@@ -32,6 +35,8 @@
 #include "global-settings.h"
 
 #include "utils/misc.h"
+#include "utils/AtomicFile.h"
+#include "utils/HistoryLog.h"
 #include "utils/XmlFilter.h"
 
 extern ZYpp::Ptr God;
@@ -232,6 +237,19 @@ std::string patchInteractiveFlags( const Patch & patch_r )
 
 ///////////////////////////////////////////////////////////////////
 /// class  PatchHistoryData
+///
+/// The parsed data are cached in the repo cache directory together with the
+/// history file's device, inode and the offset up to which it was parsed. As long
+/// as the history file is just appended, only the new lines are parsed.
+/// If it was rotated (or truncated) it is parsed from the beginning.
+///
+/// Cache file format:
+/// \code
+///   zypper-patch-history 2 <device> <inode> <offset> <fingerprint length> <fingerprint>
+///   <ident>|<edition>|<arch>|<date>|<state>
+///   ...
+/// \endcode
+/// The fingerprint is the sha1 of the file's first <fingerprint length> bytes.
 struct PatchHistoryData::D
 {
   void remember( HistoryLogPatchStateChange::Ptr ptr_r )
@@ -239,11 +257,8 @@ struct PatchHistoryData::D
     if ( ! ptr_r )
       return;
 
-    value_type & value { _data[IdString("patch:"+ptr_r->name()).id()][ptr_r->edition().id()][ptr_r->arch().id()] };
-    if ( Date date { ptr_r->date() }; date > value.first ) {
-      value.first = std::move(date);
-      value.second = ResStatus::stringToValidateValue( ptr_r->newstate() );
-    }
+    remember( IdString("patch:"+ptr_r->name()).id(), ptr_r->edition().id(), ptr_r->arch().id(),
+              value_type( ptr_r->date(), ResStatus::stringToValidateValue( ptr_r->newstate() ) ) );
   }
 
   const PatchHistoryData::value_type & get( const sat::Solvable & solv_r  ) const
@@ -258,11 +273,139 @@ struct PatchHistoryData::D
     return noData;
   }
 
+  bool empty() const
+  { return _data.empty(); }
+
+  /** Load the cache and parse what was appended to \a historyFile_r since. */
+  void update( const Pathname & historyFile_r, const Pathname & cacheFile_r )
+  {
+    PathInfo hpi( historyFile_r );
+    if ( ! hpi.isFile() )
+      return;
+
+    off_t offset = loadCache( cacheFile_r, hpi );
+    off_t parsed = parseFrom( historyFile_r, offset );
+    if ( parsed != offset )
+      saveCache( cacheFile_r, hpi, parsed );
+  }
+
 private:
   using IdType = IdString::IdType;
   template <class Tv>
   using MapType = std::unordered_map<IdType,Tv>;
 
+  static constexpr const char * cacheMagic = "zypper-patch-history";
+  static constexpr unsigned cacheVersion = 2;	// 1 missed the padded patch action IDs
+  static constexpr off_t maxFingerprintSize = 4096;
+
+  void remember( IdType ident_r, IdType edition_r, IdType arch_r, value_type value_r )
+  {
+    value_type & value { _data[ident_r][edition_r][arch_r] };
+    if ( value_r.first > value.first )
+      value = std::move(value_r);
+  }
+
+  /** sha1 of the first \a size_r bytes of \a file_r (empty if it is shorter). */
+  static std::string fingerprint( const Pathname & file_r, off_t size_r )
+  {
+    std::string buf( size_r, '\0' );
+    std::ifstream str( file_r.c_str() );
+    if ( ! str.read( &buf[0], size_r ) )
+      return std::string();
+    return CheckSum::sha1FromString( buf ).checksum();
+  }
+
+  /** Load the cache if it belongs to the history file \a hpi_r.
+   * \return the offset up to which the history file is already parsed (0 if no usable cache).
+   */
+  off_t loadCache( const Pathname & cacheFile_r, const PathInfo & hpi_r )
+  {
+    std::ifstream str( cacheFile_r.c_str() );
+    if ( ! str )
+      return 0;
+
+    std::string magic;
+    unsigned version = 0;
+    dev_t dev = 0;
+    ino_t ino = 0;
+    off_t offset = 0;
+    off_t fplen = 0;
+    std::string fp;
+    str >> magic >> version >> dev >> ino >> offset >> fplen >> fp;
+    if ( ! str || magic != cacheMagic || version != cacheVersion )
+    {
+      MIL << "Ignore unknown history cache " << cacheFile_r << endl;
+      return 0;
+    }
+    if ( dev != hpi_r.dev() || ino != hpi_r.ino() || offset > hpi_r.size() || fingerprint( hpi_r.path(), fplen ) != fp )
+    {
+      MIL << "History file was rotated. Ignore history cache " << cacheFile_r << endl;
+      return 0;
+    }
+
+    std::string line;
+    std::getline( str, line );	// rest of the header
+    while ( std::getline( str, line ) )
+    {
+      std::vector<std::string> words;
+      if ( str::split( line, std::back_inserter(words), "|" ) != 5 )
+      {
+        WAR << "Ignore broken history cache " << cacheFile_r << endl;
+        _data.clear();
+        return 0;
+      }
+      remember( IdString(words[0]).id(), IdString(words[1]).id(), IdString(words[2]).id(),
+                value_type( Date( str::strtonum<Date::ValueType>( words[3] ) ),
+                            ResStatus::ValidateValue( str::strtonum<int>( words[4] ) ) ) );
+    }
+    DBG << "History cache " << cacheFile_r << " valid up to offset " << offset << endl;
+    return offset;
+  }
+
+  /** Parse the history file starting at \a offset_r.
+   * Only complete lines are parsed, a partially written last line is left
+   * for the next time. Just the patch state changes are parsed at all.
+   * \return the offset up to which the history file is parsed.
+   */
+  off_t parseFrom( const Pathname & historyFile_r, off_t offset_r )
+  {
+    HistoryLog log( historyFile_r );
+    if ( ! log || offset_r > log.end() )
+    {
+      WAR << "Can't read " << historyFile_r << " from offset " << offset_r << endl;
+      return offset_r;
+    }
+
+    HistoryLog::Filter filter;
+    filter._offset = offset_r;
+    filter._actions.push_back( HistoryActionID::PATCH_STATE_CHANGE.asString() );	// matches the padded "patch  "
+    log.forEach( filter, [this]( const HistoryLog::Line & line_r ) {
+      HistoryLogData::Ptr data { line_r.data() };
+      if ( data && data->action() == HistoryActionID::PATCH_STATE_CHANGE )
+        remember( dynamic_pointer_cast<HistoryLogPatchStateChange>( data ) );
+      return true;
+    } );
+    return log.end();
+  }
+
+  /** Write the cache (if we are allowed to). */
+  void saveCache( const Pathname & cacheFile_r, const PathInfo & hpi_r, off_t offset_r ) const
+  {
+    bool saved = writeFileAtomic( cacheFile_r, [&]( std::ostream & str ) {
+      off_t fplen = std::min( offset_r, maxFingerprintSize );
+      str << cacheMagic << " " << cacheVersion << " " << hpi_r.dev() << " " << hpi_r.ino() << " " << offset_r
+          << " " << fplen << " " << fingerprint( hpi_r.path(), fplen ) << endl;
+      for ( const auto & n : _data )
+        for ( const auto & v : n.second )
+          for ( const auto & a : v.second )
+            str << IdString(n.first) << "|" << IdString(v.first) << "|" << IdString(a.first)
+                << "|" << Date::ValueType(a.second.first) << "|" << int(a.second.second) << "\n";
+    } );
+    if ( saved )
+      DBG << "History cache " << cacheFile_r << " updated up to offset " << offset_r << endl;
+  }
+
+private:
   MapType<MapType<MapType<value_type>>> _data; 	///> N V A ids to value_type
 };
 
@@ -275,19 +418,20 @@ PatchHistoryData::PatchHistoryData( bool doparse_r )
 {
   if ( doparse_r )
   {
-    const Pathname & historyFile { Pathname::assertprefix( Zypper::instance().config().root_dir, ZConfig::instance().historyLogFile() ) };
-    parser::HistoryLogReader parser( historyFile, parser::HistoryLogReader::IGNORE_INVALID_ITEMS,
-                                     [=]( HistoryLogData::Ptr ptr_r )->bool {
-                                       if ( ! this->_d )
-                                         this->_d.reset( new D );
-                                       this->_d->remember( dynamic_pointer_cast<HistoryLogPatchStateChange>(ptr_r) );
-                                       return true;
-                                     } );
-    parser.addActionFilter( HistoryActionID::PATCH_STATE_CHANGE );
-    parser.readAll();
+    const Config & config { Zypper::instance().config() };
+    const Pathname & historyFile { Pathname::assertprefix( config.root_dir, ZConfig::instance().historyLogFile() ) };
+    *this = PatchHistoryData( historyFile, config.rm_options.repoCachePath / "zypper-patch-history" );
   }
 }
 
+PatchHistoryData::PatchHistoryData( const Pathname & historyFile_r, const Pathname & cacheFile_r )
+{
+  RW_pointer<D> d { new D };
+  d->update( historyFile_r, cacheFile_r );
+  if ( ! d->empty() )
+    _d = d;
+}
+
 PatchHistoryData::operator bool() const
 { return bool(_d); }
 
@@ -894,3 +1038,19 @@ const char * computeStatusIndicator( const ui::Selectable & sel_r, bool tagForei
     return stem[1];
   return stem[0];
 }
+
+// ----------------------------------------------------------------------------
+
+namespace env
+{
+  Pathname XDG_CACHE_HOME()
+  {
+    Pathname ret;
+    const char * env = ::getenv( "XDG_CACHE_HOME" );
+    if ( env && *env )
+      ret = env;
+    else if ( ( env = ::getenv( "HOME" ) ) && *env )
+      ret = Pathname( env ) / ".cache";
+    return ret;
+  }
+} // namespace env
@@ -116,6 +116,16 @@ ResKindSet kindset_from( const std::list<std::string> & kindstrings );
 
 std::string kind_to_string_localized( const ResKind & kind, unsigned long count );
 
+/** The name PoolQuery matches (the ident without kind prefix) without building a string. */
+inline const char * solvableName( const sat::Solvable & solv_r )
+{
+  const char * ident { solv_r.ident().c_str() };
+  ResKind kind { solv_r.kind() };
+  if ( kind == ResKind::package || kind == ResKind::srcpackage )
+    return ident;
+  return ident + kind.size() + 1;
+}
+
 
 // ----------------------------------------------------------------------------
 // PATCH related strings for various purposes
@@ -140,6 +150,9 @@ public:
   /** Ctor parsing the history file. */
   PatchHistoryData() : PatchHistoryData( true ) {}
 
+  /** Ctor parsing \a historyFile_r, using and updating the cache \a cacheFile_r. */
+  PatchHistoryData( const Pathname & historyFile_r, const Pathname & cacheFile_r );
+
   /** Return an empty instance without data. */
   static PatchHistoryData placeholder();
 
@@ -252,4 +265,10 @@ bool packagekit_running();
 /** Send suggestion to quit to PackageKit via DBus */
 void packagekit_suggest_quit();
 
+namespace env
+{
+  /** XDG_CACHE_HOME or $HOME/.cache; empty if neither is set. */
+  Pathname XDG_CACHE_HOME();
+}
+
 #endif /*ZYPPER_UTILS_H*/
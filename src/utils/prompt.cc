@@ -108,7 +108,7 @@ int read_action_ari_with_timeout( PromptId pid, unsigned timeout, int default_ac
                                       "Autoselecting '%s' after %u seconds.",
                                       timeout)) % poptions.options()[default_action] % timeout;
 
-    if ( zypper.out().type() == Out::TYPE_XML )
+    if ( ! zypper.out().typeNORMAL() )
       zypper.out().info( msg );	// maybe progress??
     else
     {
@@ -120,7 +120,7 @@ int read_action_ari_with_timeout( PromptId pid, unsigned timeout, int default_ac
     --timeout;
   }
 
-  if ( zypper.out().type() != Out::TYPE_XML )
+  if ( zypper.out().typeNORMAL() )
     cout << ansi::tty::clearLN << _("Trying again...") << endl;
 
   return default_action;
@@ -0,0 +1,74 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include "TestSetup.h"
+#include "commands/locks/common.h"
+
+using namespace zypp;
+
+static TestSetup test;
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+    test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+
+    RepoInfo repo;
+    repo.setAlias( "upd" );
+    repo.addBaseUrl( Url( "file://" TESTS_SRC_DIR "/data/openSUSE-11.1_updates" ) );
+    repo.setGpgCheck( false );
+    test.loadRepo( repo );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+namespace
+{
+  PoolQuery lock( const std::string & name_r, const ResKind & kind_r, Match::Mode mode_r = Match::GLOB, bool nocase_r = false )
+  {
+    PoolQuery q;
+    q.setMatchMode( mode_r );
+    q.setCaseSensitive( ! nocase_r );
+    q.addAttribute( sat::SolvAttr::name, name_r );
+    if ( ! kind_r.empty() )
+      q.addKind( kind_r );
+    return q;
+  }
+}
+
+// The evaluator must match exactly what the lock's PoolQuery matches,
+// otherwise 'locks -m' miscounts and 'cleanlocks' removes used locks.
+BOOST_AUTO_TEST_CASE(evaluator_matches_poolquery)
+{
+  std::vector<PoolQuery> queries {
+    lock( "zypper", ResKind::package ),
+    lock( "apparmor", ResKind::pattern ),
+    lock( "MozillaFirefox", ResKind::patch ),
+    lock( "apparmor", ResKind() ),				// package and pattern
+    lock( "APPARMOR", ResKind::pattern, Match::GLOB, true ),	// nocase
+    lock( "ZYPP*", ResKind::package, Match::GLOB, true ),
+    lock( "apparmor*", ResKind::pattern ),			// glob
+    lock( "Mozilla*", ResKind::patch ),
+    lock( "^apparmor-.*", ResKind(), Match::REGEX ),
+    lock( "armor", ResKind::pattern, Match::SUBSTRING ),
+  };
+  Locks & locks { Locks::instance() };
+  for ( const PoolQuery & q : queries )
+    locks.addLock( q );
+  BOOST_REQUIRE_EQUAL( locks.size(), queries.size() );
+
+  locks::LockEvaluator evaluator( locks );
+  unsigned idx = 0;
+  for ( const PoolQuery & q : locks )
+  {
+    std::set<sat::Solvable> expected( q.begin(), q.end() );
+    const std::vector<sat::Solvable> & matches { evaluator.matches( idx++ ) };
+    std::set<sat::Solvable> got( matches.begin(), matches.end() );
+    BOOST_CHECK_MESSAGE( got == expected, q << ": " << got.size() << " matches instead of " << expected.size() );
+    BOOST_CHECK( ! expected.empty() );
+  }
+}
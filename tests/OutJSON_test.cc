@@ -0,0 +1,44 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <sstream>
+
+#include "TestSetup.h"
+#include "output/OutJSON.h"
+
+using namespace zypp;
+
+BOOST_AUTO_TEST_CASE(quote)
+{
+  BOOST_CHECK_EQUAL( OutJSON::quote( "" ), "\"\"" );
+  BOOST_CHECK_EQUAL( OutJSON::quote( "vim" ), "\"vim\"" );
+  BOOST_CHECK_EQUAL( OutJSON::quote( "a\"b\\c\nd\te\x01" ), "\"a\\\"b\\\\c\\nd\\te\\u0001\"" );
+  BOOST_CHECK_EQUAL( OutJSON::quote( "\xc3\xa4" ), "\"\xc3\xa4\"" );	// UTF-8 is passed
+}
+
+BOOST_AUTO_TEST_CASE(record)
+{
+  BOOST_CHECK_EQUAL( OutJSON::Record().asString(), "{}" );
+  BOOST_CHECK_EQUAL( OutJSON::Record( "message" ).asString(), "{\"type\":\"message\"}" );
+
+  OutJSON::Record record( "update" );
+  record.add( "name", "vim" )
+        .add( "rate", -1L )
+        .add( "size", 42U )
+        .add( "restart", false )
+        .addIfNotEmpty( "summary", "" )
+        .add( "source", OutJSON::Record().add( "alias", "oss" ) )
+        .add( "issues", std::vector<OutJSON::Record>{ OutJSON::Record().add( "id", "1" ), OutJSON::Record().add( "id", "2" ) } );
+  BOOST_CHECK_EQUAL( record.asString(),
+                     "{\"type\":\"update\",\"name\":\"vim\",\"rate\":-1,\"size\":42,\"restart\":false,"
+                     "\"source\":{\"alias\":\"oss\"},\"issues\":[{\"id\":\"1\"},{\"id\":\"2\"}]}" );
+
+  std::ostringstream str;
+  OutJSON::writeRecord( str, OutJSON::Record( "a" ) );
+  OutJSON::writeRecord( str, OutJSON::Record( "b" ) );
+  BOOST_CHECK_EQUAL( str.str(), "{\"type\":\"a\"}\n{\"type\":\"b\"}\n" );
+}
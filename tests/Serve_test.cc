@@ -0,0 +1,150 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+#include <fstream>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "TestSetup.h"
+#include "Command.h"
+#include "commands/serve.h"
+
+using namespace zypp;
+
+BOOST_AUTO_TEST_CASE(parse_request)
+{
+  serve::Request req { serve::parseRequest( "{\"id\": 7, \"args\": [\"search\", \"-s\", \"vim\"]}" ) };
+  BOOST_CHECK_EQUAL( req.id, "7" );
+  BOOST_REQUIRE_EQUAL( req.args.size(), 3U );
+  BOOST_CHECK_EQUAL( req.args[0], "search" );
+  BOOST_CHECK_EQUAL( req.args[2], "vim" );
+
+  // string id, escapes, unknown keys
+  req = serve::parseRequest( " { \"args\" : [ \"info\", \"a\\\"b\\\\c\\u00e4\" ], \"x\": {\"y\": [1, true, null]}, \"id\": \"q1\" } " );
+  BOOST_CHECK_EQUAL( req.id, "\"q1\"" );
+  BOOST_REQUIRE_EQUAL( req.args.size(), 2U );
+  BOOST_CHECK_EQUAL( req.args[1], "a\"b\\c\xc3\xa4" );
+
+  // no id
+  req = serve::parseRequest( "{\"args\": []}" );
+  BOOST_CHECK_EQUAL( req.id, "null" );
+  BOOST_CHECK( req.args.empty() );
+}
+
+BOOST_AUTO_TEST_CASE(invalid_request)
+{
+  BOOST_CHECK_THROW( serve::parseRequest( "" ), Exception );
+  BOOST_CHECK_THROW( serve::parseRequest( "search vim" ), Exception );
+  BOOST_CHECK_THROW( serve::parseRequest( "{\"args\": [\"search\"}" ), Exception );
+  BOOST_CHECK_THROW( serve::parseRequest( "{\"args\": [1]}" ), Exception );
+  BOOST_CHECK_THROW( serve::parseRequest( "{\"args\": [\"se\"]} x" ), Exception );
+  BOOST_CHECK_THROW( serve::parseRequest( "{\"args\": [\"unterminated]}" ), Exception );
+}
+
+BOOST_AUTO_TEST_CASE(response)
+{
+  serve::Request req { serve::parseRequest( "{\"id\": \"a\", \"args\": [\"se\"]}" ) };
+  BOOST_CHECK_EQUAL( serve::response( req, 104, "line1\n\"x\"\t\x01", "" ),
+                     "{\"id\": \"a\", \"exit\": 104, \"output\": \"line1\\n\\\"x\\\"\\t\\u0001\", \"errors\": \"\"}" );
+}
+
+BOOST_AUTO_TEST_CASE(read_only_commands)
+{
+  BOOST_CHECK( serve::isReadOnlyCommand( ZypperCommand( "se" ) ) );
+  BOOST_CHECK( serve::isReadOnlyCommand( ZypperCommand( "info" ) ) );
+  BOOST_CHECK( serve::isReadOnlyCommand( ZypperCommand( "lu" ) ) );
+  BOOST_CHECK( serve::isReadOnlyCommand( ZypperCommand( "pa" ) ) );
+  BOOST_CHECK( ! serve::isReadOnlyCommand( ZypperCommand( "in" ) ) );
+  BOOST_CHECK( ! serve::isReadOnlyCommand( ZypperCommand( "ref" ) ) );
+  BOOST_CHECK( ! serve::isReadOnlyCommand( ZypperCommand( "al" ) ) );
+  BOOST_CHECK( ! serve::isReadOnlyCommand( ZypperCommand( "shell" ) ) );
+  BOOST_CHECK( ! serve::isReadOnlyCommand( ZypperCommand( "serve" ) ) );
+}
+
+namespace
+{
+  /** Connect to \a socket_r, waiting for the server to come up. */
+  int connectTo( const Pathname & socket_r )
+  {
+    struct sockaddr_un addr;
+    ::memset( &addr, 0, sizeof(addr) );
+    addr.sun_family = AF_UNIX;
+    ::strcpy( addr.sun_path, socket_r.c_str() );
+    for ( unsigned tries = 0; tries < 600; ++tries )
+    {
+      int fd = ::socket( AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0 );
+      if ( ::connect( fd, (struct sockaddr *)&addr, sizeof(addr) ) == 0 )
+        return fd;
+      ::close( fd );
+      ::usleep( 100 * 1000 );
+    }
+    return -1;
+  }
+
+  /** Send \a request_r and return the response line. */
+  std::string exchange( int fd_r, const std::string & request_r )
+  {
+    std::string line { request_r + '\n' };
+    if ( ::write( fd_r, line.data(), line.size() ) != ssize_t(line.size()) )
+      return std::string();
+    std::string ret;
+    char ch;
+    while ( ::read( fd_r, &ch, 1 ) == 1 && ch != '\n' )
+      ret += ch;
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(serve_test_repo)
+{
+  TestSetup test( Arch_x86_64 );
+  test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+  Pathname socket { test.root() / "serve.sock" };
+
+  // a file in the way is not removed
+  {
+    std::ofstream( socket.c_str() ) << "keep me" << std::endl;
+    test.zypper().commandServer( socket.asString() );
+    BOOST_CHECK_EQUAL( test.zypper().exitCode(), ZYPPER_EXIT_ERR_INVALID_ARGS );
+    BOOST_CHECK( PathInfo( socket ).isFile() );
+    filesystem::unlink( socket );
+    test.zypper().setExitCode( ZYPPER_EXIT_OK );
+  }
+
+  pid_t pid = ::fork();
+  BOOST_REQUIRE( pid != -1 );
+  if ( pid == 0 )
+  {
+    test.zypper().commandServer( socket.asString() );
+    ::_exit( 0 );
+  }
+
+  int fd = connectTo( socket );
+  BOOST_REQUIRE( fd != -1 );
+  std::string response { exchange( fd, "{\"id\": 1, \"args\": [\"search\", \"-x\", \"zypper\"]}" ) };
+  BOOST_CHECK( str::startsWith( response, "{\"id\": 1, \"exit\": 0," ) );
+  BOOST_CHECK( response.find( "| zypper " ) != std::string::npos );
+
+  response = exchange( fd, "{\"id\": 2, \"args\": [\"install\", \"zypper\"]}" );
+  BOOST_CHECK( str::startsWith( response, "{\"id\": 2, \"exit\": " + str::numstring( ZYPPER_EXIT_ERR_INVALID_ARGS ) + "," ) );
+
+  // an idle client is dropped and does not block the next one
+  int other = connectTo( socket );
+  BOOST_REQUIRE( other != -1 );
+  response = exchange( other, "{\"id\": 3, \"args\": [\"search\", \"-x\", \"libzypp\"]}" );
+  BOOST_CHECK( str::startsWith( response, "{\"id\": 3, \"exit\": 0," ) );
+  char ch;
+  BOOST_CHECK_EQUAL( ::read( fd, &ch, 1 ), 0 );	// closed by the server
+
+  ::close( other );
+  ::close( fd );
+  ::kill( pid, SIGKILL );
+  ::waitpid( pid, nullptr, 0 );
+}
@@ -416,6 +416,45 @@ BOOST_AUTO_TEST_CASE(install15)
   BOOST_CHECK(sr.toInstall().empty());
 }
 
+// request : install vi[m] zypper
+// response: names are looked up in the ident index, globs via PoolQuery;
+//           both select the same as when requested one by one
+BOOST_AUTO_TEST_CASE(install16)
+{
+  MIL << "<============install16===============>" << endl;
+
+  std::vector<std::string> rawargs;
+  rawargs.push_back("vi[m]");
+  rawargs.push_back("zypper");
+  SolverRequester sr;
+
+  sr.install(rawargs);
+
+  BOOST_CHECK(!sr.hasFeedback(SolverRequester::Feedback::NOT_FOUND_NAME_TRYING_CAPS));
+  BOOST_CHECK_EQUAL(sr.toInstall().size(), 2);
+  BOOST_CHECK(hasPoolItem(sr.toInstall(), "vim", Edition("7.2-7.4.1"), Arch_x86_64));
+  BOOST_CHECK(hasPoolItem(sr.toInstall(), "zypper", Edition("1.0.13-0.1.1"), Arch_x86_64));
+}
+
+// request : install libzypp-testsuite-tools-4.2.6-3.10
+// response: set the package to install, not the equally named and versioned
+//           srcpackage (both in the zypp repo)
+BOOST_AUTO_TEST_CASE(install17)
+{
+  MIL << "<============install17===============>" << endl;
+
+  std::vector<std::string> rawargs;
+  rawargs.push_back("libzypp-testsuite-tools-4.2.6-3.10");
+  SolverRequester sr;
+
+  sr.install(rawargs);
+
+  BOOST_CHECK(sr.hasFeedback(SolverRequester::Feedback::SET_TO_INSTALL));
+  BOOST_CHECK_EQUAL(sr.toInstall().size(), 1);
+  BOOST_CHECK(hasPoolItem(sr.toInstall(), "libzypp-testsuite-tools", Edition("4.2.6-3.10"), Arch_x86_64));
+  BOOST_CHECK(!hasPoolItem(sr.toInstall(), "libzypp-testsuite-tools", Edition(), Arch_empty, ResKind::srcpackage));
+}
+
 
 ///////////////////////////////////////////////////////////////////////////
 // Locks
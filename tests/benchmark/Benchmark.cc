@@ -0,0 +1,308 @@
+/*---------------------------------------------------------------------------*\
+                          ____  _ _ __ _ __  ___ _ _
+                         |_ / || | '_ \ '_ \/ -_) '_|
+                         /__|\_, | .__/ .__/\___|_|
+                             |__/|_|  |_|
+\*---------------------------------------------------------------------------*/
+
+/** \file tests/benchmark/Benchmark.cc
+ *
+ * Benchmarks of zypper's own hot paths, run on the tests/data repositories.
+ *
+ * \code
+ *   zypper_benchmark [--scale N] [--iterations N] [--output FILE]
+ *                    [--baseline FILE [--tolerance PERCENT]]
+ * \endcode
+ *
+ * The target is faked from the openSUSE-11.1_subset repo, openSUSE-11.1,
+ * openSUSE-11.1_updates and OBS_zypp_svn-11.1 are the available repos.
+ * With \c --scale N the available repos are loaded N times (with different
+ * aliases) to get a synthetically scaled-up pool.
+ *
+ * Each benchmark is run once to warm up and then \c --iterations times.
+ * The results are written to stdout or the \c --output file as a single
+ * JSON object: the scale, the number of solvables and a \c benchmarks array
+ * holding the min/median/mean (in msec) of each benchmark. The array
+ * elements are written one per line, which is what reading a \c --baseline
+ * relies on.
+ *
+ * Given the results of a previous run as \c --baseline, the medians are
+ * compared and the program fails (exit code 1) if any benchmark got slower
+ * by more than \c --tolerance percent (default 20). Timings depend on the
+ * host, so the baseline should be created on the same machine.
+ */
+
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "TestSetup.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <regex>
+#include <sstream>
+#include <streambuf>
+
+#include <zypp/Package.h>
+#include <zypp/PoolQuery.h>
+
+#include "PackageArgs.h"
+#include "SolverRequester.h"
+#include "Summary.h"
+#include "Table.h"
+#include "search.h"
+#include "update.h"
+
+using namespace zypp;
+
+extern ZYpp::Ptr God;
+
+namespace
+{
+  /** Discard everything written to std::cout during the guards lifetime. */
+  class SuppressCout
+  {
+    struct NullBuf : public std::streambuf
+    {
+      int overflow( int ch_r ) override
+      { return traits_type::not_eof( ch_r ); }
+    };
+
+  public:
+    SuppressCout()
+    : _saved { cout.rdbuf( &_null ) }
+    {}
+
+    ~SuppressCout()
+    { cout.rdbuf( _saved ); }
+
+  private:
+    NullBuf _null;
+    std::streambuf * _saved;
+  };
+
+  struct Result
+  {
+    std::string _name;
+    unsigned _iterations = 0;
+    double _min = 0.0;		///< msec
+    double _median = 0.0;	///< msec
+    double _mean = 0.0;		///< msec
+  };
+
+  /** Run \a fnc_r once to warm up, then \a iterations_r times measured. */
+  template <class TFnc>
+  Result measure( const std::string & name_r, unsigned iterations_r, TFnc && fnc_r )
+  {
+    using Clock = std::chrono::steady_clock;
+    MIL << "Benchmark " << name_r << endl;
+
+    fnc_r();
+    std::vector<double> times;
+    for ( unsigned i = 0; i < iterations_r; ++i )
+    {
+      Clock::time_point start = Clock::now();
+      fnc_r();
+      times.push_back( std::chrono::duration<double,std::milli>( Clock::now() - start ).count() );
+    }
+    std::sort( times.begin(), times.end() );
+
+    Result ret;
+    ret._name = name_r;
+    ret._iterations = iterations_r;
+    ret._min = times.front();
+    ret._median = times[times.size() / 2];
+    ret._mean = std::accumulate( times.begin(), times.end(), 0.0 ) / times.size();
+    return ret;
+  }
+
+  /** Undo all transactions (SolverRequester, solver). */
+  void resetTransactions()
+  {
+    for ( const PoolItem & pi : ResPool::instance() )
+      pi.statusReset();
+  }
+
+  /** Names of the available packages (every \a step_r one). */
+  std::vector<std::string> packageNames( unsigned step_r )
+  {
+    std::set<std::string> names;
+    unsigned cnt = 0;
+    for ( const PoolItem & pi : ResPool::instance() )
+    {
+      if ( pi.isKind<Package>() && ! pi.status().isInstalled() && ( cnt++ % step_r ) == 0 )
+        names.insert( pi.name() );
+    }
+    return std::vector<std::string>( names.begin(), names.end() );
+  }
+
+  /** Write the JSON object described above (each benchmark on its own line). */
+  void writeResults( std::ostream & str_r, unsigned scale_r, const std::vector<Result> & results_r )
+  {
+    str_r << "{ \"scale\": " << scale_r << ", \"solvables\": " << sat::Pool::instance().solvablesSize() << ", \"benchmarks\": [" << endl;
+    for ( unsigned i = 0; i < results_r.size(); ++i )
+    {
+      const Result & res { results_r[i] };
+      str_r << str::form( "  { \"name\": \"%s\", \"iterations\": %u, \"min_ms\": %.3f, \"median_ms\": %.3f, \"mean_ms\": %.3f }%s",
+                          res._name.c_str(), res._iterations, res._min, res._median, res._mean,
+                          i + 1 < results_r.size() ? "," : "" ) << endl;
+    }
+    str_r << "] }" << endl;
+  }
+
+  /** The medians from a file written by \ref writeResults. */
+  std::map<std::string,double> readMedians( const Pathname & file_r )
+  {
+    static const std::regex rx { "\"name\": \"([^\"]*)\".*\"median_ms\": ([0-9.]+)" };
+    std::map<std::string,double> ret;
+    std::ifstream in( file_r.c_str() );
+    for ( std::string line; std::getline( in, line ); )
+    {
+      std::smatch what;
+      if ( std::regex_search( line, what, rx ) )
+        ret[what[1]] = std::stod( what[2] );
+    }
+    return ret;
+  }
+} // namespace
+
+int main( int argc, char ** argv )
+{
+  unsigned scale = 1;
+  unsigned iterations = 10;
+  Pathname output;
+  Pathname baseline;
+  double tolerance = 20.0;
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    std::string arg { argv[i] };
+    if ( i + 1 < argc && arg == "--scale" )
+      scale = std::max( 1U, str::strtonum<unsigned>( argv[++i] ) );
+    else if ( i + 1 < argc && arg == "--iterations" )
+      iterations = std::max( 1U, str::strtonum<unsigned>( argv[++i] ) );
+    else if ( i + 1 < argc && arg == "--output" )
+      output = argv[++i];
+    else if ( i + 1 < argc && arg == "--baseline" )
+      baseline = argv[++i];
+    else if ( i + 1 < argc && arg == "--tolerance" )
+      tolerance = std::stod( argv[++i] );
+    else
+    {
+      cerr << "Usage: " << argv[0] << " [--scale N] [--iterations N] [--output FILE] [--baseline FILE [--tolerance PERCENT]]" << endl;
+      return 2;
+    }
+  }
+
+  zypp::base::LogControl::instance().logfile( "./zypper_benchmark.log" );
+  TestSetup test( Arch_x86_64 );
+  God = zypp::getZYpp();
+
+  test.loadTargetRepo( TESTS_SRC_DIR "/data/openSUSE-11.1_subset" );
+  for ( unsigned i = 0; i < scale; ++i )
+  {
+    std::string suffix { i ? str::numstring( i ) : "" };
+    test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" + suffix );
+    test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1_updates", "upd" + suffix );
+    test.loadRepo( TESTS_SRC_DIR "/data/OBS_zypp_svn-11.1", "zypp" + suffix );
+  }
+  God->resolver()->resolvePool();
+  resetTransactions();
+
+  std::vector<Result> results;
+  const std::vector<std::string> names { packageNames( 10 ) };
+  std::vector<std::string> rawargs { names };
+  rawargs.push_back( "zypper>=1.0" );
+  rawargs.push_back( "main:vim" );
+  rawargs.push_back( "libzypp" );
+  rawargs.push_back( "=" );
+  rawargs.push_back( "5.24.5" );
+
+  results.push_back( measure( "PackageArgs", iterations, [&]() {
+    PackageArgs args( rawargs );
+  } ) );
+
+  results.push_back( measure( "SolverRequester::install", iterations, [&]() {
+    SolverRequester sr;
+    sr.install( PackageArgs( names ) );
+    resetTransactions();
+  } ) );
+
+  results.push_back( measure( "FillSearchTableSolvable", iterations, []() {
+    PoolQuery query;
+    query.addAttribute( sat::SolvAttr::name );
+    query.addString( "lib" );
+    query.setMatchSubstring();
+    SolvableTable t;
+    FillSearchTableSolvable callback( t );
+    for_( it, query.begin(), query.end() )
+      callback( it );
+  } ) );
+
+  results.push_back( measure( "FillSearchTableSelectable", iterations, []() {
+    PoolQuery query;
+    query.addAttribute( sat::SolvAttr::name );
+    query.addString( "lib" );
+    query.setMatchSubstring();
+    SolvableTable t;
+    FillSearchTableSelectable callback( t );
+    for_( it, query.selectableBegin(), query.selectableEnd() )
+      callback( *it );
+  } ) );
+
+  results.push_back( measure( "list-updates", iterations, []() {
+    SuppressCout guard;
+    list_updates( Zypper::instance(), ResKindSet{ ResKind::package }, false, false );
+  } ) );
+
+  // the summary of a 'zypper up' plus some installs
+  {
+    SolverRequester sr;
+    sr.install( PackageArgs( packageNames( 50 ) ) );
+    God->resolver()->doUpdate();
+
+    results.push_back( measure( "Summary", iterations, []() {
+      std::ostringstream str;
+      Summary summary( ResPool::instance(), SummaryHints() );
+      summary.dumpTo( str );
+    } ) );
+
+    results.push_back( measure( "Summary (XML)", iterations, []() {
+      std::ostringstream str;
+      Summary summary( ResPool::instance(), SummaryHints() );
+      summary.dumpAsXmlTo( str );
+    } ) );
+
+    resetTransactions();
+  }
+
+  if ( output.empty() )
+    writeResults( cout, scale, results );
+  else
+  {
+    std::ofstream out( output.c_str() );
+    writeResults( out, scale, results );
+  }
+
+  int ret = 0;
+  if ( ! baseline.empty() )
+  {
+    std::map<std::string,double> medians { readMedians( baseline ) };
+    for ( const Result & res : results )
+    {
+      auto it = medians.find( res._name );
+      if ( it == medians.end() )
+        continue;
+      double change = it->second > 0.0 ? ( res._median - it->second ) * 100.0 / it->second : 0.0;
+      bool regression = change > tolerance;
+      cerr << str::form( "%-28s %10.3f ms  (baseline %10.3f ms, %+6.1f%%)%s",
+                         res._name.c_str(), res._median, it->second, change, regression ? "  REGRESSION" : "" ) << endl;
+      if ( regression )
+        ret = 1;
+    }
+  }
+
+  test.reset();
+  return ret;
+}
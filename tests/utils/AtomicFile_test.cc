@@ -0,0 +1,53 @@
+#include "TestSetup.h"
+#include "utils/AtomicFile.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+  std::string content( const Pathname & file_r )
+  {
+    std::ifstream in( file_r.c_str(), std::ios::binary );
+    std::ostringstream str;
+    str << in.rdbuf();
+    return str.str();
+  }
+
+  /** The files left in \a dir_r. */
+  std::string entries( const Pathname & dir_r )
+  {
+    std::list<std::string> ret;
+    filesystem::readdir( ret, dir_r, /*dots*/false );
+    ret.sort();
+    return str::join( ret, "," );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(write_and_replace)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "sub" / "dir" / "cache" };	// the directory is created
+
+  BOOST_CHECK( writeFileAtomic( file, []( std::ostream & out ) { out << "first\n"; } ) );
+  BOOST_CHECK_EQUAL( content( file ), "first\n" );
+
+  const std::string binary( "a\0b\r\n", 5 );
+  BOOST_CHECK( writeFileAtomic( file, [&]( std::ostream & out ) { out.write( binary.data(), binary.size() ); }, std::ios::binary ) );
+  BOOST_CHECK_EQUAL( content( file ), binary );
+  BOOST_CHECK_EQUAL( entries( file.dirname() ), "cache" );
+}
+
+BOOST_AUTO_TEST_CASE(failed_write_keeps_file)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "cache" };
+  BOOST_REQUIRE( writeFileAtomic( file, []( std::ostream & out ) { out << "old\n"; } ) );
+
+  BOOST_CHECK( ! writeFileAtomic( file, []( std::ostream & out ) {
+    out << "partial";
+    out.setstate( std::ios::badbit );
+  } ) );
+  BOOST_CHECK_EQUAL( content( file ), "old\n" );
+  BOOST_CHECK_EQUAL( entries( tmp.path() ), "cache" );
+}
@@ -0,0 +1,56 @@
+#include "TestSetup.h"
+#include "utils/ConfigReader.h"
+
+#include <sstream>
+
+namespace
+{
+  ConfigReader::Options parse( const std::string & content_r )
+  {
+    std::istringstream str( content_r );
+    return ConfigReader::parse( str, "zypper.conf" );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parse_like_the_lens)
+{
+  ConfigReader::Options opts { parse(
+    "## Configuration file for Zypper.\n"
+    "# comment\n"
+    "\n"
+    "[main]\n"
+    "## Valid values: true, false\n"
+    "# showAlias = false\n"
+    "repoListColumns = anr \n"
+    "  refreshJobs=4\n"
+    "emptyValue =\n"
+    "\n"
+    "[color]\n"
+    "useColors = always\n"
+    "[main]\n"
+    "refreshJobs = 8\n"
+  ) };
+
+  BOOST_CHECK_EQUAL( opts.size(), 4 );
+  BOOST_CHECK( ! opts.count( "main/showAlias" ) );	// commented out
+  BOOST_CHECK_EQUAL( opts["main/repoListColumns"].back(), "anr" );
+  BOOST_CHECK_EQUAL( opts["main/emptyValue"].back(), "" );
+  BOOST_CHECK_EQUAL( opts["color/useColors"].back(), "always" );
+  // multiple definitions are kept in order (the last one is used)
+  BOOST_REQUIRE_EQUAL( opts["main/refreshJobs"].size(), 2 );
+  BOOST_CHECK_EQUAL( opts["main/refreshJobs"][0], "4" );
+  BOOST_CHECK_EQUAL( opts["main/refreshJobs"][1], "8" );
+}
+
+BOOST_AUTO_TEST_CASE(reject_what_the_lens_rejects)
+{
+  BOOST_CHECK_THROW( parse( "key = value\n" ), Exception );		// outside of a section
+  BOOST_CHECK_THROW( parse( "[main]\nnovalue\n" ), Exception );
+  BOOST_CHECK_THROW( parse( "[main]\n1key = value\n" ), Exception );
+  BOOST_CHECK_THROW( parse( "[main]\nk = value\n" ), Exception );	// keyword too short
+  BOOST_CHECK_THROW( parse( " [main]\n" ), Exception );
+  BOOST_CHECK_THROW( parse( "[ma in]\n" ), Exception );
+  BOOST_CHECK_THROW( parse( "[main] x\n" ), Exception );
+  BOOST_CHECK_THROW( parse( "[]\n" ), Exception );
+  BOOST_CHECK_NO_THROW( parse( "[main]  \n  # indented comment\n" ) );
+}
@@ -0,0 +1,104 @@
+#include "TestSetup.h"
+#include "utils/DeletedFilesScanner.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+  /** A file in the build dir (/tmp is ignored by the scanner) which is opened and deleted. */
+  struct OpenDeletedFile
+  {
+    OpenDeletedFile( const std::string & name_r )
+    : _tmp { TESTS_BUILD_DIR }
+    , _file { _tmp.path() / name_r }
+    {
+      _fd = ::open( _file.c_str(), O_CREAT|O_RDWR|O_CLOEXEC, 0600 );
+      ::unlink( _file.c_str() );
+    }
+
+    ~OpenDeletedFile()
+    { if ( _fd != -1 ) ::close( _fd ); }
+
+    filesystem::TmpDir _tmp;
+    Pathname _file;
+    int _fd = -1;
+  };
+
+  const DeletedFilesScanner::ProcInfo * findPid( const std::vector<DeletedFilesScanner::ProcInfo> & procs_r, pid_t pid_r )
+  {
+    for ( const auto & proc : procs_r )
+    {
+      if ( proc.pid == str::numstring( pid_r ) )
+        return &proc;
+    }
+    return nullptr;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(open_deleted_file)
+{
+  OpenDeletedFile deleted( "scanner-test" );
+  BOOST_REQUIRE( deleted._fd != -1 );
+
+  std::vector<DeletedFilesScanner::ProcInfo> procs { DeletedFilesScanner().scan( ::getpid() ) };
+  BOOST_REQUIRE_EQUAL( procs.size(), 1U );
+  BOOST_CHECK_EQUAL( procs[0].pid, str::numstring( ::getpid() ) );
+  BOOST_CHECK_EQUAL( procs[0].ppid, str::numstring( ::getppid() ) );
+  BOOST_CHECK_EQUAL( procs[0].puid, str::numstring( ::getuid() ) );
+  BOOST_CHECK( std::find( procs[0].files.begin(), procs[0].files.end(), deleted._file.asString() ) != procs[0].files.end() );
+}
+
+BOOST_AUTO_TEST_CASE(all_processes)
+{
+  OpenDeletedFile deleted( "scanner-test" );
+  BOOST_REQUIRE( deleted._fd != -1 );
+
+  std::vector<DeletedFilesScanner::ProcInfo> procs { DeletedFilesScanner( 4 ).scan() };
+  BOOST_CHECK( findPid( procs, ::getpid() ) );
+  for ( unsigned i = 1; i < procs.size(); ++i )
+    BOOST_CHECK_LT( str::strtonum<pid_t>( procs[i-1].pid ), str::strtonum<pid_t>( procs[i].pid ) );
+}
+
+BOOST_AUTO_TEST_CASE(file_filter)
+{
+  OpenDeletedFile deleted( "scanner-test" );
+  BOOST_REQUIRE( deleted._fd != -1 );
+
+  DeletedFilesScanner scanner;
+  scanner.setFileFilter( { "/usr/lib64/not-the-file" } );
+  BOOST_CHECK( scanner.scan( ::getpid() ).empty() );
+
+  // the same name elsewhere is not the file
+  scanner.setFileFilter( { "/lib64/scanner-test" } );
+  BOOST_CHECK( scanner.scan( ::getpid() ).empty() );
+
+  scanner.setFileFilter( { deleted._file.asString() } );
+  std::vector<DeletedFilesScanner::ProcInfo> procs { scanner.scan( ::getpid() ) };
+  BOOST_REQUIRE_EQUAL( procs.size(), 1U );
+  BOOST_CHECK_EQUAL( procs[0].files.size(), 1U );
+  BOOST_CHECK_EQUAL( procs[0].files[0], deleted._file.asString() );
+}
+
+BOOST_AUTO_TEST_CASE(file_filter_resolved_dir)
+{
+  OpenDeletedFile deleted( "scanner-test" );
+  BOOST_REQUIRE( deleted._fd != -1 );
+
+  // the packaged path may use a symlinked directory (/lib64 -> usr/lib64)
+  filesystem::TmpDir links { TESTS_BUILD_DIR };
+  Pathname link { links.path() / "lib64" };
+  BOOST_REQUIRE_EQUAL( filesystem::symlink( deleted._file.dirname(), link ), 0 );
+
+  DeletedFilesScanner scanner;
+  scanner.setFileFilter( { ( link / "scanner-test" ).asString() } );
+  std::vector<DeletedFilesScanner::ProcInfo> procs { scanner.scan( ::getpid() ) };
+  BOOST_REQUIRE_EQUAL( procs.size(), 1U );
+  BOOST_CHECK_EQUAL( procs[0].files[0], deleted._file.asString() );
+}
+
+BOOST_AUTO_TEST_CASE(not_in_container)
+{
+  BOOST_CHECK( ! DeletedFilesScanner::runsInContainer( ::getpid() ) );
+}
@@ -0,0 +1,106 @@
+#include "TestSetup.h"
+#include "utils/HistoryLog.h"
+
+#include <fstream>
+
+namespace
+{
+  Date localDate( const std::string & str_r )
+  { return Date( str_r, "%Y-%m-%d %H:%M:%S" ); }
+
+  std::vector<std::string> collect( const HistoryLog & log_r, const HistoryLog::Filter & filter_r )
+  {
+    std::vector<std::string> ret;
+    log_r.forEach( filter_r, [&ret]( const HistoryLog::Line & line_r ) {
+      ret.push_back( std::string( line_r.date() ) + " " + std::string( line_r.action() ) );
+      return true;
+    } );
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(filter_small_log)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "history" };
+  {
+    std::ofstream str( file.c_str() );
+    str << "# 2020-01-01 00:00:00 comment\n"
+        << "2020-01-01 10:00:00|command|root@host|'zypper' 'in' 'a\\|b'|\n"
+        << "2020-01-01 10:00:01|install|a|1-1|x86_64||repo|sum|\n"
+        << "2020-01-02 10:00:00|remove |b|1-1|x86_64|root@host||\n"
+        << "2020-01-03 10:00:00|patch  |p|1|noarch|repo|needed|applied|\n"
+        << "2020-01-04 10:00:00|install|c|1-1|x86_64||repo|sum|";	// incomplete
+  }
+
+  HistoryLog log { file };
+  BOOST_REQUIRE( log );
+  std::vector<std::string> all { collect( log, HistoryLog::Filter() ) };
+  BOOST_REQUIRE_EQUAL( all.size(), 4 );
+  BOOST_CHECK_EQUAL( all[1], "2020-01-01 10:00:01 install" );
+
+  HistoryLog::Filter filter;
+  filter._since = localDate( "2020-01-01 10:00:01" );
+  filter._until = localDate( "2020-01-02 10:00:00" );
+  BOOST_CHECK_EQUAL( collect( log, filter ).size(), 2 );
+
+  // the padded IDs in the log match the HistoryActionID strings
+  filter = HistoryLog::Filter();
+  filter._actions = { HistoryActionID::INSTALL.asString(), HistoryActionID::PATCH_STATE_CHANGE.asString() };
+  BOOST_CHECK_EQUAL( collect( log, filter ).size(), 2 );
+  filter._actions = { HistoryActionID::REMOVE.asString() };
+  std::vector<std::string> removed { collect( log, filter ) };
+  BOOST_REQUIRE_EQUAL( removed.size(), 1 );
+  BOOST_CHECK_EQUAL( removed[0], "2020-01-02 10:00:00 remove" );
+  filter._actions = { HistoryActionID::PATCH_STATE_CHANGE.asString( true ) };	// padded
+  BOOST_CHECK_EQUAL( collect( log, filter ).size(), 0 );
+
+  // escaped field separators
+  log.forEach( HistoryLog::Filter(), []( const HistoryLog::Line & line_r ) {
+    BOOST_CHECK_EQUAL( line_r.field( 3 ), "'zypper' 'in' 'a\\|b'" );
+    BOOST_CHECK_EQUAL( line_r.fields()[3], "'zypper' 'in' 'a|b'" );
+    return false;
+  } );
+
+  // continue after the lines read
+  filter = HistoryLog::Filter();
+  filter._offset = log.end();
+  BOOST_CHECK_EQUAL( collect( log, filter ).size(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(filter_indexed_log)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "history" };
+  unsigned lines = 0;
+  {
+    std::ofstream str( file.c_str() );
+    std::string padding( 200, 'x' );
+    for ( unsigned day = 1; day <= 28; ++day )
+    {
+      for ( unsigned hour = 0; hour < 24; ++hour, ++lines )
+        str << str::form( "2020-02-%02u %02u:00:00|command|root@host|%s|\n", day, hour, padding.c_str() );
+    }
+    // clock turned back an hour
+    str << "2020-02-28 23:30:00|command|root@host||\n"
+        << "2020-02-28 22:45:00|command|root@host||\n";
+    lines += 2;
+  }
+
+  HistoryLog log { file };
+  BOOST_REQUIRE( log );
+  BOOST_REQUIRE( log.end() > 2 * HistoryLog::indexBlockSize );
+  BOOST_CHECK_EQUAL( collect( log, HistoryLog::Filter() ).size(), lines );
+
+  HistoryLog::Filter filter;
+  filter._since = localDate( "2020-02-10 00:00:00" );
+  filter._until = localDate( "2020-02-10 23:59:59" );
+  std::vector<std::string> day { collect( log, filter ) };
+  BOOST_REQUIRE_EQUAL( day.size(), 24 );
+  BOOST_CHECK_EQUAL( day.front(), "2020-02-10 00:00:00 command" );
+  BOOST_CHECK_EQUAL( day.back(), "2020-02-10 23:00:00 command" );
+
+  filter._since = localDate( "2020-02-28 22:30:00" );
+  filter._until = Date();
+  BOOST_CHECK_EQUAL( collect( log, filter ).size(), 3 );	// 23:00, 23:30 and 22:45
+}
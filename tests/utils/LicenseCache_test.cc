@@ -0,0 +1,25 @@
+#include "TestSetup.h"
+#include "utils/LicenseCache.h"
+
+BOOST_AUTO_TEST_CASE(accepted_texts)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { LicenseCache::defaultFile( tmp.path() ) };
+  const std::string eula { "You may use this product.\n" };
+
+  {
+    LicenseCache cache( file );
+    BOOST_CHECK( ! cache.accepted( "product:SLES", eula ) );
+    cache.accept( "product:SLES", eula );
+    BOOST_CHECK( cache.accepted( "product:SLES", eula ) );
+    cache.save();	// creates the zypper directory
+  }
+
+  LicenseCache cache( file );
+  BOOST_CHECK( cache.accepted( "product:SLES", eula ) );
+  BOOST_CHECK( ! cache.accepted( "product:SLES", eula + "And more.\n" ) );	// changed text
+  BOOST_CHECK( ! cache.accepted( "SLES", eula ) );				// package, not product
+
+  cache.accept( "product:SLES", eula + "And more.\n" );
+  BOOST_CHECK( ! cache.accepted( "product:SLES", eula ) );
+}
@@ -0,0 +1,54 @@
+#include "TestSetup.h"
+#include "utils/ParallelJobs.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+BOOST_AUTO_TEST_CASE(results_in_order)
+{
+  ParallelJobs jobs( 3 );
+  BOOST_CHECK_EQUAL( jobs.maxJobs(), 3U );
+  for ( int i = 0; i < 7; ++i )
+  {
+    // later jobs finish first
+    jobs.add( [i]() -> int {
+      ::usleep( 10000 * ( 7 - i ) );
+      if ( i == 3 )
+        ZYPP_THROW( Exception( "job failed" ) );
+      return i;
+    } );
+  }
+  BOOST_CHECK_EQUAL( jobs.size(), 7U );
+
+  std::vector<unsigned> finished;
+  std::vector<int> res( jobs.run( [&finished]( unsigned idx_r, int ) { finished.push_back( idx_r ); } ) );
+  BOOST_REQUIRE_EQUAL( res.size(), 7U );
+  for ( int i = 0; i < 7; ++i )
+    BOOST_CHECK_EQUAL( res[i], i == 3 ? ParallelJobs::failed : i );
+  BOOST_CHECK_EQUAL( finished.size(), 7U );
+}
+
+BOOST_AUTO_TEST_CASE(max_jobs_per_group)
+{
+  filesystem::TmpDir tmp;
+  ParallelJobs jobs( 4 );
+  jobs.setMaxJobsPerGroup( 1 );
+  for ( int i = 0; i < 6; ++i )
+  {
+    std::string group( i % 2 ? "odd" : "even" );
+    Pathname flag( tmp.path() / group );
+    // fails if another job of the same group is running
+    jobs.add( [flag]() -> int {
+      int fd = ::open( flag.c_str(), O_CREAT|O_EXCL|O_WRONLY, 0600 );
+      if ( fd == -1 )
+        return 1;
+      ::close( fd );
+      ::usleep( 20000 );
+      ::unlink( flag.c_str() );
+      return 0;
+    }, group );
+  }
+
+  for ( int res : jobs.run() )
+    BOOST_CHECK_EQUAL( res, 0 );
+}
@@ -0,0 +1,164 @@
+#include "TestSetup.h"
+#include "utils/misc.h"
+
+#include <zypp/Patch.h>
+
+#include <fstream>
+#include <sstream>
+
+static TestSetup test;
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+    RepoInfo repo;
+    repo.setAlias( "upd" );
+    repo.addBaseUrl( Url( "file://" TESTS_SRC_DIR "/data/openSUSE-11.1_updates" ) );
+    repo.setGpgCheck( false );
+    test.loadRepo( repo );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+namespace
+{
+  Date localDate( const std::string & str_r )
+  { return Date( str_r, "%Y-%m-%d %H:%M:%S" ); }
+
+  /** The first \a cnt_r patches in the pool. */
+  std::vector<sat::Solvable> patches( unsigned cnt_r )
+  {
+    std::vector<sat::Solvable> ret;
+    for ( const PoolItem & pi : ResPool::instance().byKind<Patch>() )
+    {
+      ret.push_back( pi.satSolvable() );
+      if ( ret.size() == cnt_r )
+        break;
+    }
+    BOOST_REQUIRE_EQUAL( ret.size(), cnt_r );
+    return ret;
+  }
+
+  /** A patch state change line as written by libzypp. */
+  std::string patchLine( const std::string & date_r, const sat::Solvable & patch_r, const std::string & state_r )
+  {
+    return date_r + "|patch  |" + patch_r.name() + "|" + patch_r.edition().asString() + "|" + patch_r.arch().asString()
+         + "|upd|important|security|needed|" + state_r + "|\n";
+  }
+
+  void write( const Pathname & file_r, const std::string & lines_r, std::ios::openmode mode_r = std::ios::trunc )
+  {
+    std::ofstream str( file_r.c_str(), std::ios::out | mode_r );
+    str << lines_r;
+  }
+
+  /** Replace \a from_r by \a to_r in the cached data (not the header), to tell cached from parsed data. */
+  void tamper( const Pathname & cache_r, const std::string & from_r, const std::string & to_r )
+  {
+    std::ifstream in( cache_r.c_str() );
+    std::string header;
+    std::getline( in, header );
+    std::ostringstream rest;
+    rest << in.rdbuf();
+    std::string data { rest.str() };
+    std::string::size_type pos { data.find( from_r ) };
+    BOOST_REQUIRE( pos != std::string::npos );
+    data.replace( pos, from_r.size(), to_r );
+    in.close();
+    write( cache_r, header + "\n" + data );
+  }
+
+  /** The offset stored in the cache header. */
+  off_t cachedOffset( const Pathname & cache_r )
+  {
+    std::ifstream in( cache_r.c_str() );
+    std::string magic;
+    unsigned version = 0;
+    dev_t dev = 0;
+    ino_t ino = 0;
+    off_t offset = 0;
+    in >> magic >> version >> dev >> ino >> offset;
+    return offset;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(incremental_update)
+{
+  filesystem::TmpDir tmp;
+  Pathname history { tmp.path() / "history" };
+  Pathname cache { tmp.path() / "zypper-patch-history" };
+  std::vector<sat::Solvable> p { patches( 2 ) };
+  const Date dateA { localDate( "2020-01-01 10:00:00" ) };
+  const Date dateB { localDate( "2020-01-02 10:00:00" ) };
+  const Date tampered { localDate( "2030-01-01 00:00:00" ) };
+  const std::string lineA { patchLine( "2020-01-01 10:00:00", p[0], "applied" ) };
+  const std::string lineB { patchLine( "2020-01-02 10:00:00", p[1], "applied" ) };
+
+  // initial parse writes the cache
+  write( history, lineA );
+  {
+    PatchHistoryData data( history, cache );
+    BOOST_REQUIRE( data );
+    BOOST_CHECK_EQUAL( data[p[0]].first, dateA );
+    BOOST_CHECK_EQUAL( data[p[0]].second, ResStatus::SATISFIED );
+    BOOST_CHECK( data[p[1]] == PatchHistoryData::noData );
+    BOOST_CHECK_EQUAL( cachedOffset( cache ), PathInfo( history ).size() );
+  }
+
+  // appended lines: just these are parsed, the cached data are kept
+  tamper( cache, "|" + str::numstring( Date::ValueType(dateA) ) + "|", "|" + str::numstring( Date::ValueType(tampered) ) + "|" );
+  write( history, lineB, std::ios::app );
+  {
+    PatchHistoryData data( history, cache );
+    BOOST_CHECK_EQUAL( data[p[0]].first, tampered );
+    BOOST_CHECK_EQUAL( data[p[1]].first, dateB );
+    BOOST_CHECK_EQUAL( cachedOffset( cache ), PathInfo( history ).size() );
+  }
+
+  // a partially written last line is left for the next time
+  write( history, lineA.substr( 0, 20 ), std::ios::app );
+  {
+    off_t complete { PathInfo( history ).size() - 20 };
+    PatchHistoryData data( history, cache );
+    BOOST_CHECK_EQUAL( data[p[0]].first, tampered );
+    BOOST_CHECK_EQUAL( cachedOffset( cache ), complete );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(rotated_file)
+{
+  filesystem::TmpDir tmp;
+  Pathname history { tmp.path() / "history" };
+  Pathname cache { tmp.path() / "zypper-patch-history" };
+  std::vector<sat::Solvable> p { patches( 2 ) };
+  const Date dateA { localDate( "2020-01-01 10:00:00" ) };
+  const Date tampered { localDate( "2030-01-01 00:00:00" ) };
+  const std::string lineA { patchLine( "2020-01-01 10:00:00", p[0], "applied" ) };
+  const std::string lineB { patchLine( "2020-01-02 10:00:00", p[1], "applied" ) };
+  auto tamperA = [&]() {
+    tamper( cache, "|" + str::numstring( Date::ValueType(dateA) ) + "|", "|" + str::numstring( Date::ValueType(tampered) ) + "|" );
+  };
+
+  write( history, lineA + lineB );
+  BOOST_REQUIRE( PatchHistoryData( history, cache ) );
+
+  // new inode: parsed from the beginning
+  tamperA();
+  Pathname rotated { tmp.path() / "history.new" };
+  write( rotated, lineA + lineB );
+  BOOST_REQUIRE_EQUAL( filesystem::rename( rotated, history ), 0 );
+  {
+    PatchHistoryData data( history, cache );
+    BOOST_CHECK_EQUAL( data[p[0]].first, dateA );
+  }
+
+  // same inode but smaller: parsed from the beginning
+  tamperA();
+  write( history, lineA );
+  {
+    PatchHistoryData data( history, cache );
+    BOOST_CHECK_EQUAL( data[p[0]].first, dateA );
+    BOOST_CHECK( data[p[1]] == PatchHistoryData::noData );
+    BOOST_CHECK_EQUAL( cachedOffset( cache ), PathInfo( history ).size() );
+  }
+}
@@ -0,0 +1,135 @@
+#include "TestSetup.h"
+#include "main.h"
+#include "utils/ResultCache.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <utime.h>
+
+static TestSetup test;
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+    // zypper must look for the solv files where the TestSetup builds them
+    test.zypper().configNoConst().rm_options = RepoManagerOptions::makeTestSetup( test.root() );
+    test.zypper().configNoConst().cacheQueryResults = true;
+    ::setenv( "XDG_CACHE_HOME", ( test.root() / "xdg" ).c_str(), 1 );
+    test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+    test.zypper().runtimeData().repos.push_back( sat::Pool::instance().reposFind( "main" ).info() );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+namespace
+{
+  /** Run \a cache_r.record printing \a output_r and leaving \a exitCode_r; return what got printed. */
+  std::string record( ResultCache & cache_r, const std::string & output_r, int exitCode_r = ZYPPER_EXIT_OK,
+                      const std::function<void()> & meanwhile_r = std::function<void()>() )
+  {
+    std::ostringstream str;
+    std::streambuf * orig = std::cout.rdbuf( str.rdbuf() );
+    cache_r.record( [&]() {
+      std::cout << output_r;
+      test.zypper().setExitCode( exitCode_r );
+      if ( meanwhile_r )
+        meanwhile_r();
+    } );
+    std::cout.rdbuf( orig );
+    return str.str();
+  }
+
+  /** A new ResultCache for \a args_r; whether it replayed and what. */
+  bool replay( const std::string & args_r, std::string & output_r )
+  {
+    test.zypper().setExitCode( ZYPPER_EXIT_OK );
+    std::ostringstream str;
+    std::streambuf * orig = std::cout.rdbuf( str.rdbuf() );
+    bool ret = ResultCache( test.zypper(), "list-updates", args_r ).replay();
+    std::cout.rdbuf( orig );
+    output_r = str.str();
+    return ret;
+  }
+
+  bool replay( const std::string & args_r = "" )
+  { std::string output; return replay( args_r, output ); }
+
+  /** Append a line to the locks file below the test root. */
+  void touchLocks()
+  {
+    Pathname locks { Pathname::assertprefix( test.zypper().config().root_dir, ZConfig::instance().locksFile() ) };
+    filesystem::assert_dir( locks.dirname() );
+    std::ofstream( locks.c_str(), std::ios::app ) << "\n";
+  }
+
+  /** Move the solv file mtime back. */
+  void touchSolv()
+  {
+    Pathname solv { test.zypper().config().rm_options.repoSolvCachePath / "main" / "solv" };
+    PathInfo pi( solv );
+    BOOST_REQUIRE( pi.isFile() );
+    struct utimbuf times { pi.atime(), pi.mtime() - 60 };
+    BOOST_REQUIRE( ::utime( solv.c_str(), &times ) == 0 );
+  }
+
+  /** Record \a output_r for empty args. */
+  void recordFresh( const std::string & output_r, int exitCode_r = ZYPPER_EXIT_OK )
+  {
+    ResultCache cache( test.zypper(), "list-updates", "" );
+    BOOST_REQUIRE( cache );
+    BOOST_CHECK_EQUAL( record( cache, output_r, exitCode_r ), output_r );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(record_and_replay)
+{
+  BOOST_CHECK( ! replay() );
+  recordFresh( "some updates\n", ZYPPER_EXIT_INF_UPDATE_NEEDED );
+
+  std::string output;
+  BOOST_CHECK( replay( "", output ) );
+  BOOST_CHECK_EQUAL( output, "some updates\n" );
+  BOOST_CHECK_EQUAL( test.zypper().exitCode(), ZYPPER_EXIT_INF_UPDATE_NEEDED );
+
+  // other arguments, other result
+  BOOST_CHECK( ! replay( "--all" ) );
+}
+
+BOOST_AUTO_TEST_CASE(invalidated_by_locks)
+{
+  recordFresh( "locked\n" );
+  BOOST_REQUIRE( replay() );
+  touchLocks();
+  BOOST_CHECK( ! replay() );
+}
+
+BOOST_AUTO_TEST_CASE(invalidated_by_solv)
+{
+  recordFresh( "solv\n" );
+  BOOST_REQUIRE( replay() );
+  touchSolv();
+  BOOST_CHECK( ! replay() );
+}
+
+BOOST_AUTO_TEST_CASE(input_changed_meanwhile)
+{
+  recordFresh( "old\n" );
+  BOOST_REQUIRE( replay() );
+
+  // the key is recomputed after the run; a change during the run must not be saved
+  {
+    ResultCache cache( test.zypper(), "list-updates", "" );
+    BOOST_REQUIRE( cache );
+    touchSolv();	// outdates the old entry
+    record( cache, "new\n", ZYPPER_EXIT_OK, touchLocks );
+  }
+  BOOST_CHECK( ! replay() );
+}
+
+BOOST_AUTO_TEST_CASE(errors_are_not_cached)
+{
+  touchLocks();	// outdate earlier entries
+  recordFresh( "failed\n", ZYPPER_EXIT_ERR_ZYPP );
+  BOOST_CHECK( ! replay() );
+}
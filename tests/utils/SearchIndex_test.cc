@@ -0,0 +1,146 @@
+#include "TestSetup.h"
+#include "utils/SearchIndex.h"
+
+#include <fstream>
+#include <set>
+#include <unistd.h>
+#include <utime.h>
+
+static TestSetup test;
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+    // zypper must look for the index where the TestSetup builds the solv files
+    test.zypper().configNoConst().rm_options = RepoManagerOptions::makeTestSetup( test.root() );
+    test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+namespace
+{
+  Repository repo()
+  { return sat::Pool::instance().reposFind( "main" ); }
+
+  Pathname solvDir()
+  { return test.zypper().config().rm_options.repoSolvCachePath / repo().info().escaped_alias(); }
+
+  Pathname indexFile()
+  { return solvDir() / "zypper-search.idx"; }
+
+  /** A freshly built index. */
+  void rebuild()
+  {
+    filesystem::unlink( indexFile() );
+    BOOST_REQUIRE( SearchIndex::update( repo() ) );
+    BOOST_REQUIRE( SearchIndex( repo() ) );
+  }
+
+  /** Overwrite \a size_r bytes at \a offset_r in \a file_r with 0xff. */
+  void clobber( const Pathname & file_r, off_t offset_r, size_t size_r )
+  {
+    std::fstream str( file_r.c_str(), std::ios::in | std::ios::out | std::ios::binary );
+    str.seekp( offset_r );
+    str << std::string( size_r, '\xff' );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(candidates_cover_poolquery)
+{
+  rebuild();
+  SearchIndex index( repo() );
+
+  for ( const char * str : { "lib", "zyp", "Fire", "KDE", "xml-", "Library" } )
+  {
+    for ( bool text : { false, true } )
+    {
+      std::set<sat::Solvable> candidates;
+      for ( const sat::Solvable & solv : index.candidates( str, text ) )
+        candidates.insert( solv );
+
+      for ( bool caseSensitive : { true, false } )
+      {
+        PoolQuery q;
+        q.addRepo( "main" );
+        q.setMatchSubstring();
+        q.setCaseSensitive( caseSensitive );
+        q.addString( str );
+        q.addAttribute( sat::SolvAttr::name );
+        if ( text )
+        {
+          q.addAttribute( sat::SolvAttr::summary );
+          q.addAttribute( sat::SolvAttr::description );
+        }
+
+        unsigned matches = 0;
+        for ( const sat::Solvable & solv : q )
+        {
+          ++matches;
+          BOOST_CHECK_MESSAGE( candidates.count( solv ), str << ( text ? " (text)" : "" ) << ( caseSensitive ? "" : " (nocase)" )
+                               << ": missing candidate " << solv );
+          BOOST_CHECK( SearchIndex::matches( solv, str, text, caseSensitive ) );
+        }
+        BOOST_CHECK( matches <= candidates.size() );
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(outdated_by_cookie_or_solv)
+{
+  Pathname cookie { solvDir() / "cookie" };
+  Pathname solv { solvDir() / "solv" };
+
+  rebuild();
+  std::string saved;
+  {
+    std::ifstream in( cookie.c_str() );
+    std::getline( in, saved, '\0' );
+  }
+  {
+    std::ofstream out( cookie.c_str(), std::ios::app );
+    out << "changed\n";
+  }
+  BOOST_CHECK( ! SearchIndex( repo() ) );
+  {
+    std::ofstream out( cookie.c_str() );
+    out << saved;
+  }
+  BOOST_CHECK( SearchIndex( repo() ) );	// cookie content is compared, not its stamp
+
+  PathInfo pi( solv );
+  struct utimbuf times { pi.atime(), pi.mtime() - 60 };
+  BOOST_REQUIRE_EQUAL( ::utime( solv.c_str(), &times ), 0 );
+  BOOST_CHECK( ! SearchIndex( repo() ) );
+  BOOST_CHECK( SearchIndex::update( repo() ) );	// rebuilt
+  BOOST_CHECK( SearchIndex( repo() ) );
+}
+
+BOOST_AUTO_TEST_CASE(truncated_or_corrupt)
+{
+  rebuild();
+  off_t size { off_t(PathInfo( indexFile() ).size()) };
+  BOOST_REQUIRE_EQUAL( ::truncate( indexFile().c_str(), size - 1 ), 0 );	// postings cut
+  BOOST_CHECK( ! SearchIndex( repo() ) );
+
+  rebuild();
+  BOOST_REQUIRE_EQUAL( ::truncate( indexFile().c_str(), 100 ), 0 );	// entries cut
+  BOOST_CHECK( ! SearchIndex( repo() ) );
+
+  rebuild();
+  clobber( indexFile(), 0, 4 );					// magic
+  BOOST_CHECK( ! SearchIndex( repo() ) );
+
+  // Header is 80 bytes, the first Entry's postings offset at 8 within it
+  rebuild();
+  clobber( indexFile(), 80 + 8, 8 );
+  BOOST_CHECK( ! SearchIndex( repo() ) );
+
+  rebuild();
+  {
+    std::ofstream out( indexFile().c_str(), std::ios::app );	// trailing garbage
+    out << "garbage";
+  }
+  BOOST_CHECK( ! SearchIndex( repo() ) );
+}
@@ -0,0 +1,44 @@
+#include "TestSetup.h"
+#include "utils/ServiceRefreshCache.h"
+
+namespace
+{
+  ServiceInfo service( const std::string & alias_r, const std::string & url_r )
+  {
+    ServiceInfo ret( alias_r, Url( url_r ) );
+    ret.setAutorefresh( true );
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ttl_and_definition)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { ServiceRefreshCache::defaultFile( tmp.path() ) };
+  const Date now { Date::now() };
+  const Date::Duration ttl { 30 * Date::minute };
+
+  ServiceInfo scc { service( "scc", "https://scc.example.com/access/services/1" ) };
+  {
+    ServiceRefreshCache cache( file );
+    BOOST_CHECK( ! cache.isFresh( scc, ttl, now ) );
+    cache.refreshed( scc, now );
+    BOOST_CHECK( cache.isFresh( scc, ttl, now ) );
+    cache.save();
+  }
+
+  ServiceRefreshCache cache( file );
+  BOOST_CHECK( cache.isFresh( scc, ttl, Date( now + 10 * Date::minute ) ) );
+  BOOST_CHECK( ! cache.isFresh( scc, ttl, Date( now + ttl ) ) );	// expired
+  BOOST_CHECK( ! cache.isFresh( scc, 0, now ) );			// disabled
+  BOOST_CHECK( ! cache.isFresh( scc, ttl, Date( now - 60 ) ) );		// clock went back
+
+  // a changed definition is refreshed
+  BOOST_CHECK( ! cache.isFresh( service( "scc", "https://scc.example.com/access/services/2" ), ttl, now ) );
+  ServiceInfo toEnable { scc };
+  toEnable.addRepoToEnable( "updates" );
+  BOOST_CHECK( ! cache.isFresh( toEnable, ttl, now ) );
+
+  cache.forget( "scc" );
+  BOOST_CHECK( ! cache.isFresh( scc, ttl, now ) );
+}
@@ -0,0 +1,155 @@
+#include "TestSetup.h"
+#include "utils/SolvableTable.h"
+#include "utils/console.h"
+#include "utils/text.h"
+
+#include <cstdlib>
+#include <sstream>
+
+static TestSetup test;
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+    test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1", "main" );
+
+    RepoInfo repo;
+    repo.setAlias( "upd" );
+    repo.addBaseUrl( Url( "file://" TESTS_SRC_DIR "/data/openSUSE-11.1_updates" ) );
+    repo.setGpgCheck( false );
+    test.loadRepo( repo );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+namespace
+{
+  sat::Solvable find( const std::string & name_r, const std::string & repo_r )
+  {
+    for ( const auto & solv : sat::Pool::instance().reposFind( repo_r ).solvables() )
+    {
+      if ( solv.ident() == name_r && solv.arch() == Arch_x86_64 )
+        return solv;
+    }
+    BOOST_FAIL( name_r + " not found in " + repo_r );
+    return sat::Solvable();
+  }
+
+  /** The column \a cidx_r of all rows. */
+  std::vector<std::string> column( const SolvableTable & table_r, unsigned cidx_r )
+  {
+    std::vector<std::string> ret;
+    for ( SolvableTable::size_type idx = 0; idx < table_r.size(); ++idx )
+      ret.push_back( table_r.row( idx ).columns()[cidx_r] );
+    return ret;
+  }
+
+  /** What a \ref Table filled from \a table_r writes (in the \ref Table::defaultStyle). */
+  std::string tableDump( const SolvableTable & table_r, unsigned abbrevColumn_r = unsigned(-1) )
+  {
+    Table table;
+    table_r.fill( table );
+    if ( abbrevColumn_r != unsigned(-1) )
+      table.allowAbbrev( abbrevColumn_r );
+    std::ostringstream str;
+    str << table;
+    return str.str();
+  }
+
+  const SolvableTable::Columns columns { SolvableTable::Name, SolvableTable::Edition, SolvableTable::Repository };
+  const std::string & repoLabel( const std::string & alias_r )
+  {
+    static std::map<std::string,std::string> labels;
+    std::string & label { labels[alias_r] };
+    if ( label.empty() )
+      label = sat::Pool::instance().reposFind( alias_r ).asUserString();
+    return label;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sort_name_ci)
+{
+  SolvableTable t( columns );
+  t.add( find( "MozillaFirefox", "main" ), "" );
+  t.add( find( "bash", "main" ), "" );
+  t.add( find( "hal", "main" ), "" );
+  t.sort( { SolvableTable::Name } );
+  BOOST_CHECK_EQUAL( str::join( column( t, 0 ), "," ), "bash,hal,MozillaFirefox" );
+}
+
+BOOST_AUTO_TEST_CASE(sort_edition)
+{
+  sat::Solvable older { find( "hal", "main" ) };
+  sat::Solvable newer { find( "hal", "upd" ) };
+  BOOST_REQUIRE( older.edition() < newer.edition() );
+
+  SolvableTable t( columns );
+  t.add( newer, "" );
+  t.add( older, "" );
+  t.sort( { SolvableTable::Name, SolvableTable::Edition } );
+  BOOST_CHECK_EQUAL( str::join( column( t, 1 ), "," ), older.edition().asString() + "," + newer.edition().asString() );
+}
+
+BOOST_AUTO_TEST_CASE(sort_repo)
+{
+  SolvableTable t( columns );
+  t.add( find( "hal", "upd" ), "" );
+  t.add( find( "zypper", "main" ), "" );
+  t.add( find( "bash", "main" ), "" );
+  t.sort( { SolvableTable::Repository, SolvableTable::Name } );
+  BOOST_CHECK_EQUAL( str::join( column( t, 0 ), "," ), "bash,zypper,hal" );
+  BOOST_CHECK_EQUAL( str::join( column( t, 2 ), "," ), repoLabel( "main" ) + "," + repoLabel( "main" ) + "," + repoLabel( "upd" ) );
+}
+
+BOOST_AUTO_TEST_CASE(sort_picklist_tiebreak)
+{
+  // equal keys: ordered by picklist position, rows without one last
+  SolvableTable t( columns );
+  t.add( find( "hal", "main" ), "", 1 );
+  t.add( find( "hal", "main" ), "" );
+  t.add( find( "hal", "upd" ), "", 0 );
+  t.sort( { SolvableTable::Name } );
+  BOOST_CHECK_EQUAL( str::join( column( t, 2 ), "," ), repoLabel( "upd" ) + "," + repoLabel( "main" ) + "," + repoLabel( "main" ) );
+}
+
+BOOST_AUTO_TEST_CASE(dump_like_table)
+{
+  SolvableTable t( { SolvableTable::Status, SolvableTable::Name, SolvableTable::Edition, SolvableTable::Repository } );
+  t.add( find( "bash", "main" ), "i" );
+  t.add( find( "hal", "upd" ), "v" );
+  t.addDetail( "detail" );
+  t.add( find( "MozillaFirefox", "main" ), "" );
+
+  for ( TableLineStyle style : { TableLineStyle::Ascii, TableLineStyle::Light, TableLineStyle::none } )
+  {
+    Table::defaultStyle = style;
+    std::ostringstream str;
+    t.dumpTo( str );
+    BOOST_CHECK_EQUAL( str.str(), tableDump( t ) );
+  }
+
+  std::ostringstream empty;
+  SolvableTable().dumpTo( empty );
+  BOOST_CHECK( empty.str().empty() );
+}
+
+BOOST_AUTO_TEST_CASE(dump_abbreviated)
+{
+  Table::defaultStyle = TableLineStyle::Ascii;
+  SolvableTable t( { SolvableTable::Name, SolvableTable::Summary, SolvableTable::Repository } );
+  t.add( find( "MozillaFirefox", "main" ), "" );
+  t.add( find( "bash", "main" ), "" );
+  t.add( find( "hal", "upd" ), "" );
+
+  std::ostringstream full;
+  t.dumpTo( full );
+  std::string head { full.str().substr( 0, full.str().find( '\n' ) ) };
+
+  ::setenv( "COLUMNS", "40", 1 );
+  BOOST_REQUIRE( get_screen_width() < mbs_width( head ) );
+  std::ostringstream str;
+  t.dumpTo( str, 1 );
+  BOOST_CHECK_EQUAL( str.str(), tableDump( t, 1 ) );
+  BOOST_CHECK( str.str().find( "->" ) != std::string::npos );
+  ::unsetenv( "COLUMNS" );
+}